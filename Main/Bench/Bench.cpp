@@ -0,0 +1,1515 @@
+#include "Bench.h"
+#include "../Game/CombatBatch.h"
+#include "../Game/CombatKernel.h"
+#include "../Game/DungeonGen.h"
+#include "../Game/DungeonGrid.h"
+#include "../Save/Autosave.h"
+#include "../Save/Checkpoint.h"
+#include "../Save/Journal.h"
+#include "../Save/Save.h"
+#include "../UI/Terminal.h"
+#include "../UI/UI.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include <windows.h>
+#include <psapi.h>
+
+// Accumulates results so the optimizer cannot drop the measured work.
+static volatile double benchSink = 0.0;
+
+//--------------------
+// BENCHMARK HELPERS
+//--------------------
+
+static double BenchNow()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Write calls and bytes the process has issued so far, across every handle
+static void BenchWriteCounts(unsigned long long* writes, unsigned long long* bytes)
+{
+    IO_COUNTERS counters;
+    if (!GetProcessIoCounters(GetCurrentProcess(), &counters))
+    {
+        *writes = 0;
+        *bytes = 0;
+        return;
+    }
+    *writes = counters.WriteOperationCount;
+    *bytes = counters.WriteTransferCount;
+}
+
+static size_t BenchResidentBytes()
+{
+    PROCESS_MEMORY_COUNTERS counters;
+    counters.cb = sizeof(counters);
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+    return counters.WorkingSetSize;
+}
+
+// Mid-game state: generated dungeon, a few quests, a full-ish inventory and some unlocks.
+static GameInstance* BenchCreateGame()
+{
+    GameInstance* game = GameInit();
+    if (game == nullptr) return nullptr;
+    GameSetSeed(game, 2024);
+    GameMakeCurrent(game);
+
+    game->player = PlayerCreate();
+    game->dungeon = DungeonInit();
+    game->inventory = InventoryCreate();
+    game->questLog = QuestInit();
+    if (game->player == nullptr || game->dungeon == nullptr || game->inventory == nullptr || game->questLog == nullptr)
+    {
+        GameFree(game);
+        return nullptr;
+    }
+
+    PlayerInitStats(game->player);
+    strcpy_s(game->player->name, sizeof(game->player->name), "Benchmark");
+    game->player->level = 6;
+    for (short i = 0; i < 3; i++)
+    {
+        game->player->unlockedAbilities[i] = game->abilityList[i];
+        game->player->abilityCount++;
+    }
+
+    if (!DungeonGenerateRooms(game->dungeon))
+    {
+        GameFree(game);
+        return nullptr;
+    }
+    for (short i = 0; i < MAX_ROOMS; i += 2)
+    {
+        DungeonMaterializeRoom(game->dungeon, i);
+        DungeonSetExplored(game->dungeon, i);
+    }
+    for (short i = 0; i < 25; i++)
+    {
+        InventoryAddItem(game->inventory, ItemGenerateTreasure(game->player->level));
+    }
+    for (short i = 0; i < 6; i++)
+    {
+        QuestGenerate(game->questLog, game->player->level);
+    }
+    game->stats->totalEnemiesDefeated = 40;
+    game->stats->itemsCollected = 25;
+    return game;
+}
+
+static void BenchFreeLoaded(Player* player, Inventory* inventory, QuestLog* questLog, GameStats* stats, Dungeon* dungeon)
+{
+    free(player);
+    InventoryFree(inventory);
+    free(questLog);
+    free(stats);
+    free(dungeon);
+}
+
+static long BenchFileSize(const char* path)
+{
+    FILE* file;
+    if (fopen_s(&file, path, "rb") != 0 || file == nullptr) return 0;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+    return size;
+}
+
+static void BenchReportLatency(const char* label, unsigned int operations, double seconds)
+{
+    printf("%-28s %10.2f us/op\n", label, operations > 0 ? seconds * 1e6 / operations : 0.0);
+}
+
+static void BenchReportLoad(const char* label, double seconds, size_t residentBefore, size_t residentAfter)
+{
+    double residentMB = residentAfter > residentBefore ? (double)(residentAfter - residentBefore) / (1024.0 * 1024.0) : 0.0;
+    printf("%-36s %10.3f ms %10.2f MB resident\n", label, seconds * 1e3, residentMB);
+}
+
+static void BenchReportRate(const char* label, unsigned int operations, double seconds, const char* unit)
+{
+    double rate = seconds > 0.0 ? operations / seconds : 0.0;
+    printf("%-28s %10.2f M%s/s  (%.2f ns/op)\n", label, rate / 1e6, unit,
+           operations > 0 ? seconds * 1e9 / operations : 0.0);
+}
+
+//--------------------
+// RANDOM
+//--------------------
+
+// The generator RandomFloat/RandomShort used before per-game state.
+static float BenchLegacyRandomFloat(float min, float max)
+{
+    float r = rand() % 10000; // NOLINT
+    r = r / 10000.0f;
+    return min + r * (max - min);
+}
+
+static short BenchLegacyRandomShort(short min, short max)
+{
+    return (short)min + rand() % (max - min + 1); // NOLINT
+}
+
+void BenchRandom(unsigned int iterations)
+{
+    if (iterations == 0) iterations = BENCH_RANDOM_ITERATIONS;
+    UI::UI_PrintHeader("RANDOM BENCHMARK");
+    printf("Draws per test: %u\n\n", iterations);
+
+    GameInstance* game = GameInit();
+    if (game == nullptr) return;
+    GameSetSeed(game, 12345);
+    GameMakeCurrent(game);
+
+    unsigned int blocks = iterations / 1024 > 0 ? iterations / 1024 : 1;
+    double sum = 0.0;
+    double start = BenchNow();
+    for (unsigned int i = 0; i < iterations; i++) sum += BenchLegacyRandomFloat(0.0f, 1.0f);
+    BenchReportRate("rand() float", iterations, BenchNow() - start, "draws");
+
+    start = BenchNow();
+    for (unsigned int i = 0; i < iterations; i++) sum += RandomFloat(0.0f, 1.0f);
+    BenchReportRate("RandomFloat", iterations, BenchNow() - start, "draws");
+
+    float floats[1024];
+    start = BenchNow();
+    for (unsigned int i = 0; i < blocks; i++)
+    {
+        RandomFillFloats(floats, 1024, 0.0f, 1.0f);
+        sum += floats[i & 1023];
+    }
+    BenchReportRate("RandomFillFloats (1024)", blocks * 1024, BenchNow() - start, "draws");
+
+    start = BenchNow();
+    for (unsigned int i = 0; i < iterations; i++) sum += BenchLegacyRandomShort(5, 150);
+    BenchReportRate("rand() short", iterations, BenchNow() - start, "draws");
+
+    start = BenchNow();
+    for (unsigned int i = 0; i < iterations; i++) sum += RandomShort(5, 150);
+    BenchReportRate("RandomShort", iterations, BenchNow() - start, "draws");
+
+    short shorts[1024];
+    start = BenchNow();
+    for (unsigned int i = 0; i < blocks; i++)
+    {
+        RandomFillShorts(shorts, 1024, 5, 150);
+        sum += shorts[i & 1023];
+    }
+    BenchReportRate("RandomFillShorts (1024)", blocks * 1024, BenchNow() - start, "draws");
+
+    benchSink = benchSink + sum;
+    GameFree(game);
+    UI::UI_PrintDivider();
+}
+
+//--------------------
+// SAVE / LOAD
+//--------------------
+
+void BenchSave(unsigned int iterations)
+{
+    if (iterations == 0) iterations = BENCH_SAVE_ITERATIONS;
+    UI::UI_PrintHeader("SAVE BENCHMARK");
+    printf("Round trips per test: %u\n\n", iterations);
+
+    GameInstance* game = BenchCreateGame();
+    if (game == nullptr) return;
+
+    const char* textPath = "bench_save.txt";
+    const char* binaryPath = "bench_save.dat";
+    bool ok = true;
+
+    double start = BenchNow();
+    for (unsigned int i = 0; ok && i < iterations; i++)
+    {
+        ok = FileSaveGameText(textPath, game->player, game->inventory, game->questLog, game->stats, game->dungeon);
+    }
+    BenchReportLatency("Text save", iterations, BenchNow() - start);
+
+    start = BenchNow();
+    for (unsigned int i = 0; ok && i < iterations; i++)
+    {
+        Player* player = nullptr; Inventory* inventory = nullptr; QuestLog* questLog = nullptr;
+        GameStats* stats = nullptr; Dungeon* dungeon = nullptr;
+        ok = FileLoadGameText(textPath, &player, &inventory, &questLog, &stats, &dungeon);
+        BenchFreeLoaded(player, inventory, questLog, stats, dungeon);
+    }
+    BenchReportLatency("Text load", iterations, BenchNow() - start);
+
+    start = BenchNow();
+    for (unsigned int i = 0; ok && i < iterations; i++)
+    {
+        ok = SaveWriteSnapshot(binaryPath, game->player, game->inventory, game->questLog, game->stats, game->dungeon);
+    }
+    BenchReportLatency("Binary save", iterations, BenchNow() - start);
+
+    start = BenchNow();
+    for (unsigned int i = 0; ok && i < iterations; i++)
+    {
+        Player* player = nullptr; Inventory* inventory = nullptr; QuestLog* questLog = nullptr;
+        GameStats* stats = nullptr; Dungeon* dungeon = nullptr;
+        ok = SaveReadSnapshot(binaryPath, &player, &inventory, &questLog, &stats, &dungeon);
+        BenchFreeLoaded(player, inventory, questLog, stats, dungeon);
+    }
+    BenchReportLatency("Binary load", iterations, BenchNow() - start);
+
+    printf("\nText file: %ld bytes (drops effects, abilities, descriptions)\n", BenchFileSize(textPath));
+    printf("Binary file: %ld bytes (complete snapshot)\n", BenchFileSize(binaryPath));
+    if (!ok) UI::UI_DisplayErrorMessage("A save or load failed during the benchmark");
+
+    remove(textPath);
+    remove(binaryPath);
+    GameFree(game);
+    UI::UI_PrintDivider();
+}
+
+//--------------------
+// CHECKPOINTS
+//--------------------
+
+// Writes the same checkpoints twice: as a mapped pack and as length-prefixed binary snapshots.
+static bool BenchWriteCheckpoints(GameInstance* game, unsigned int count, const char* packPath, const char* batchPath)
+{
+    CheckpointPackWriter writer;
+    if (!CheckpointPackCreate(&writer, packPath)) return false;
+
+    FILE* batch;
+    if (fopen_s(&batch, batchPath, "wb") != 0 || batch == nullptr)
+    {
+        CheckpointPackFinish(&writer);
+        return false;
+    }
+
+    SaveBuffer buffer;
+    SaveBufferInit(&buffer);
+    bool ok = true;
+    for (unsigned int i = 0; ok && i < count; i++)
+    {
+        // Vary a little state per checkpoint so records are not identical
+        game->player->gold = (int)i;
+        game->player->currentRoom = (unsigned short)(i % MAX_ROOMS);
+        DungeonMaterializeRoom(game->dungeon, (short)(i % MAX_ROOMS));
+        DungeonSetExplored(game->dungeon, (short)(i % MAX_ROOMS));
+        game->stats->totalPlaytime = (unsigned short)i;
+        RandomNextU32(&game->random);
+
+        buffer.size = 0;
+        ok = CheckpointPackAppend(&writer, game) && SaveEncodeSnapshot(&buffer, game->player, game->inventory, game->questLog, game->stats, game->dungeon);
+        unsigned int size = (unsigned int)buffer.size;
+        ok = ok && fwrite(&size, sizeof(size), 1, batch) == 1 && fwrite(buffer.data, 1, buffer.size, batch) == buffer.size;
+    }
+
+    SaveBufferFree(&buffer);
+    ok = fclose(batch) == 0 && ok;
+    return CheckpointPackFinish(&writer) && ok;
+}
+
+// Existing path: walk the length prefixes to the snapshot, read it into the heap and decode every struct
+static bool BenchCopyResume(const char* batchPath, unsigned int index, GameInstance* game)
+{
+    FILE* file;
+    if (fopen_s(&file, batchPath, "rb") != 0 || file == nullptr) return false;
+
+    unsigned int size = 0;
+    unsigned char* data = nullptr;
+    bool ok = true;
+    for (unsigned int i = 0; ok && i < index; i++)
+    {
+        ok = fread(&size, sizeof(size), 1, file) == 1 && fseek(file, (long)size, SEEK_CUR) == 0;
+    }
+    ok = ok && fread(&size, sizeof(size), 1, file) == 1 && (data = (unsigned char*)malloc(size)) != nullptr && fread(data, 1, size, file) == size;
+    fclose(file);
+
+    Player* player = nullptr; Inventory* inventory = nullptr; QuestLog* questLog = nullptr;
+    GameStats* stats = nullptr; Dungeon* dungeon = nullptr;
+    ok = ok && SaveDecodeSnapshot(data, size, &player, &inventory, &questLog, &stats, &dungeon);
+    free(data);
+    if (!ok) return false;
+
+    BenchFreeLoaded(game->player, game->inventory, game->questLog, game->stats, game->dungeon);
+    game->player = player;
+    game->inventory = inventory;
+    game->questLog = questLog;
+    game->stats = stats;
+    game->dungeon = dungeon;
+    return true;
+}
+
+void BenchCheckpoint(unsigned int count)
+{
+    if (count == 0) count = BENCH_CHECKPOINT_COUNT;
+    UI::UI_PrintHeader("CHECKPOINT BENCHMARK");
+    printf("Checkpoints: %u\n", count);
+
+    const char* packPath = "bench_checkpoints.pack";
+    const char* batchPath = "bench_checkpoints.bin";
+    GameInstance* game = BenchCreateGame();
+    GameInstance* resumed = BenchCreateGame();
+    if (game == nullptr || resumed == nullptr || !BenchWriteCheckpoints(game, count, packPath, batchPath))
+    {
+        UI::UI_DisplayErrorMessage("Failed to write checkpoints");
+        GameFree(game);
+        GameFree(resumed);
+        return;
+    }
+    printf("Record size: %u bytes, pack size: %.1f MB\n\n", (unsigned int)sizeof(CheckpointRecord),
+        (double)BenchFileSize(packPath) / (1024.0 * 1024.0));
+
+    // Time to first turn: open the batch and get a playable game from the last checkpoint
+    size_t residentBefore = BenchResidentBytes();
+    double start = BenchNow();
+    bool ok = BenchCopyResume(batchPath, count - 1, resumed);
+    BenchReportLoad("Copy load, first turn", BenchNow() - start, residentBefore, BenchResidentBytes());
+
+    residentBefore = BenchResidentBytes();
+    start = BenchNow();
+    // Zeroed so the free and close below are safe when an earlier step failed before opening them
+    CheckpointPack pack = {};
+    CheckpointView view = {};
+    ok = ok && CheckpointPackOpen(&pack, packPath) && CheckpointViewInit(&view, &pack, count - 1) && CheckpointResumeGame(&view, resumed);
+    CheckpointViewFree(&view);
+    CheckpointPackClose(&pack);
+    BenchReportLoad("Mapped load, first turn", BenchNow() - start, residentBefore, BenchResidentBytes());
+
+    // All checkpoints through the copy path, kept alive so resident memory can be measured
+    Player** players = (Player**)calloc(count, sizeof(Player*));
+    Inventory** inventories = (Inventory**)calloc(count, sizeof(Inventory*));
+    QuestLog** questLogs = (QuestLog**)calloc(count, sizeof(QuestLog*));
+    GameStats** stats = (GameStats**)calloc(count, sizeof(GameStats*));
+    Dungeon** dungeons = (Dungeon**)calloc(count, sizeof(Dungeon*));
+    ok = ok && players != nullptr && inventories != nullptr && questLogs != nullptr && stats != nullptr && dungeons != nullptr;
+
+    residentBefore = BenchResidentBytes();
+    start = BenchNow();
+    FILE* file;
+    if (ok && fopen_s(&file, batchPath, "rb") == 0 && file != nullptr)
+    {
+        unsigned char* data = nullptr;
+        unsigned int size = 0;
+        for (unsigned int i = 0; ok && i < count; i++)
+        {
+            ok = fread(&size, sizeof(size), 1, file) == 1;
+            unsigned char* grown = ok ? (unsigned char*)realloc(data, size) : nullptr;
+            ok = grown != nullptr && fread(grown, 1, size, file) == size;
+            if (grown != nullptr) data = grown;
+            ok = ok && SaveDecodeSnapshot(data, size, &players[i], &inventories[i], &questLogs[i], &stats[i], &dungeons[i]);
+        }
+        free(data);
+        fclose(file);
+    }
+    BenchReportLoad("Copy load, all checkpoints", BenchNow() - start, residentBefore, BenchResidentBytes());
+
+    for (unsigned int i = 0; i < count && players != nullptr; i++)
+    {
+        BenchFreeLoaded(players[i], inventories[i], questLogs[i], stats[i], dungeons[i]);
+    }
+    free(players);
+    free(inventories);
+    free(questLogs);
+    free(stats);
+    free(dungeons);
+
+    // All checkpoints as mapped views: nothing is read until a view is used
+    CheckpointView* views = (CheckpointView*)calloc(count, sizeof(CheckpointView));
+    residentBefore = BenchResidentBytes();
+    start = BenchNow();
+    ok = ok && views != nullptr && CheckpointPackOpen(&pack, packPath);
+    for (unsigned int i = 0; ok && i < count; i++)
+    {
+        ok = CheckpointViewInit(&views[i], &pack, i);
+    }
+    BenchReportLoad("Mapped load, all checkpoints", BenchNow() - start, residentBefore, BenchResidentBytes());
+
+    // Reading a field faults in one page per record; writing copies just that struct
+    start = BenchNow();
+    long long levelSum = 0;
+    for (unsigned int i = 0; ok && i < count; i++)
+    {
+        levelSum += CheckpointGetPlayer(&views[i])->level;
+    }
+    benchSink = benchSink + (double)levelSum;
+    BenchReportLoad("Mapped, read player level of each", BenchNow() - start, residentBefore, BenchResidentBytes());
+
+    start = BenchNow();
+    for (unsigned int i = 0; ok && i < count; i++)
+    {
+        Player* player = CheckpointEditPlayer(&views[i]);
+        ok = player != nullptr;
+        if (ok) player->gold += 1;
+    }
+    BenchReportLoad("Mapped, edit player gold of each", BenchNow() - start, residentBefore, BenchResidentBytes());
+
+    for (unsigned int i = 0; i < count && views != nullptr; i++)
+    {
+        CheckpointViewFree(&views[i]);
+    }
+    free(views);
+    if (pack.base != nullptr) CheckpointPackClose(&pack);
+    if (!ok) UI::UI_DisplayErrorMessage("A checkpoint failed to load during the benchmark");
+
+    remove(packPath);
+    remove(batchPath);
+    GameFree(game);
+    GameFree(resumed);
+    UI::UI_PrintDivider();
+}
+
+//--------------------
+// JOURNAL
+//--------------------
+
+// One turn's worth of typical changes: gold, a room flag, playtime, and now and then an item or quest step
+static void BenchPlayTurn(GameInstance* game, unsigned int turn)
+{
+    game->player->gold += 3;
+    game->player->currentRoom = (unsigned short)(turn % MAX_ROOMS);
+    DungeonMaterializeRoom(game->dungeon, (short)(turn % MAX_ROOMS));
+    DungeonSetExplored(game->dungeon, (short)(turn % MAX_ROOMS));
+    game->stats->totalPlaytime++;
+
+    if (turn % 10 == 0 && game->questLog->questCount > 0)
+    {
+        Quest* quest = &game->questLog->quests[turn / 10 % game->questLog->questCount];
+        if (!quest->completed) quest->currentProgress++;
+    }
+    if (turn % 25 == 0)
+    {
+        if (InventoryIsFull(game->inventory))
+        {
+            InventoryRemoveItem(game->inventory, game->inventory->items[0].itemID);
+        }
+        InventoryAddItem(game->inventory, ItemGenerateTreasure(game->player->level));
+        game->stats->itemsCollected++;
+    }
+}
+
+static bool BenchSameState(GameInstance* game, Player* player, Inventory* inventory, QuestLog* questLog, GameStats* stats, Dungeon* dungeon)
+{
+    SaveBuffer expected;
+    SaveBuffer actual;
+    SaveBufferInit(&expected);
+    SaveBufferInit(&actual);
+    bool same = SaveEncodeSnapshot(&expected, game->player, game->inventory, game->questLog, game->stats, game->dungeon) &&
+        SaveEncodeSnapshot(&actual, player, inventory, questLog, stats, dungeon) &&
+        expected.size == actual.size && memcmp(expected.data, actual.data, expected.size) == 0;
+    SaveBufferFree(&expected);
+    SaveBufferFree(&actual);
+    return same;
+}
+
+void BenchJournal(unsigned int turns)
+{
+    if (turns == 0) turns = BENCH_JOURNAL_TURNS;
+    UI::UI_PrintHeader("JOURNAL BENCHMARK");
+    printf("Turns saved: %u\n\n", turns);
+
+    const char* snapshotPath = "bench_journal.dat";
+    const char* journalPath = "bench_journal.journal";
+    GameInstance* game = BenchCreateGame();
+    if (game == nullptr) return;
+
+    // Full snapshot rewrite every turn
+    double start = BenchNow();
+    bool ok = true;
+    size_t snapshotBytes = 0;
+    for (unsigned int i = 0; ok && i < turns; i++)
+    {
+        BenchPlayTurn(game, i);
+        ok = SaveWriteSnapshot(snapshotPath, game->player, game->inventory, game->questLog, game->stats, game->dungeon);
+        snapshotBytes += (size_t)BenchFileSize(snapshotPath);
+    }
+    double snapshotSeconds = BenchNow() - start;
+
+    // Delta frames, compacted into a snapshot every SAVE_JOURNAL_COMPACT_BYTES
+    start = BenchNow();
+    SaveJournal* journal = SaveJournalOpen(snapshotPath, journalPath, game->player, game->inventory, game->questLog, game->stats, game->dungeon);
+    ok = ok && journal != nullptr;
+    for (unsigned int i = 0; ok && i < turns; i++)
+    {
+        BenchPlayTurn(game, turns + i);
+        ok = SaveJournalCommit(journal, game->player, game->inventory, game->questLog, game->stats, game->dungeon);
+    }
+    double journalSeconds = BenchNow() - start;
+
+    printf("%-28s %10.2f us/turn %10.1f bytes/turn\n", "Full snapshot per turn", snapshotSeconds * 1e6 / turns, (double)snapshotBytes / turns);
+    if (journal != nullptr)
+    {
+        printf("%-28s %10.2f us/turn %10.1f bytes/turn\n", "Journal delta per turn", journalSeconds * 1e6 / turns, (double)journal->bytesWritten / turns);
+        printf("Compactions: %u, journal now %u bytes in %u frames\n", journal->compactions, (unsigned int)journal->journalBytes, journal->sequence);
+    }
+
+    // Recovery: load the last snapshot and replay the journal on top
+    Player* player = nullptr; Inventory* inventory = nullptr; QuestLog* questLog = nullptr;
+    GameStats* stats = nullptr; Dungeon* dungeon = nullptr;
+    unsigned int checksum = 0;
+    start = BenchNow();
+    ok = ok && SaveReadSnapshot(snapshotPath, &player, &inventory, &questLog, &stats, &dungeon) && SaveReadSnapshotChecksum(snapshotPath, &checksum);
+    int replayed = ok ? SaveJournalReplay(journalPath, checksum, player, inventory, questLog, stats, dungeon) : 0;
+    double replaySeconds = BenchNow() - start;
+    ok = ok && BenchSameState(game, player, inventory, questLog, stats, dungeon);
+    printf("Recovery replayed %d frames in %.3f ms, state %s\n", replayed, replaySeconds * 1e3, ok ? "matches" : "DIFFERS");
+    BenchFreeLoaded(player, inventory, questLog, stats, dungeon);
+
+    if (!ok) UI::UI_DisplayErrorMessage("Journal benchmark failed");
+    SaveJournalClose(journal);
+    remove(snapshotPath);
+    remove(journalPath);
+    GameFree(game);
+    UI::UI_PrintDivider();
+}
+
+//--------------------
+// AUTOSAVE
+//--------------------
+
+static bool BenchHistogramInit(BenchHistogram* histogram, const char* label, unsigned int capacity)
+{
+    memset(histogram, 0, sizeof(BenchHistogram));
+    histogram->label = label;
+    histogram->samples = (double*)malloc(sizeof(double) * capacity);
+    return histogram->samples != nullptr;
+}
+
+static void BenchHistogramAdd(BenchHistogram* histogram, double seconds)
+{
+    double micros = seconds * 1e6;
+    unsigned int bucket = 0;
+    while (bucket + 1 < BENCH_HISTOGRAM_BUCKETS && micros >= (double)(1u << bucket)) bucket++;
+    histogram->buckets[bucket]++;
+    histogram->samples[histogram->sampleCount++] = micros;
+}
+
+static int BenchCompareDoubles(const void* a, const void* b)
+{
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static double BenchHistogramPercentile(BenchHistogram* histogram, double percentile)
+{
+    if (histogram->sampleCount == 0) return 0.0;
+    unsigned int index = (unsigned int)(percentile * (histogram->sampleCount - 1));
+    return histogram->samples[index];
+}
+
+static void BenchHistogramPrint(BenchHistogram* histograms, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        qsort(histograms[i].samples, histograms[i].sampleCount, sizeof(double), BenchCompareDoubles);
+    }
+
+    printf("%-14s", "Turn time");
+    for (int i = 0; i < count; i++) printf("%14s", histograms[i].label);
+    printf("\n");
+
+    for (unsigned int bucket = 0; bucket < BENCH_HISTOGRAM_BUCKETS; bucket++)
+    {
+        bool used = false;
+        for (int i = 0; i < count; i++) used = used || histograms[i].buckets[bucket] > 0;
+        if (!used) continue;
+
+        char range[32];
+        if (bucket == 0) sprintf_s(range, sizeof(range), "< 1 us");
+        else if (bucket + 1 == BENCH_HISTOGRAM_BUCKETS) sprintf_s(range, sizeof(range), ">= %u us", 1u << (bucket - 1));
+        else sprintf_s(range, sizeof(range), "< %u us", 1u << bucket);
+
+        printf("%-14s", range);
+        for (int i = 0; i < count; i++) printf("%14u", histograms[i].buckets[bucket]);
+        printf("\n");
+    }
+
+    const char* rows[] = { "p50 (us)", "p99 (us)", "max (us)" };
+    const double percentiles[] = { 0.5, 0.99, 1.0 };
+    for (int row = 0; row < 3; row++)
+    {
+        printf("%-14s", rows[row]);
+        for (int i = 0; i < count; i++) printf("%14.1f", BenchHistogramPercentile(&histograms[i], percentiles[row]));
+        printf("\n");
+    }
+}
+
+void BenchAutosave(unsigned int turns)
+{
+    if (turns == 0) turns = BENCH_AUTOSAVE_TURNS;
+    UI::UI_PrintHeader("AUTOSAVE BENCHMARK");
+    printf("Turns per mode: %u\n\n", turns);
+
+    const char* snapshotPath = "bench_autosave.dat";
+    const char* journalPath = "bench_autosave.journal";
+    BenchHistogram histograms[3];
+    bool ok = BenchHistogramInit(&histograms[0], "disabled", turns) &&
+        BenchHistogramInit(&histograms[1], "inline", turns) &&
+        BenchHistogramInit(&histograms[2], "background", turns);
+    GameInstance* game = ok ? BenchCreateGame() : nullptr;
+    ok = ok && game != nullptr;
+
+    // No saving at all
+    for (unsigned int i = 0; ok && i < turns; i++)
+    {
+        double start = BenchNow();
+        BenchPlayTurn(game, i);
+        BenchHistogramAdd(&histograms[0], BenchNow() - start);
+    }
+
+    // Synced journal commit on the game thread, as the turn would do without the writer
+    SaveJournal* journal = ok ? SaveJournalOpen(snapshotPath, journalPath, game->player, game->inventory, game->questLog, game->stats, game->dungeon) : nullptr;
+    ok = ok && journal != nullptr;
+    if (ok) journal->durable = true;
+    for (unsigned int i = 0; ok && i < turns; i++)
+    {
+        double start = BenchNow();
+        BenchPlayTurn(game, turns + i);
+        ok = SaveJournalCommit(journal, game->player, game->inventory, game->questLog, game->stats, game->dungeon);
+        BenchHistogramAdd(&histograms[1], BenchNow() - start);
+    }
+    SaveJournalClose(journal);
+
+    // Snapshot on the game thread, write on the autosave thread
+    Autosave* autosave = ok ? AutosaveStart(snapshotPath, journalPath) : nullptr;
+    for (unsigned int i = 0; ok && i < turns; i++)
+    {
+        double start = BenchNow();
+        BenchPlayTurn(game, 2 * turns + i);
+        ok = AutosaveQueue(autosave, game);
+        BenchHistogramAdd(&histograms[2], BenchNow() - start);
+    }
+    AutosaveFlush(autosave);
+
+    // What the writer left on disk must replay to the live state
+    Player* player = nullptr; Inventory* inventory = nullptr; QuestLog* questLog = nullptr;
+    GameStats* stats = nullptr; Dungeon* dungeon = nullptr;
+    unsigned int checksum = 0;
+    ok = ok && SaveReadSnapshot(snapshotPath, &player, &inventory, &questLog, &stats, &dungeon) && SaveReadSnapshotChecksum(snapshotPath, &checksum);
+    if (ok) SaveJournalReplay(journalPath, checksum, player, inventory, questLog, stats, dungeon);
+    ok = ok && BenchSameState(game, player, inventory, questLog, stats, dungeon);
+    BenchFreeLoaded(player, inventory, questLog, stats, dungeon);
+
+    if (ok)
+    {
+        BenchHistogramPrint(histograms, 3);
+        AutosaveStats writer = AutosaveGetStats(autosave);
+        printf("\nBackground writer: %u queued, %u written, %u coalesced, %u failed\n", writer.queued, writer.written, writer.coalesced, writer.failed);
+        printf("Snapshot bytes: %.1f KB copied, %.1f KB shared with the previous snapshot\n",
+            (double)writer.bytesCopied / 1024.0, (double)writer.bytesShared / 1024.0);
+        printf("Saved state replays to the live game: yes\n");
+    }
+    else
+    {
+        UI::UI_DisplayErrorMessage("Autosave benchmark failed");
+    }
+
+    AutosaveStop(autosave);
+    for (BenchHistogram& histogram : histograms) free(histogram.samples);
+    remove(snapshotPath);
+    remove(journalPath);
+    GameFree(game);
+    UI::UI_PrintDivider();
+}
+
+//--------------------
+// INVENTORY
+//--------------------
+
+// The linked-list inventories this replaced: either one malloc per distinct item, or nodes taken
+// from a pool owned by the inventory. Lookups walk the list either way.
+typedef struct BenchListNode
+{
+    ItemData item;
+    struct BenchListNode* next;
+}BenchListNode;
+
+typedef struct BenchListInventory
+{
+    BenchListNode* head;
+    short itemCount;
+    bool pooled;
+    BenchListNode* freeList;
+    BenchListNode pool[MAX_INVENTORY];
+}BenchListInventory;
+
+static unsigned long long benchHeapCalls = 0;
+
+static BenchListInventory* BenchListCreate(bool pooled)
+{
+    benchHeapCalls++;
+    BenchListInventory* inventory = (BenchListInventory*)malloc(sizeof(BenchListInventory));
+    if (inventory == nullptr) return nullptr;
+    inventory->head = nullptr;
+    inventory->itemCount = 0;
+    inventory->pooled = pooled;
+    inventory->freeList = nullptr;
+    for (short i = MAX_INVENTORY - 1; pooled && i >= 0; i--)
+    {
+        inventory->pool[i].next = inventory->freeList;
+        inventory->freeList = &inventory->pool[i];
+    }
+    return inventory;
+}
+
+static bool BenchListAdd(BenchListInventory* inventory, ItemData item)
+{
+    if (inventory->itemCount >= MAX_INVENTORY) return false;
+    for (BenchListNode* current = inventory->head; current != nullptr; current = current->next)
+    {
+        if (current->item.itemID == item.itemID)
+        {
+            current->item.quantity += item.quantity;
+            return true;
+        }
+    }
+
+    BenchListNode* node;
+    if (inventory->pooled)
+    {
+        node = inventory->freeList;
+        if (node != nullptr) inventory->freeList = node->next;
+    }
+    else
+    {
+        benchHeapCalls++;
+        node = (BenchListNode*)malloc(sizeof(BenchListNode));
+    }
+    if (node == nullptr) return false;
+    node->item = item;
+    node->next = inventory->head;
+    inventory->head = node;
+    inventory->itemCount++;
+    return true;
+}
+
+static ItemData* BenchListFind(BenchListInventory* inventory, short itemID)
+{
+    for (BenchListNode* current = inventory->head; current != nullptr; current = current->next)
+    {
+        if (current->item.itemID == itemID) return &current->item;
+    }
+    return nullptr;
+}
+
+static bool BenchListRemove(BenchListInventory* inventory, short itemID)
+{
+    BenchListNode* prev = nullptr;
+    for (BenchListNode* current = inventory->head; current != nullptr; prev = current, current = current->next)
+    {
+        if (current->item.itemID != itemID) continue;
+        if (--current->item.quantity <= 0)
+        {
+            if (prev == nullptr) inventory->head = current->next;
+            else prev->next = current->next;
+            if (inventory->pooled)
+            {
+                current->next = inventory->freeList;
+                inventory->freeList = current;
+            }
+            else
+            {
+                benchHeapCalls++;
+                free(current);
+            }
+            inventory->itemCount--;
+        }
+        return true;
+    }
+    return false;
+}
+
+static void BenchListFree(BenchListInventory* inventory)
+{
+    BenchListNode* current = inventory->pooled ? nullptr : inventory->head;
+    while (current != nullptr)
+    {
+        BenchListNode* next = current->next;
+        benchHeapCalls++;
+        free(current);
+        current = next;
+    }
+    benchHeapCalls++;
+    free(inventory);
+}
+
+static ItemData BenchMakeItem(short itemID)
+{
+    ItemData item;
+    memset(&item, 0, sizeof(item));
+    item.itemID = itemID;
+    char name[MAX_NAME_LENGTH];
+    sprintf_s(name, sizeof(name), "Bench Item %d", itemID);
+    item.name = StringPoolIntern(name);
+    item.type = POTION;
+    item.rarity = COMMON;
+    item.value = 10;
+    item.cost = 25;
+    item.quantity = 1;
+    return item;
+}
+
+// Fill, then churn like shop buy/sell and loot: look one item up, sell the oldest, pick up a new one
+static double BenchInventoryListRounds(const ItemData* items, unsigned int rounds, bool pooled)
+{
+    long long checksum = 0;
+    double start = BenchNow();
+    for (unsigned int round = 0; round < rounds; round++)
+    {
+        BenchListInventory* inventory = BenchListCreate(pooled);
+        if (inventory == nullptr) break;
+        for (short i = 0; i < BENCH_INVENTORY_FILL; i++) BenchListAdd(inventory, items[i]);
+        for (short i = 0; i < BENCH_INVENTORY_CHURN; i++)
+        {
+            ItemData* found = BenchListFind(inventory, items[i + BENCH_INVENTORY_FILL / 2].itemID);
+            if (found != nullptr) checksum += found->value;
+            BenchListRemove(inventory, items[i].itemID);
+            BenchListAdd(inventory, items[i + BENCH_INVENTORY_FILL]);
+        }
+        BenchListFree(inventory);
+    }
+    benchSink = benchSink + (double)checksum;
+    return BenchNow() - start;
+}
+
+static double BenchInventoryRounds(const ItemData* items, unsigned int rounds)
+{
+    long long checksum = 0;
+    double start = BenchNow();
+    for (unsigned int round = 0; round < rounds; round++)
+    {
+        benchHeapCalls++;
+        Inventory* inventory = InventoryCreate();
+        if (inventory == nullptr) break;
+        for (short i = 0; i < BENCH_INVENTORY_FILL; i++) InventoryAddItem(inventory, items[i]);
+        for (short i = 0; i < BENCH_INVENTORY_CHURN; i++)
+        {
+            ItemData* found = InventoryFindItem(inventory, items[i + BENCH_INVENTORY_FILL / 2].itemID);
+            if (found != nullptr) checksum += found->value;
+            InventoryRemoveItem(inventory, items[i].itemID);
+            InventoryAddItem(inventory, items[i + BENCH_INVENTORY_FILL]);
+        }
+        benchHeapCalls++;
+        InventoryFree(inventory);
+    }
+    benchSink = benchSink + (double)checksum;
+    return BenchNow() - start;
+}
+
+void BenchInventory(unsigned int rounds)
+{
+    if (rounds == 0) rounds = BENCH_INVENTORY_ROUNDS;
+    UI::UI_PrintHeader("INVENTORY BENCHMARK");
+
+    ItemData items[BENCH_INVENTORY_FILL + BENCH_INVENTORY_CHURN];
+    for (short i = 0; i < BENCH_INVENTORY_FILL + BENCH_INVENTORY_CHURN; i++)
+    {
+        items[i] = BenchMakeItem((short)(1000 + i));
+    }
+
+    unsigned int opsPerRound = BENCH_INVENTORY_FILL + BENCH_INVENTORY_CHURN * 3;
+    double operations = (double)rounds * opsPerRound;
+    printf("Rounds: %u (fill %d items, then %d find/remove/add steps)\n\n", rounds, BENCH_INVENTORY_FILL, BENCH_INVENTORY_CHURN);
+    printf("%-24s %12s %16s\n", "", "ns/op", "heap calls/op");
+
+    benchHeapCalls = 0;
+    double seconds = BenchInventoryListRounds(items, rounds, false);
+    printf("%-24s %12.2f %16.3f\n", "list, malloc per node", seconds * 1e9 / operations, (double)benchHeapCalls / operations);
+
+    benchHeapCalls = 0;
+    seconds = BenchInventoryListRounds(items, rounds, true);
+    printf("%-24s %12.2f %16.3f\n", "list, pooled nodes", seconds * 1e9 / operations, (double)benchHeapCalls / operations);
+
+    benchHeapCalls = 0;
+    seconds = BenchInventoryRounds(items, rounds);
+    printf("%-24s %12.2f %16.3f\n", "dense array + index", seconds * 1e9 / operations, (double)benchHeapCalls / operations);
+    UI::UI_PrintDivider();
+}
+
+//--------------------
+// DUNGEON GRID
+//--------------------
+
+// Order-sensitive hash of every resident room, to check that thread count does not change the map
+static unsigned long long BenchDungeonChecksum(const DungeonGrid* grid)
+{
+    unsigned long long hash = 14695981039346656037ull;
+    int chunkCount = grid->chunkRows * grid->chunkCols;
+    for (int i = 0; i < chunkCount; i++)
+    {
+        const unsigned char* bytes = (const unsigned char*)grid->chunks[i];
+        if (bytes == nullptr) continue;
+        for (size_t b = 0; b < sizeof(DungeonChunk); b++)
+        {
+            hash = (hash ^ bytes[b]) * 1099511628211ull;
+        }
+    }
+    return hash;
+}
+
+static double BenchDungeonGenerate(int rows, int cols, unsigned int threads, unsigned long long* checksum, size_t* bytes)
+{
+    DungeonGrid* grid = DungeonGridCreate(rows, cols, 2024);
+    if (grid == nullptr) return 0.0;
+    double start = BenchNow();
+    DungeonGridGenerate(grid, threads);
+    double seconds = BenchNow() - start;
+    *checksum = BenchDungeonChecksum(grid);
+    *bytes = DungeonGridMemory(grid);
+    DungeonGridFree(grid);
+    return seconds;
+}
+
+// Random walk from the start room, touching only the rooms the walker steps into
+static void BenchDungeonWalk(int rows, int cols, unsigned int steps)
+{
+    DungeonGrid* grid = DungeonGridCreate(rows, cols, 2024);
+    if (grid == nullptr) return;
+    RandomState random;
+    RandomSeed(&random, 7);
+    int room = 0;
+    double start = BenchNow();
+    DungeonGridExplore(grid, room);
+    for (unsigned int i = 0; i < steps; i++)
+    {
+        int next = DungeonGridNeighbour(grid, room, (Direction)(RandomNextU32(&random) & 3));
+        if (next == -1) continue;
+        room = next;
+        DungeonGridExplore(grid, room);
+    }
+    double seconds = BenchNow() - start;
+    printf("%-12d %-22s %10.2f %12s %10.2f   %lld rooms explored, %d/%d chunks\n", rows * cols, "walk, on demand",
+           seconds * 1e3, "-", (double)DungeonGridMemory(grid) / (1024.0 * 1024.0), DungeonGridCountExplored(grid),
+           grid->residentChunks, grid->chunkRows * grid->chunkCols);
+    DungeonGridFree(grid);
+}
+
+void BenchDungeon(unsigned int maxRooms)
+{
+    if (maxRooms == 0) maxRooms = BENCH_DUNGEON_MAX_ROOMS;
+    UI::UI_PrintHeader("DUNGEON GRID BENCHMARK");
+
+    unsigned int threads = std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+    printf("Chunks of %dx%d rooms, %u hardware threads, walk of %d steps\n\n", DUNGEON_CHUNK_SIZE, DUNGEON_CHUNK_SIZE, threads, BENCH_DUNGEON_WALK_STEPS);
+    printf("%-12s %-22s %10s %12s %10s\n", "rooms", "", "ms", "Mrooms/s", "MB");
+
+    for (unsigned int rooms = 100000; rooms <= maxRooms; rooms *= 10)
+    {
+        int cols = 1;
+        while ((unsigned int)cols * cols < rooms) cols++;
+        int rows = (int)((rooms + cols - 1) / cols);
+
+        unsigned long long serialChecksum = 0, parallelChecksum = 0;
+        size_t bytes = 0;
+        double serial = BenchDungeonGenerate(rows, cols, 1, &serialChecksum, &bytes);
+        printf("%-12d %-22s %10.2f %12.2f %10.2f\n", rows * cols, "generate, 1 thread", serial * 1e3,
+               serial > 0.0 ? rows * (double)cols / serial / 1e6 : 0.0, (double)bytes / (1024.0 * 1024.0));
+
+        char label[32];
+        sprintf_s(label, sizeof(label), "generate, %u threads", threads);
+        double parallel = BenchDungeonGenerate(rows, cols, threads, &parallelChecksum, &bytes);
+        printf("%-12d %-22s %10.2f %12.2f %10.2f   %s\n", rows * cols, label, parallel * 1e3,
+               parallel > 0.0 ? rows * (double)cols / parallel / 1e6 : 0.0, (double)bytes / (1024.0 * 1024.0),
+               serialChecksum == parallelChecksum ? "same map" : "MISMATCH");
+        benchSink += (double)(serialChecksum & 0xFF);
+
+        BenchDungeonWalk(rows, cols, BENCH_DUNGEON_WALK_STEPS);
+    }
+    UI::UI_PrintDivider();
+}
+
+//--------------------
+// DUNGEON GENERATOR
+//--------------------
+
+// Dungeon for every seed in [first, end), one scratch Dungeon reused throughout
+static void BenchGenerateRange(unsigned int first, unsigned int end, const DungeonGenParams* params,
+                               unsigned long long* hashes, DungeonGenMetrics* metrics)
+{
+    Dungeon* dungeon = DungeonInit();
+    if (dungeon == nullptr) return;
+    for (unsigned int seed = first; seed < end; seed++)
+    {
+        if (!DungeonGenerate(dungeon, seed, params)) continue;
+        unsigned long long hash = 14695981039346656037ull;
+        const unsigned char* bytes = (const unsigned char*)dungeon->rooms;
+        for (size_t b = 0; b < sizeof(dungeon->rooms); b++)
+        {
+            hash = (hash ^ bytes[b]) * 1099511628211ull;
+        }
+        for (short i = 0; i < dungeon->totalRooms; i++)
+        {
+            hash = (hash ^ DungeonTopologyGetExits(&dungeon->topology, i)) * 1099511628211ull;
+        }
+        hashes[seed] = hash;
+        DungeonGenMeasure(dungeon, &metrics[seed]);
+    }
+    free(dungeon);
+}
+
+static double BenchGenerateBatch(unsigned int count, unsigned int threads, const DungeonGenParams* params,
+                                 unsigned long long* hashes, DungeonGenMetrics* metrics, unsigned long long* checksum)
+{
+    std::vector<std::thread> workers;
+    double start = BenchNow();
+    for (unsigned int t = 0; t < threads; t++)
+    {
+        unsigned int first = (unsigned int)((unsigned long long)count * t / threads);
+        unsigned int end = (unsigned int)((unsigned long long)count * (t + 1) / threads);
+        workers.emplace_back(BenchGenerateRange, first, end, params, hashes, metrics);
+    }
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+    double seconds = BenchNow() - start;
+
+    *checksum = 0;
+    for (unsigned int i = 0; i < count; i++)
+    {
+        *checksum = *checksum * 31 + hashes[i];
+    }
+    return seconds;
+}
+
+void BenchGenerate(unsigned int count)
+{
+    if (count == 0) count = BENCH_GENERATE_DUNGEONS;
+    UI::UI_PrintHeader("DUNGEON GENERATOR BENCHMARK");
+
+    unsigned int threads = std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+    DungeonGenParams params;
+    DungeonGenDefaultParams(&params);
+    printf("%u candidate %dx%d dungeons (fill %d%%, loops %d%%), seeds 0-%u, %u hardware threads\n\n", count,
+           params.rows, params.cols, params.fillPercent, params.loopPercent, count - 1, threads);
+
+    unsigned long long* hashes = (unsigned long long*)calloc(count, sizeof(unsigned long long));
+    DungeonGenMetrics* metrics = (DungeonGenMetrics*)calloc(count, sizeof(DungeonGenMetrics));
+    if (hashes == nullptr || metrics == nullptr)
+    {
+        printf("ERROR - Failed to allocate memory for the generator benchmark.\n");
+        free(hashes);
+        free(metrics);
+        return;
+    }
+
+    unsigned long long serialChecksum = 0, parallelChecksum = 0;
+    double serial = BenchGenerateBatch(count, 1, &params, hashes, metrics, &serialChecksum);
+    double parallel = BenchGenerateBatch(count, threads, &params, hashes, metrics, &parallelChecksum);
+
+    unsigned long long rooms = 0, deadEnds = 0, loops = 0, bossDistance = 0;
+    unsigned int kept = 0, firstKept = count;
+    for (unsigned int i = 0; i < count; i++)
+    {
+        rooms += (unsigned long long)metrics[i].rooms;
+        deadEnds += (unsigned long long)metrics[i].deadEnds;
+        loops += (unsigned long long)metrics[i].loops;
+        bossDistance += (unsigned long long)metrics[i].bossDistance;
+        if (metrics[i].bossDistance >= BENCH_GENERATE_MIN_BOSS_DISTANCE && metrics[i].deadEnds <= BENCH_GENERATE_MAX_DEAD_ENDS)
+        {
+            if (kept == 0) firstKept = i;
+            kept++;
+        }
+    }
+
+    printf("%-22s %10s %14s %12s\n", "", "ms", "dungeons/s", "Mrooms/s");
+    printf("%-22s %10.2f %14.0f %12.2f\n", "generate, 1 thread", serial * 1e3,
+           serial > 0.0 ? count / serial : 0.0, serial > 0.0 ? (double)rooms / serial / 1e6 : 0.0);
+    char label[32];
+    sprintf_s(label, sizeof(label), "generate, %u threads", threads);
+    printf("%-22s %10.2f %14.0f %12.2f   %s\n", label, parallel * 1e3,
+           parallel > 0.0 ? count / parallel : 0.0, parallel > 0.0 ? (double)rooms / parallel / 1e6 : 0.0,
+           serialChecksum == parallelChecksum ? "same dungeons" : "MISMATCH");
+
+    printf("\nAverage: %.1f rooms, %.2f dead ends, %.2f loops, boss %.2f moves from the start\n",
+           (double)rooms / count, (double)deadEnds / count, (double)loops / count, (double)bossDistance / count);
+    printf("Boss at least %d moves away with at most %d dead ends: %u of %u", BENCH_GENERATE_MIN_BOSS_DISTANCE,
+           BENCH_GENERATE_MAX_DEAD_ENDS, kept, count);
+    if (kept > 0)
+    {
+        printf(" (first is seed %u)", firstKept);
+    }
+    printf("\n");
+    benchSink += (double)(serialChecksum & 0xFF);
+
+    free(hashes);
+    free(metrics);
+    UI::UI_PrintDivider();
+}
+
+//--------------------
+// COMBAT KERNEL
+//--------------------
+
+// BenchCreateGame only sets the level; give the player the stats PlayerLevelup would have
+static GameInstance* BenchCreateCombatGame()
+{
+    GameInstance* game = BenchCreateGame();
+    if (game == nullptr) return nullptr;
+    Player* player = game->player;
+    unsigned short levelsGained = (unsigned short)(player->level - 1);
+    player->maxHealth = (unsigned short)(player->maxHealth + levelsGained * HP_LEVEL_GAIN);
+    player->health = player->maxHealth;
+    player->attack = (unsigned short)(player->attack + levelsGained * ATTACK_LEVEL_GAIN);
+    player->defense = (unsigned short)(player->defense + levelsGained * DEFENCE_LEVEL_GAIN);
+    return game;
+}
+
+static void BenchCombatPolicy(const char* label, CombatPolicy policy, const CombatState* states, unsigned int fights)
+{
+    RandomState random;
+    RandomSeed(&random, 2024);
+    unsigned int wins = 0, escapes = 0;
+    unsigned long long turns = 0, dealt = 0, taken = 0;
+    double start = BenchNow();
+    for (unsigned int i = 0; i < fights; i++)
+    {
+        CombatState state = states[i % BENCH_COMBAT_ENEMIES];
+        CombatOutcome outcome;
+        CombatResolve(&state, policy, nullptr, &random, &outcome);
+        wins += outcome.result == COMBAT_VICTORY ? 1u : 0u;
+        escapes += outcome.result == COMBAT_ESCAPE ? 1u : 0u;
+        turns += outcome.turns;
+        dealt += outcome.damageDealt;
+        taken += outcome.damageTaken;
+    }
+    double seconds = BenchNow() - start;
+
+    BenchReportRate(label, fights, seconds, "fights");
+    printf("%-28s %9.1f%% won, %.2f turns, %.1f dealt, %.1f taken per fight\n", "", wins * 100.0 / fights,
+           (double)turns / fights, (double)dealt / fights, (double)taken / fights);
+    benchSink += (double)(turns + escapes);
+}
+
+void BenchCombat(unsigned int fights)
+{
+    if (fights == 0) fights = BENCH_COMBAT_FIGHTS;
+    UI::UI_PrintHeader("COMBAT KERNEL BENCHMARK");
+
+    GameInstance* game = BenchCreateCombatGame();
+    if (game == nullptr)
+    {
+        printf("ERROR - Failed to create the benchmark game.\n");
+        return;
+    }
+    Player* player = game->player;
+    CombatState states[BENCH_COMBAT_ENEMIES];
+    for (short i = 0; i < BENCH_COMBAT_ENEMIES; i++)
+    {
+        Enemy* enemy = EnemyGenerateForLevel(game, player->level);
+        if (enemy == nullptr)
+        {
+            GameFree(game);
+            return;
+        }
+        CombatStateInit(&states[i], player, enemy, game->inventory);
+        free(enemy);
+    }
+    printf("%u fights of a level %hu player against %d enemies rolled for that level, no I/O\n\n", fights,
+           player->level, BENCH_COMBAT_ENEMIES);
+
+    BenchCombatPolicy("attack only", CombatPolicyAttack, states, fights);
+    BenchCombatPolicy("greedy (abilities, potions)", CombatPolicyGreedy, states, fights);
+
+    GameFree(game);
+    UI::UI_PrintDivider();
+}
+
+//--------------------
+// COMBAT BATCH
+//--------------------
+
+static unsigned long long BenchBatchChecksum(const CombatBatch* batch)
+{
+    unsigned long long hash = 14695981039346656037ull;
+    for (unsigned int i = 0; i < batch->count; i++)
+    {
+        unsigned long long fight = (unsigned long long)batch->damageDealt[i] | (unsigned long long)batch->damageTaken[i] << 16 |
+                                   (unsigned long long)batch->turnsToKill[i] << 32 | (unsigned long long)batch->turnsToDie[i] << 48;
+        hash = (hash ^ fight ^ batch->playerWins[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+void BenchCombatBatch(unsigned int fights)
+{
+    if (fights == 0) fights = BENCH_BATCH_FIGHTS;
+    UI::UI_PrintHeader("COMBAT BATCH BENCHMARK");
+
+    GameInstance* game = BenchCreateCombatGame();
+    CombatBatch* batch = CombatBatchCreate(BENCH_BATCH_ENEMIES);
+    if (game == nullptr || batch == nullptr)
+    {
+        printf("ERROR - Failed to set up the batch benchmark.\n");
+        GameFree(game);
+        CombatBatchFree(batch);
+        return;
+    }
+    Player* player = game->player;
+    for (short i = 0; i < BENCH_BATCH_ENEMIES; i++)
+    {
+        Enemy* enemy = EnemyGenerateForLevel(game, (unsigned short)(player->level - 2 + i % 6));
+        if (enemy == nullptr) break;
+        CombatBatchAdd(batch, player, enemy, COMBAT_BATCH_PLAYER_MULTIPLIER, COMBAT_BATCH_ENEMY_MULTIPLIER);
+        free(enemy);
+    }
+    unsigned int rounds = fights / batch->count > 0 ? fights / batch->count : 1;
+    CombatBatchPath best = CombatBatchBestPath();
+    printf("One level %hu build against %u enemies scaled for levels %hu-%hu, %u rounds per path, best path %s\n\n",
+           player->level, batch->count, (unsigned short)(player->level - 2), (unsigned short)(player->level + 3), rounds,
+           CombatBatchPathName(best));
+
+    unsigned long long scalarChecksum = 0;
+    double scalarSeconds = 0.0;
+    for (int path = COMBAT_BATCH_SCALAR; path <= best; path++)
+    {
+        double start = BenchNow();
+        for (unsigned int r = 0; r < rounds; r++)
+        {
+            CombatBatchEvaluate(batch, (CombatBatchPath)path);
+        }
+        double seconds = BenchNow() - start;
+        unsigned long long checksum = BenchBatchChecksum(batch);
+        if (path == COMBAT_BATCH_SCALAR)
+        {
+            scalarChecksum = checksum;
+            scalarSeconds = seconds;
+        }
+
+        char label[32];
+        sprintf_s(label, sizeof(label), "%s", CombatBatchPathName((CombatBatchPath)path));
+        BenchReportRate(label, rounds * batch->count, seconds, "fights");
+        if (path != COMBAT_BATCH_SCALAR)
+        {
+            printf("%-28s %10.2fx scalar, %s\n", "", seconds > 0.0 ? scalarSeconds / seconds : 0.0,
+                   checksum == scalarChecksum ? "same results" : "MISMATCH");
+        }
+        benchSink += (double)(checksum & 0xFF);
+    }
+
+    unsigned int wins = 0;
+    unsigned long long turnsToKill = 0, turnsToDie = 0;
+    for (unsigned int i = 0; i < batch->count; i++)
+    {
+        wins += batch->playerWins[i];
+        turnsToKill += batch->turnsToKill[i];
+        turnsToDie += batch->turnsToDie[i];
+    }
+    printf("\nAt average crits: player wins %.1f%%, %.2f hits to kill, %.2f hits to die\n", wins * 100.0 / batch->count,
+           (double)turnsToKill / batch->count, (double)turnsToDie / batch->count);
+
+    CombatBatchFree(batch);
+    GameFree(game);
+    UI::UI_PrintDivider();
+}
+
+//--------------------
+// RENDER
+//--------------------
+
+typedef enum
+{
+    BENCH_RENDER_UNBUFFERED = 0, // A write per stdio call, as the console stream was
+    BENCH_RENDER_FRAMED = 1, // Frame buffer, every screen drawn in full
+    BENCH_RENDER_RETAINED = 2, // Frame buffer, retained screens only rewrite what changed
+
+}BenchRenderMode;
+
+typedef void (*BenchScreen)(GameInstance* game, Enemy* enemy, unsigned int frame);
+
+// A frame is a combat turn: both sides lose some health, nothing else changes
+static void BenchCombatScreen(GameInstance* game, Enemy* enemy, unsigned int frame)
+{
+    Player* player = game->player;
+    unsigned int turn = frame % 8;
+    player->health = (unsigned short)(player->maxHealth - turn * player->maxHealth / 10);
+    enemy->health = (short)(enemy->baseHealth - turn * enemy->baseHealth / 8);
+    CombatDisplayScreen(player, enemy);
+}
+
+static void BenchMapScreen(GameInstance* game, Enemy* enemy, unsigned int frame)
+{
+    (void)enemy;
+    (void)frame;
+    CLEAR_SCREEN();
+    DungeonDisplayMap(game->player, game->dungeon);
+}
+
+// Draws a screen into the null device in the given mode. The null device has no height to ask
+// for, so retained screens are told the terminal has BENCH_RENDER_TERMINAL_ROWS.
+static void BenchRenderScreen(const char* label, BenchScreen screen, GameInstance* game, Enemy* enemy, unsigned int frames,
+                              BenchRenderMode mode)
+{
+    if (!UI::UI_RedirectOutputToNull())
+    {
+        printf("ERROR - Failed to redirect output for %s.\n", label);
+        return;
+    }
+    if (mode == BENCH_RENDER_UNBUFFERED)
+    {
+        setvbuf(stdout, nullptr, _IONBF, 0);
+    }
+    else
+    {
+        UI::UI_EnableFrameBuffer();
+    }
+    UI::UI_ScreenSetTerminalRows(BENCH_RENDER_TERMINAL_ROWS);
+
+    unsigned long long writesBefore, bytesBefore, writesAfter, bytesAfter;
+    BenchWriteCounts(&writesBefore, &bytesBefore);
+    double start = BenchNow();
+    for (unsigned int i = 0; i < frames; i++)
+    {
+        if (mode != BENCH_RENDER_RETAINED) UI::UI_ScreenEnd();
+        screen(game, enemy, i);
+        UI::UI_PresentFrame();
+    }
+    double seconds = BenchNow() - start;
+    BenchWriteCounts(&writesAfter, &bytesAfter);
+    UI::UI_ScreenEnd();
+    UI::UI_ScreenSetTerminalRows(0);
+    UI::UI_RestoreOutput();
+
+    printf("%-28s %10.0f frames/s  %8.1f writes/frame  %6.0f bytes/frame\n", label, seconds > 0.0 ? frames / seconds : 0.0,
+           (double)(writesAfter - writesBefore) / frames, (double)(bytesAfter - bytesBefore) / frames);
+}
+
+// A screen transition the way CLEAR_SCREEN used to make one, a shell running BENCH_SHELL_CLEAR,
+// against TerminalClear. Both are presented into the null device.
+static void BenchRenderClears(unsigned int frames)
+{
+    if (!UI::UI_RedirectOutputToNull())
+    {
+        printf("ERROR - Failed to redirect output for the clears.\n");
+        return;
+    }
+    UI::UI_EnableFrameBuffer();
+
+    double start = BenchNow();
+    for (unsigned int i = 0; i < BENCH_RENDER_SHELL_CLEARS; i++)
+    {
+        UI::UI_PresentFrame();
+        benchSink += system(BENCH_SHELL_CLEAR);
+    }
+    double shellSeconds = BenchNow() - start;
+
+    start = BenchNow();
+    for (unsigned int i = 0; i < frames; i++)
+    {
+        TerminalClear();
+        UI::UI_PresentFrame();
+    }
+    double seconds = BenchNow() - start;
+    UI::UI_RestoreOutput();
+
+    printf("%-28s %10.1f us/clear\n", "clear, shell", shellSeconds * 1e6 / BENCH_RENDER_SHELL_CLEARS);
+    printf("%-28s %10.1f us/clear\n", "clear, in-process", seconds * 1e6 / frames);
+}
+
+void BenchRender(unsigned int frames)
+{
+    if (frames == 0) frames = BENCH_RENDER_FRAMES;
+    UI::UI_PrintHeader("RENDER BENCHMARK");
+
+    GameInstance* game = BenchCreateGame();
+    Enemy* enemy = game != nullptr ? EnemyGenerateForLevel(game, game->player->level) : nullptr;
+    if (enemy == nullptr)
+    {
+        printf("ERROR - Failed to set up the render benchmark.\n");
+        GameFree(game);
+        return;
+    }
+    printf("%u frames per screen into the null device; a combat frame is one turn\n\n", frames);
+
+    BenchRenderScreen("combat, full redraw", BenchCombatScreen, game, enemy, frames, BENCH_RENDER_FRAMED);
+    BenchRenderScreen("combat, retained", BenchCombatScreen, game, enemy, frames, BENCH_RENDER_RETAINED);
+    BenchRenderScreen("map, unbuffered", BenchMapScreen, game, enemy, frames, BENCH_RENDER_UNBUFFERED);
+    BenchRenderScreen("map, frame buffer", BenchMapScreen, game, enemy, frames, BENCH_RENDER_FRAMED);
+    BenchRenderClears(frames);
+
+    free(enemy);
+    GameFree(game);
+    UI::UI_PrintDivider();
+}
+
+//--------------------
+// DISPATCH
+//--------------------
+
+bool BenchRun(const char* name, unsigned int iterations)
+{
+    if (name == nullptr) return false;
+
+    if (strcmp(name, "random") == 0)
+    {
+        BenchRandom(iterations);
+        return true;
+    }
+    if (strcmp(name, "save") == 0)
+    {
+        BenchSave(iterations);
+        return true;
+    }
+
+    if (strcmp(name, "checkpoint") == 0)
+    {
+        BenchCheckpoint(iterations);
+        return true;
+    }
+
+    if (strcmp(name, "journal") == 0)
+    {
+        BenchJournal(iterations);
+        return true;
+    }
+
+    if (strcmp(name, "autosave") == 0)
+    {
+        BenchAutosave(iterations);
+        return true;
+    }
+
+    if (strcmp(name, "inventory") == 0)
+    {
+        BenchInventory(iterations);
+        return true;
+    }
+
+    if (strcmp(name, "dungeon") == 0)
+    {
+        BenchDungeon(iterations);
+        return true;
+    }
+
+    if (strcmp(name, "generate") == 0)
+    {
+        BenchGenerate(iterations);
+        return true;
+    }
+
+    if (strcmp(name, "combat") == 0)
+    {
+        BenchCombat(iterations);
+        return true;
+    }
+
+    if (strcmp(name, "batch") == 0)
+    {
+        BenchCombatBatch(iterations);
+        return true;
+    }
+
+    if (strcmp(name, "render") == 0)
+    {
+        BenchRender(iterations);
+        return true;
+    }
+
+    printf("Unknown benchmark: %s\n", name);
+    printf("Available: random, save, checkpoint, journal, autosave, inventory, dungeon, generate, combat, batch, render\n");
+    return false;
+}
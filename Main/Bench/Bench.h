@@ -0,0 +1,64 @@
+#pragma once
+
+#include "../Game/Game.h"
+
+//--------------------
+// BENCHMARK CONSTANTS
+//--------------------
+
+#define BENCH_RANDOM_ITERATIONS 10000000 // NOLINT(modernize-macro-to-enum)
+#define BENCH_SAVE_ITERATIONS 2000 // NOLINT(modernize-macro-to-enum)
+#define BENCH_CHECKPOINT_COUNT 10000 // NOLINT(modernize-macro-to-enum)
+#define BENCH_JOURNAL_TURNS 2000 // NOLINT(modernize-macro-to-enum)
+#define BENCH_AUTOSAVE_TURNS 2000 // NOLINT(modernize-macro-to-enum)
+#define BENCH_HISTOGRAM_BUCKETS 20 // NOLINT(modernize-macro-to-enum)
+#define BENCH_INVENTORY_ROUNDS 20000 // NOLINT(modernize-macro-to-enum)
+#define BENCH_INVENTORY_FILL 40 // NOLINT(modernize-macro-to-enum)
+#define BENCH_INVENTORY_CHURN 60 // NOLINT(modernize-macro-to-enum)
+#define BENCH_DUNGEON_MAX_ROOMS 10000000 // NOLINT(modernize-macro-to-enum)
+#define BENCH_DUNGEON_WALK_STEPS 100000 // NOLINT(modernize-macro-to-enum)
+#define BENCH_GENERATE_DUNGEONS 200000 // NOLINT(modernize-macro-to-enum)
+#define BENCH_GENERATE_MIN_BOSS_DISTANCE 14 // NOLINT(modernize-macro-to-enum)
+#define BENCH_GENERATE_MAX_DEAD_ENDS 3 // NOLINT(modernize-macro-to-enum)
+#define BENCH_COMBAT_FIGHTS 2000000 // NOLINT(modernize-macro-to-enum)
+#define BENCH_COMBAT_ENEMIES 16 // NOLINT(modernize-macro-to-enum)
+#define BENCH_BATCH_FIGHTS 100000000 // NOLINT(modernize-macro-to-enum)
+#define BENCH_BATCH_ENEMIES 4096 // NOLINT(modernize-macro-to-enum)
+#define BENCH_RENDER_FRAMES 20000 // NOLINT(modernize-macro-to-enum)
+#define BENCH_RENDER_TERMINAL_ROWS 50 // NOLINT(modernize-macro-to-enum)
+#define BENCH_RENDER_SHELL_CLEARS 50 // Each one starts a shell, so far fewer than frames
+#ifdef _WIN32
+#define BENCH_SHELL_CLEAR "cls"
+#else
+#define BENCH_SHELL_CLEAR "clear"
+#endif
+
+//--------------------
+// BENCHMARK STRUCTS
+//--------------------
+
+// Turn latencies in power-of-two microsecond buckets, plus the raw samples for percentiles
+typedef struct BenchHistogram
+{
+    const char* label;
+    unsigned int buckets[BENCH_HISTOGRAM_BUCKETS];
+    double* samples;
+    unsigned int sampleCount;
+}BenchHistogram;
+
+//--------------------
+// BENCHMARK FUNCTIONS
+//--------------------
+
+bool BenchRun(const char* name, unsigned int iterations);
+void BenchRandom(unsigned int iterations);
+void BenchSave(unsigned int iterations);
+void BenchCheckpoint(unsigned int count);
+void BenchJournal(unsigned int turns);
+void BenchAutosave(unsigned int turns);
+void BenchInventory(unsigned int rounds);
+void BenchDungeon(unsigned int maxRooms);
+void BenchGenerate(unsigned int count);
+void BenchCombat(unsigned int fights);
+void BenchCombatBatch(unsigned int fights);
+void BenchRender(unsigned int frames);
@@ -0,0 +1,331 @@
+﻿#include "CombatBatch.h"
+#include <cstdlib>
+#include <cstring>
+
+// SSE2 is part of x64 and of the default Win32 target; AVX2 is checked for at run time
+#if defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define COMBAT_BATCH_SIMD 1
+#include <immintrin.h>
+#include <intrin.h>
+#else
+#define COMBAT_BATCH_SIMD 0
+#endif
+
+//--------------------
+// SCALAR PATH
+//--------------------
+
+// CombatCalculateDamage with the cap the lanes need
+static unsigned short CombatBatchDamage(short attack, float multiplier, short defense)
+{
+    float damage = (float)attack * multiplier - (float)defense * 0.5f;
+    if (damage < 1.0f)
+        damage = 1.0f;
+    if (damage > (float)COMBAT_BATCH_MAX_DAMAGE)
+        damage = (float)COMBAT_BATCH_MAX_DAMAGE;
+    return (unsigned short)damage;
+}
+
+static unsigned short CombatBatchHits(short health, unsigned short damage)
+{
+    if (health <= 0) return 0;
+    return (unsigned short)((health + damage - 1) / damage);
+}
+
+static void CombatBatchEvaluateScalar(CombatBatch* batch)
+{
+    for (unsigned int i = 0; i < batch->count; i++)
+    {
+        unsigned short dealt = CombatBatchDamage(batch->playerAttack[i], batch->playerMultiplier[i], batch->enemyDefense[i]);
+        unsigned short taken = CombatBatchDamage(batch->enemyAttack[i], batch->enemyMultiplier[i], batch->playerDefense[i]);
+        batch->damageDealt[i] = dealt;
+        batch->damageTaken[i] = taken;
+        batch->turnsToKill[i] = CombatBatchHits(batch->enemyHealth[i], dealt);
+        batch->turnsToDie[i] = CombatBatchHits(batch->playerHealth[i], taken);
+        batch->playerWins[i] = batch->turnsToKill[i] <= batch->turnsToDie[i] ? 1 : 0;
+    }
+}
+
+#if COMBAT_BATCH_SIMD
+
+//--------------------
+// SSE2 PATH
+//--------------------
+
+// Sign-extends 8 shorts into two vectors of 4 floats
+static void CombatBatchWidenSSE2(const short* source, __m128* low, __m128* high)
+{
+    __m128i values = _mm_loadu_si128((const __m128i*)source);
+    *low = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(values, values), 16));
+    *high = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(values, values), 16));
+}
+
+// Same float steps as the scalar path, truncated, then back to float for the division
+static __m128 CombatBatchDamageSSE2(__m128 attack, __m128 multiplier, __m128 defense)
+{
+    __m128 damage = _mm_sub_ps(_mm_mul_ps(attack, multiplier), _mm_mul_ps(defense, _mm_set1_ps(0.5f)));
+    damage = _mm_min_ps(_mm_max_ps(damage, _mm_set1_ps(1.0f)), _mm_set1_ps((float)COMBAT_BATCH_MAX_DAMAGE));
+    return _mm_cvtepi32_ps(_mm_cvttps_epi32(damage));
+}
+
+// Truncated quotient, plus one where it leaves health standing. Every product here is below 2^24,
+// so the float check is exact even when the division rounded up.
+static __m128i CombatBatchHitsSSE2(__m128 health, __m128 damage)
+{
+    health = _mm_max_ps(health, _mm_setzero_ps());
+    __m128 hits = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_div_ps(health, damage)));
+    __m128 shortfall = _mm_cmplt_ps(_mm_mul_ps(hits, damage), health);
+    return _mm_sub_epi32(_mm_cvttps_epi32(hits), _mm_castps_si128(shortfall));
+}
+
+static void CombatBatchEvaluateSSE2(CombatBatch* batch)
+{
+    for (unsigned int i = 0; i < batch->count; i += 8)
+    {
+        __m128 playerAttack[2], playerDefense[2], playerHealth[2];
+        __m128 enemyAttack[2], enemyDefense[2], enemyHealth[2];
+        CombatBatchWidenSSE2(batch->playerAttack + i, &playerAttack[0], &playerAttack[1]);
+        CombatBatchWidenSSE2(batch->playerDefense + i, &playerDefense[0], &playerDefense[1]);
+        CombatBatchWidenSSE2(batch->playerHealth + i, &playerHealth[0], &playerHealth[1]);
+        CombatBatchWidenSSE2(batch->enemyAttack + i, &enemyAttack[0], &enemyAttack[1]);
+        CombatBatchWidenSSE2(batch->enemyDefense + i, &enemyDefense[0], &enemyDefense[1]);
+        CombatBatchWidenSSE2(batch->enemyHealth + i, &enemyHealth[0], &enemyHealth[1]);
+        
+        __m128i dealt[2], taken[2], kill[2], die[2];
+        for (short h = 0; h < 2; h++)
+        {
+            __m128 playerMultiplier = _mm_loadu_ps(batch->playerMultiplier + i + h * 4);
+            __m128 enemyMultiplier = _mm_loadu_ps(batch->enemyMultiplier + i + h * 4);
+            __m128 dealtDamage = CombatBatchDamageSSE2(playerAttack[h], playerMultiplier, enemyDefense[h]);
+            __m128 takenDamage = CombatBatchDamageSSE2(enemyAttack[h], enemyMultiplier, playerDefense[h]);
+            dealt[h] = _mm_cvttps_epi32(dealtDamage);
+            taken[h] = _mm_cvttps_epi32(takenDamage);
+            kill[h] = CombatBatchHitsSSE2(enemyHealth[h], dealtDamage);
+            die[h] = CombatBatchHitsSSE2(playerHealth[h], takenDamage);
+        }
+        
+        // Everything fits in 15 bits, so the signed packs never saturate
+        __m128i turnsToKill = _mm_packs_epi32(kill[0], kill[1]);
+        __m128i turnsToDie = _mm_packs_epi32(die[0], die[1]);
+        _mm_storeu_si128((__m128i*)(batch->damageDealt + i), _mm_packs_epi32(dealt[0], dealt[1]));
+        _mm_storeu_si128((__m128i*)(batch->damageTaken + i), _mm_packs_epi32(taken[0], taken[1]));
+        _mm_storeu_si128((__m128i*)(batch->turnsToKill + i), turnsToKill);
+        _mm_storeu_si128((__m128i*)(batch->turnsToDie + i), turnsToDie);
+        __m128i wins = _mm_andnot_si128(_mm_cmpgt_epi16(turnsToKill, turnsToDie), _mm_set1_epi16(1));
+        _mm_storel_epi64((__m128i*)(batch->playerWins + i), _mm_packus_epi16(wins, wins));
+    }
+}
+
+//--------------------
+// AVX2 PATH
+//--------------------
+
+static __m256 CombatBatchWidenAVX2(const short* source)
+{
+    return _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)source)));
+}
+
+static __m256 CombatBatchDamageAVX2(__m256 attack, __m256 multiplier, __m256 defense)
+{
+    __m256 damage = _mm256_sub_ps(_mm256_mul_ps(attack, multiplier), _mm256_mul_ps(defense, _mm256_set1_ps(0.5f)));
+    damage = _mm256_min_ps(_mm256_max_ps(damage, _mm256_set1_ps(1.0f)), _mm256_set1_ps((float)COMBAT_BATCH_MAX_DAMAGE));
+    return _mm256_cvtepi32_ps(_mm256_cvttps_epi32(damage));
+}
+
+static __m256i CombatBatchHitsAVX2(__m256 health, __m256 damage)
+{
+    health = _mm256_max_ps(health, _mm256_setzero_ps());
+    __m256 hits = _mm256_cvtepi32_ps(_mm256_cvttps_epi32(_mm256_div_ps(health, damage)));
+    __m256 shortfall = _mm256_cmp_ps(_mm256_mul_ps(hits, damage), health, _CMP_LT_OQ);
+    return _mm256_sub_epi32(_mm256_cvttps_epi32(hits), _mm256_castps_si256(shortfall));
+}
+
+// The 256-bit pack works within each 128-bit half; put the four 64-bit quarters back in order
+static __m256i CombatBatchPackAVX2(__m256i low, __m256i high)
+{
+    return _mm256_permute4x64_epi64(_mm256_packs_epi32(low, high), 0xD8);
+}
+
+static void CombatBatchEvaluateAVX2(CombatBatch* batch)
+{
+    for (unsigned int i = 0; i < batch->count; i += 16)
+    {
+        __m256i dealt[2], taken[2], kill[2], die[2];
+        for (short h = 0; h < 2; h++)
+        {
+            unsigned int at = i + h * 8;
+            __m256 dealtDamage = CombatBatchDamageAVX2(CombatBatchWidenAVX2(batch->playerAttack + at),
+                                                       _mm256_loadu_ps(batch->playerMultiplier + at),
+                                                       CombatBatchWidenAVX2(batch->enemyDefense + at));
+            __m256 takenDamage = CombatBatchDamageAVX2(CombatBatchWidenAVX2(batch->enemyAttack + at),
+                                                       _mm256_loadu_ps(batch->enemyMultiplier + at),
+                                                       CombatBatchWidenAVX2(batch->playerDefense + at));
+            dealt[h] = _mm256_cvttps_epi32(dealtDamage);
+            taken[h] = _mm256_cvttps_epi32(takenDamage);
+            kill[h] = CombatBatchHitsAVX2(CombatBatchWidenAVX2(batch->enemyHealth + at), dealtDamage);
+            die[h] = CombatBatchHitsAVX2(CombatBatchWidenAVX2(batch->playerHealth + at), takenDamage);
+        }
+        
+        __m256i turnsToKill = CombatBatchPackAVX2(kill[0], kill[1]);
+        __m256i turnsToDie = CombatBatchPackAVX2(die[0], die[1]);
+        _mm256_storeu_si256((__m256i*)(batch->damageDealt + i), CombatBatchPackAVX2(dealt[0], dealt[1]));
+        _mm256_storeu_si256((__m256i*)(batch->damageTaken + i), CombatBatchPackAVX2(taken[0], taken[1]));
+        _mm256_storeu_si256((__m256i*)(batch->turnsToKill + i), turnsToKill);
+        _mm256_storeu_si256((__m256i*)(batch->turnsToDie + i), turnsToDie);
+        __m256i wins = _mm256_andnot_si256(_mm256_cmpgt_epi16(turnsToKill, turnsToDie), _mm256_set1_epi16(1));
+        wins = _mm256_permute4x64_epi64(_mm256_packus_epi16(wins, wins), 0xD8);
+        _mm_storeu_si128((__m128i*)(batch->playerWins + i), _mm256_castsi256_si128(wins));
+    }
+}
+
+#endif
+
+static CombatBatchPath CombatBatchDetectPath()
+{
+#if COMBAT_BATCH_SIMD
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return COMBAT_BATCH_SSE2;
+    
+    // AVX2 needs the CPU flag and an OS that saves the upper halves of the registers
+    __cpuid(info, 1);
+    bool avxEnabled = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+    __cpuidex(info, 7, 0);
+    return avxEnabled && (info[1] & (1 << 5)) != 0 ? COMBAT_BATCH_AVX2 : COMBAT_BATCH_SSE2;
+#else
+    return COMBAT_BATCH_SCALAR;
+#endif
+}
+
+//--------------------
+// COMBAT BATCH FUNCTIONS
+//--------------------
+
+CombatBatch* CombatBatchCreate(unsigned int capacity)
+{
+    CombatBatch* batch = (CombatBatch*)calloc(1, sizeof(CombatBatch));
+    if (batch == nullptr)
+    {
+        printf("ERROR - Failed to allocate memory for combat batch\n");
+        return nullptr;
+    }
+    capacity = (capacity + COMBAT_BATCH_LANES - 1) / COMBAT_BATCH_LANES * COMBAT_BATCH_LANES;
+    if (capacity == 0) capacity = COMBAT_BATCH_LANES;
+    
+    // One block: the float arrays first, then the ten short arrays, then the win flags
+    size_t perFight = 2 * sizeof(float) + 10 * sizeof(short) + sizeof(unsigned char);
+    unsigned char* block = (unsigned char*)calloc(capacity, perFight);
+    if (block == nullptr)
+    {
+        printf("ERROR - Failed to allocate %u combat batch entries\n", capacity);
+        free(batch);
+        return nullptr;
+    }
+    batch->capacity = capacity;
+    batch->playerMultiplier = (float*)block;
+    batch->enemyMultiplier = batch->playerMultiplier + capacity;
+    short* shorts = (short*)(batch->enemyMultiplier + capacity);
+    short** inputs[6] = {&batch->playerAttack, &batch->playerDefense, &batch->playerHealth,
+                         &batch->enemyAttack, &batch->enemyDefense, &batch->enemyHealth};
+    for (short i = 0; i < 6; i++)
+    {
+        *inputs[i] = shorts + i * capacity;
+    }
+    unsigned short** outputs[4] = {&batch->damageDealt, &batch->damageTaken, &batch->turnsToKill, &batch->turnsToDie};
+    for (short i = 0; i < 4; i++)
+    {
+        *outputs[i] = (unsigned short*)(shorts + (6 + i) * capacity);
+    }
+    batch->playerWins = (unsigned char*)(shorts + 10 * capacity);
+    return batch;
+}
+
+void CombatBatchFree(CombatBatch* batch)
+{
+    if (batch == nullptr) return;
+    free(batch->playerMultiplier);
+    free(batch);
+}
+
+void CombatBatchClear(CombatBatch* batch)
+{
+    if (batch == nullptr) return;
+    batch->count = 0;
+}
+
+bool CombatBatchAdd(CombatBatch* batch, const Player* player, const Enemy* enemy, float playerMultiplier, float enemyMultiplier)
+{
+    if (batch == nullptr || player == nullptr || enemy == nullptr || batch->count >= batch->capacity)
+    {
+        return false;
+    }
+    unsigned int i = batch->count++;
+    batch->playerAttack[i] = (short)player->attack;
+    batch->playerDefense[i] = (short)player->defense;
+    batch->playerHealth[i] = (short)player->health;
+    batch->playerMultiplier[i] = playerMultiplier;
+    batch->enemyAttack[i] = enemy->attack;
+    batch->enemyDefense[i] = enemy->defense;
+    batch->enemyHealth[i] = enemy->health;
+    batch->enemyMultiplier[i] = enemyMultiplier;
+    return true;
+}
+
+CombatBatchPath CombatBatchBestPath()
+{
+    static const CombatBatchPath best = CombatBatchDetectPath();
+    return best;
+}
+
+// False when this build or CPU lacks the path
+bool CombatBatchEvaluate(CombatBatch* batch, CombatBatchPath path)
+{
+    if (batch == nullptr || path > CombatBatchBestPath())
+    {
+        return false;
+    }
+    switch (path)
+    {
+    case COMBAT_BATCH_SCALAR:
+        {
+            CombatBatchEvaluateScalar(batch);
+            return true;
+        }
+#if COMBAT_BATCH_SIMD
+    case COMBAT_BATCH_SSE2:
+        {
+            CombatBatchEvaluateSSE2(batch);
+            return true;
+        }
+    case COMBAT_BATCH_AVX2:
+        {
+            CombatBatchEvaluateAVX2(batch);
+            return true;
+        }
+#endif
+    default:
+        {
+            return false;
+        }
+    }
+}
+
+const char* CombatBatchPathName(CombatBatchPath path)
+{
+    switch (path)
+    {
+    case COMBAT_BATCH_SCALAR:
+        {
+            return "scalar";
+        }
+    case COMBAT_BATCH_SSE2:
+        {
+            return "SSE2";
+        }
+    case COMBAT_BATCH_AVX2:
+        {
+            return "AVX2";
+        }
+    }
+    return "unknown";
+}
@@ -0,0 +1,71 @@
+﻿#pragma once
+
+#include "Game.h"
+
+//--------------------
+// COMBAT BATCH CONSTANTS
+//--------------------
+
+#define COMBAT_BATCH_LANES 16 // Fights per step on the widest path; capacity is padded to a multiple
+#define COMBAT_BATCH_MAX_DAMAGE 32767 // Damage is capped here; one such hit kills anything with short health
+#define COMBAT_BATCH_PLAYER_MULTIPLIER 1.15f // Plain attack on average: 15% crits at 2x
+#define COMBAT_BATCH_ENEMY_MULTIPLIER 1.05f // Enemy attack on average: 10% crits at 1.5x
+
+//--------------------
+// COMBAT BATCH ENUMS
+//--------------------
+
+typedef enum
+{
+    COMBAT_BATCH_SCALAR = 0,
+    COMBAT_BATCH_SSE2 = 1, // 8 fights per step
+    COMBAT_BATCH_AVX2 = 2, // 16 fights per step
+    
+}CombatBatchPath;
+
+//--------------------
+// COMBAT BATCH STRUCTS
+//--------------------
+
+// Fights stored as one array per field so a step loads the same field of 8 or 16 fights at once.
+// All arrays hold capacity entries. Steps run over whole groups, so entries past count get
+// evaluated too and their results mean nothing.
+typedef struct CombatBatch
+{
+    unsigned int count;
+    unsigned int capacity;
+    short* playerAttack;
+    short* playerDefense;
+    short* playerHealth;
+    float* playerMultiplier; // On the player's attack, e.g. COMBAT_BATCH_PLAYER_MULTIPLIER
+    short* enemyAttack;
+    short* enemyDefense;
+    short* enemyHealth;
+    float* enemyMultiplier;
+    unsigned short* damageDealt; // Per player hit
+    unsigned short* damageTaken; // Per enemy hit
+    unsigned short* turnsToKill; // Player hits until the enemy falls
+    unsigned short* turnsToDie; // Enemy hits until the player falls
+    unsigned char* playerWins; // 1 when the enemy falls first; the player strikes first each turn
+}CombatBatch;
+
+//--------------------
+// COMBAT BATCH FUNCTIONS
+//--------------------
+
+//
+// Evaluates many one-on-one matchups at a fixed damage multiplier per side, with no rolls: the
+// damage each side deals per hit (CombatCalculateDamage, capped at COMBAT_BATCH_MAX_DAMAGE) and
+// how many hits each needs. Meant for sweeping one player build across thousands of enemies from
+// EnemyGenerateForLevel before playing the promising ones out with CombatResolve.
+//
+// Every path gives the same results. SSE2 is always there on x64 and the Win32 default build;
+// AVX2 is used when the CPU and OS support it. CombatBatchBestPath picks the widest available.
+//
+CombatBatch* CombatBatchCreate(unsigned int capacity);
+void CombatBatchFree(CombatBatch* batch);
+void CombatBatchClear(CombatBatch* batch);
+bool CombatBatchAdd(CombatBatch* batch, const Player* player, const Enemy* enemy, float playerMultiplier, float enemyMultiplier);
+CombatBatchPath CombatBatchBestPath();
+bool CombatBatchEvaluate(CombatBatch* batch, CombatBatchPath path);
+const char* CombatBatchPathName(CombatBatchPath path);
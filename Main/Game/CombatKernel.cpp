@@ -0,0 +1,456 @@
+﻿#include "CombatKernel.h"
+#include <cstring>
+
+//--------------------
+// KERNEL HELPERS
+//--------------------
+
+// Where a turn's rolls come from: the random state, or the bits of a fixed outcome with each
+// chance written down so the caller can weigh the branch
+typedef struct CombatRoller
+{
+    RandomState* random;
+    unsigned int fixed;
+    CombatRolls* rolls;
+}CombatRoller;
+
+// Same draw as RandomChance on the current game, so a fight rolls identically through either
+static bool CombatChance(CombatRoller* roller, float prob)
+{
+    if (roller->random != nullptr)
+    {
+        return (float)(RandomNextU32(roller->random) >> 8) * (1.0f / 16777216.0f) < prob;
+    }
+    CombatRolls* rolls = roller->rolls;
+    if (rolls->count >= COMBAT_MAX_ROLLS) return false;
+    rolls->chances[rolls->count] = prob;
+    return ((roller->fixed >> rolls->count++) & 1) != 0;
+}
+
+static void CombatFighterDamage(CombatFighter* fighter, unsigned short damage)
+{
+    fighter->health = damage >= fighter->health ? (short)0 : (short)(fighter->health - damage);
+}
+
+static void CombatFighterHeal(CombatFighter* fighter, unsigned short heal)
+{
+    int health = fighter->health + heal;
+    fighter->health = (short)(health > fighter->maxHealth ? fighter->maxHealth : health);
+}
+
+static CombatEvent* CombatLogEvent(CombatTurnLog* log, CombatEventType type, CombatSide target, short value, short remaining)
+{
+    if (log == nullptr || log->count >= COMBAT_MAX_EVENTS) return nullptr;
+    CombatEvent* event = &log->events[log->count++];
+    memset(event, 0, sizeof(CombatEvent));
+    event->type = type;
+    event->target = target;
+    event->value = value;
+    event->remaining = remaining;
+    event->slot = -1;
+    return event;
+}
+
+static void CombatHitEnemy(CombatState* state, unsigned short damage, short slot, short strike, bool critical,
+                           CombatOutcome* outcome, CombatTurnLog* log)
+{
+    CombatFighterDamage(&state->enemy, damage);
+    outcome->damageDealt += damage;
+    CombatEvent* event = CombatLogEvent(log, COMBAT_EVENT_HIT, COMBAT_SIDE_ENEMY, (short)damage, state->enemy.health);
+    if (event != nullptr)
+    {
+        event->slot = slot;
+        event->strike = strike;
+        event->critical = critical;
+    }
+}
+
+//--------------------
+// ACTIONS
+//--------------------
+
+static void CombatResolveAttack(CombatState* state, CombatRoller* roller, CombatOutcome* outcome, CombatTurnLog* log)
+{
+    bool isCritical = CombatChance(roller, 0.15f);
+    float multiplier = isCritical ? 2.0f : 1.0f;
+    unsigned short damage = CombatCalculateDamage((unsigned short)state->player.attack, (unsigned short)state->enemy.defense, multiplier);
+    CombatHitEnemy(state, damage, -1, 0, isCritical, outcome, log);
+}
+
+static void CombatResolveAbility(CombatState* state, short slot, CombatRoller* roller, CombatOutcome* outcome, CombatTurnLog* log)
+{
+    CombatAbility* ability = &state->abilities[slot];
+    unsigned short attack = (unsigned short)state->player.attack;
+    unsigned short defense = (unsigned short)state->enemy.defense;
+    unsigned short baseDamage = CombatCalculateDamage(attack, defense, ability->damageMultiplier);
+    
+    switch (ability->abilityId)
+    {
+    case 1: // Power Strike
+    case 4: // Whirlwind
+    case 5: // Devastating Blow
+        {
+            float critChance = ability->abilityId == 1 ? 0.20f : ability->abilityId == 5 ? 0.25f : 0.15f;
+            bool isCritical = CombatChance(roller, critChance);
+            unsigned short finalDamage = isCritical ? (unsigned short)(baseDamage * 1.5f) : baseDamage;
+            CombatHitEnemy(state, finalDamage, slot, 0, isCritical, outcome, log);
+            break;
+        }
+    case 2: // Double Slash - two plain hits, the second only if the first did not kill
+        {
+            unsigned short hitDamage = CombatCalculateDamage(attack, defense, 1.0f);
+            CombatHitEnemy(state, hitDamage, slot, 1, false, outcome, log);
+            if (state->enemy.health > 0)
+            {
+                CombatHitEnemy(state, hitDamage, slot, 2, false, outcome, log);
+            }
+            break;
+        }
+    case 3: // Life Drain - heals half the damage dealt
+        {
+            CombatHitEnemy(state, baseDamage, slot, 0, false, outcome, log);
+            unsigned short healAmount = baseDamage / 2;
+            if (healAmount < 1) healAmount = 1;
+            CombatFighterHeal(&state->player, healAmount);
+            CombatEvent* event = CombatLogEvent(log, COMBAT_EVENT_HEAL, COMBAT_SIDE_PLAYER, (short)healAmount, state->player.health);
+            if (event != nullptr) event->slot = slot;
+            break;
+        }
+    default:
+        {
+            CombatHitEnemy(state, baseDamage, slot, 0, false, outcome, log);
+            break;
+        }
+    }
+    ability->cooldownRemaining = ability->cooldown;
+    outcome->abilitiesUsed++;
+}
+
+static void CombatResolveItem(CombatState* state, short slot, CombatOutcome* outcome, CombatTurnLog* log)
+{
+    CombatItem* item = &state->items[slot];
+    CombatFighter* player = &state->player;
+    switch (item->type)
+    {
+    case WEAPON:
+        {
+            player->attack = (short)(player->attack + item->value);
+            break;
+        }
+    case ARMOR:
+        {
+            player->defense = (short)(player->defense + item->value);
+            break;
+        }
+    case POTION:
+        {
+            CombatFighterHeal(player, (unsigned short)item->value);
+            break;
+        }
+    }
+    CombatEvent* event = CombatLogEvent(log, COMBAT_EVENT_ITEM, COMBAT_SIDE_PLAYER, item->value, player->health);
+    if (event != nullptr)
+    {
+        event->slot = item->itemID;
+        event->itemType = item->type;
+    }
+    outcome->itemsUsed++;
+    
+    item->quantity--;
+    if (item->quantity <= 0)
+    {
+        state->itemCount--;
+        *item = state->items[state->itemCount];
+    }
+}
+
+static bool CombatResolveEscape(CombatState* state, CombatRoller* roller, CombatTurnLog* log)
+{
+    float escapeChance = 0.40f;
+    if (state->trait == TRAIT_QUICK_HANDS)
+        escapeChance += 0.15f;
+    
+    bool escaped = CombatChance(roller, escapeChance);
+    CombatLogEvent(log, COMBAT_EVENT_ESCAPE, COMBAT_SIDE_PLAYER, escaped ? (short)1 : (short)0, state->player.health);
+    return escaped;
+}
+
+static void CombatResolveEnemyAttack(CombatState* state, CombatRoller* roller, CombatOutcome* outcome, CombatTurnLog* log)
+{
+    bool isCritical = CombatChance(roller, 0.10f);
+    float multiplier = isCritical ? 1.5f : 1.0f;
+    unsigned short damage = CombatCalculateDamage((unsigned short)state->enemy.attack, (unsigned short)state->player.defense, multiplier);
+    CombatFighterDamage(&state->player, damage);
+    outcome->damageTaken += damage;
+    CombatEvent* event = CombatLogEvent(log, COMBAT_EVENT_HIT, COMBAT_SIDE_PLAYER, (short)damage, state->player.health);
+    if (event != nullptr) event->critical = isCritical;
+}
+
+// Poison and bleed hurt every turn; when an effect runs out the player gets back the stat it took
+// or gave (PlayerApplyStatusEffects changes the stat up front, nothing does so for enemies)
+static void CombatTickEffects(CombatFighter* fighter, CombatSide side, CombatTurnLog* log)
+{
+    for (short i = 0; i < fighter->statusEffectCount; i++)
+    {
+        StatusEffect* effect = &fighter->statusEffect[i];
+        if (effect->type == POISON || effect->type == BLEED)
+        {
+            CombatFighterDamage(fighter, effect->damagePerTurn);
+        }
+        CombatEvent* event = CombatLogEvent(log, COMBAT_EVENT_EFFECT_TICK, side, (short)effect->damagePerTurn, fighter->health);
+        if (event != nullptr) event->effect = *effect;
+        
+        effect->duration--;
+        if (effect->duration > 0)
+        {
+            continue;
+        }
+        short restored = 0;
+        if (side == COMBAT_SIDE_PLAYER && effect->type == FORTIFIED)
+        {
+            fighter->defense = (short)(fighter->defense - effect->statModifier);
+            restored = effect->statModifier;
+        }
+        else if (side == COMBAT_SIDE_PLAYER && effect->type == WEAKENED)
+        {
+            fighter->attack = (short)(fighter->attack + effect->statModifier);
+            restored = effect->statModifier;
+        }
+        event = CombatLogEvent(log, COMBAT_EVENT_EFFECT_EXPIRED, side, restored, fighter->health);
+        if (event != nullptr) event->effect = *effect;
+        
+        fighter->statusEffectCount--;
+        memmove(effect, effect + 1, (fighter->statusEffectCount - i) * sizeof(StatusEffect));
+        i--;
+    }
+}
+
+static void CombatFighterInit(CombatFighter* fighter, short health, short maxHealth, short attack, short defense,
+                              const StatusEffect* effects, short effectCount)
+{
+    fighter->health = health;
+    fighter->maxHealth = maxHealth;
+    fighter->attack = attack;
+    fighter->defense = defense;
+    fighter->statusEffectCount = effectCount < COMBAT_MAX_EFFECTS ? effectCount : (short)COMBAT_MAX_EFFECTS;
+    memcpy(fighter->statusEffect, effects, fighter->statusEffectCount * sizeof(StatusEffect));
+}
+
+//--------------------
+// COMBAT KERNEL FUNCTIONS
+//--------------------
+
+void CombatStateInit(CombatState* state, const Player* player, const Enemy* enemy, const Inventory* inventory)
+{
+    if (state == nullptr || player == nullptr || enemy == nullptr) return;
+    
+    memset(state, 0, sizeof(CombatState));
+    CombatFighterInit(&state->player, (short)player->health, (short)player->maxHealth, (short)player->attack,
+                      (short)player->defense, player->statusEffect, (short)player->statusEffectCount);
+    CombatFighterInit(&state->enemy, enemy->health, enemy->baseHealth, enemy->attack, enemy->defense,
+                      enemy->statusEffect, enemy->statusEffectCount);
+    state->trait = player->trait;
+    
+    state->abilityCount = player->abilityCount;
+    for (unsigned short i = 0; i < player->abilityCount; i++)
+    {
+        const Ability* ability = &player->unlockedAbilities[i];
+        state->abilities[i].abilityId = ability->abilityId;
+        state->abilities[i].cooldown = (short)ability->cooldown;
+        state->abilities[i].cooldownRemaining = (short)ability->cooldownRemaining;
+        state->abilities[i].damageMultiplier = ability->damageMultiplier;
+    }
+    
+    if (inventory == nullptr) return;
+    state->itemCount = (unsigned short)inventory->itemCount;
+    for (short i = 0; i < inventory->itemCount; i++)
+    {
+        const Item* item = &inventory->items[i];
+        state->items[i].itemID = item->itemID;
+        state->items[i].value = item->value;
+        state->items[i].quantity = item->quantity;
+        state->items[i].type = item->type;
+    }
+}
+
+// Writes back what a fight changes; items are left to the caller, which knows which ones went
+void CombatStateApply(const CombatState* state, Player* player, Enemy* enemy)
+{
+    if (state == nullptr || player == nullptr || enemy == nullptr) return;
+    
+    player->health = (unsigned short)state->player.health;
+    player->attack = (unsigned short)state->player.attack;
+    player->defense = (unsigned short)state->player.defense;
+    player->statusEffectCount = (unsigned short)state->player.statusEffectCount;
+    memcpy(player->statusEffect, state->player.statusEffect, state->player.statusEffectCount * sizeof(StatusEffect));
+    for (unsigned short i = 0; i < state->abilityCount; i++)
+    {
+        player->unlockedAbilities[i].cooldownRemaining = state->abilities[i].cooldownRemaining;
+    }
+    
+    enemy->health = state->enemy.health;
+    enemy->statusEffectCount = state->enemy.statusEffectCount;
+    memcpy(enemy->statusEffect, state->enemy.statusEffect, state->enemy.statusEffectCount * sizeof(StatusEffect));
+}
+
+bool CombatActionIsValid(const CombatState* state, CombatAction action)
+{
+    switch (action.type)
+    {
+    case COMBAT_ACTION_ATTACK:
+    case COMBAT_ACTION_ESCAPE:
+        {
+            return true;
+        }
+    case COMBAT_ACTION_ABILITY:
+        {
+            return action.slot >= 0 && action.slot < state->abilityCount && state->abilities[action.slot].cooldownRemaining <= 0;
+        }
+    case COMBAT_ACTION_ITEM:
+        {
+            return action.slot >= 0 && action.slot < state->itemCount;
+        }
+    }
+    return false;
+}
+
+static bool CombatResolveTurnWith(CombatState* state, CombatAction action, CombatRoller* roller, CombatOutcome* outcome, CombatTurnLog* log)
+{
+    if (log != nullptr) log->count = 0;
+    if (!CombatActionIsValid(state, action))
+    {
+        action.type = COMBAT_ACTION_ATTACK;
+    }
+    outcome->turns++;
+    
+    switch (action.type)
+    {
+    case COMBAT_ACTION_ATTACK:
+        {
+            CombatResolveAttack(state, roller, outcome, log);
+            break;
+        }
+    case COMBAT_ACTION_ABILITY:
+        {
+            CombatResolveAbility(state, action.slot, roller, outcome, log);
+            break;
+        }
+    case COMBAT_ACTION_ITEM:
+        {
+            CombatResolveItem(state, action.slot, outcome, log);
+            break;
+        }
+    case COMBAT_ACTION_ESCAPE:
+        {
+            if (CombatResolveEscape(state, roller, log))
+            {
+                outcome->result = COMBAT_ESCAPE;
+                return true;
+            }
+            break;
+        }
+    }
+    if (state->enemy.health <= 0)
+    {
+        outcome->result = COMBAT_VICTORY;
+        return true;
+    }
+    
+    CombatResolveEnemyAttack(state, roller, outcome, log);
+    if (state->player.health <= 0)
+    {
+        outcome->result = COMBAT_DEFEAT;
+        return true;
+    }
+    
+    CombatTickEffects(&state->player, COMBAT_SIDE_PLAYER, log);
+    CombatTickEffects(&state->enemy, COMBAT_SIDE_ENEMY, log);
+    if (state->player.health <= 0 || state->enemy.health <= 0)
+    {
+        outcome->result = state->player.health <= 0 ? COMBAT_DEFEAT : COMBAT_VICTORY;
+        return true;
+    }
+    
+    for (unsigned short i = 0; i < state->abilityCount; i++)
+    {
+        if (state->abilities[i].cooldownRemaining > 0)
+            state->abilities[i].cooldownRemaining--;
+    }
+    return false;
+}
+
+// True once the fight is over, with outcome->result set
+bool CombatResolveTurn(CombatState* state, CombatAction action, RandomState* random, CombatOutcome* outcome, CombatTurnLog* log)
+{
+    CombatRoller roller = {random, 0, nullptr};
+    return CombatResolveTurnWith(state, action, &roller, outcome, log);
+}
+
+// Roll i comes out true when bit i of rollOutcomes is set. rolls gets the chance of every roll the
+// turn made; bits at or past rolls->count were never read, so those outcomes repeat an earlier one.
+bool CombatResolveTurnFixed(CombatState* state, CombatAction action, unsigned int rollOutcomes, CombatRolls* rolls, CombatOutcome* outcome)
+{
+    rolls->count = 0;
+    CombatRoller roller = {nullptr, rollOutcomes, rolls};
+    return CombatResolveTurnWith(state, action, &roller, outcome, nullptr);
+}
+
+// Every turn deals at least one damage to somebody and items run out, so a fight always ends
+void CombatResolve(CombatState* state, CombatPolicy policy, void* context, RandomState* random, CombatOutcome* outcome)
+{
+    if (state == nullptr || policy == nullptr || random == nullptr || outcome == nullptr) return;
+    
+    memset(outcome, 0, sizeof(CombatOutcome));
+    while (!CombatResolveTurn(state, policy(context, state), random, outcome, nullptr))
+    {
+    }
+}
+
+CombatAction CombatPolicyAttack(void* context, const CombatState* state)
+{
+    (void)context;
+    (void)state;
+    CombatAction action = {COMBAT_ACTION_ATTACK, 0};
+    return action;
+}
+
+// What the simulation bot does: drink the first potion below 35% health, else open with the first
+// ability off cooldown, else attack
+CombatAction CombatPolicyGreedy(void* context, const CombatState* state)
+{
+    (void)context;
+    CombatAction action = {COMBAT_ACTION_ATTACK, 0};
+    if (state->player.health < (short)(state->player.maxHealth * 0.35f))
+    {
+        for (unsigned short i = 0; i < state->itemCount; i++)
+        {
+            if (state->items[i].type == POTION)
+            {
+                action.type = COMBAT_ACTION_ITEM;
+                action.slot = (short)i;
+                return action;
+            }
+        }
+    }
+    for (unsigned short i = 0; i < state->abilityCount; i++)
+    {
+        if (state->abilities[i].cooldownRemaining <= 0)
+        {
+            action.type = COMBAT_ACTION_ABILITY;
+            action.slot = (short)i;
+            return action;
+        }
+    }
+    return action;
+}
+
+// Runs once under a quarter health, otherwise fights as CombatPolicyGreedy
+CombatAction CombatPolicyCautious(void* context, const CombatState* state)
+{
+    if (state->player.health < state->player.maxHealth / 4)
+    {
+        CombatAction action = {COMBAT_ACTION_ESCAPE, 0};
+        return action;
+    }
+    return CombatPolicyGreedy(context, state);
+}
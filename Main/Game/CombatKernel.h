@@ -0,0 +1,156 @@
+﻿#pragma once
+
+#include "Game.h"
+
+//--------------------
+// COMBAT KERNEL CONSTANTS
+//--------------------
+
+#define COMBAT_MAX_EFFECTS 10 // NOLINT(modernize-macro-to-enum)
+#define COMBAT_MAX_EVENTS 48 // One action, the enemy's reply, and a tick and expiry per effect on both sides
+#define COMBAT_MAX_ROLLS 2 // The action's roll and the enemy's critical
+
+//--------------------
+// COMBAT KERNEL ENUMS
+//--------------------
+
+typedef enum
+{
+    COMBAT_ACTION_ATTACK = 0,
+    COMBAT_ACTION_ABILITY = 1,
+    COMBAT_ACTION_ITEM = 2,
+    COMBAT_ACTION_ESCAPE = 3,
+    
+}CombatActionType;
+
+typedef enum
+{
+    COMBAT_SIDE_PLAYER = 0,
+    COMBAT_SIDE_ENEMY = 1,
+    
+}CombatSide;
+
+typedef enum
+{
+    COMBAT_EVENT_HIT = 0,
+    COMBAT_EVENT_HEAL = 1,
+    COMBAT_EVENT_ITEM = 2,
+    COMBAT_EVENT_ESCAPE = 3,
+    COMBAT_EVENT_EFFECT_TICK = 4,
+    COMBAT_EVENT_EFFECT_EXPIRED = 5,
+    
+}CombatEventType;
+
+//--------------------
+// COMBAT KERNEL STRUCTS
+//--------------------
+
+typedef struct CombatAction
+{
+    CombatActionType type;
+    short slot; // Index into CombatState abilities or items
+}CombatAction;
+
+typedef struct CombatFighter
+{
+    short health;
+    short maxHealth;
+    short attack;
+    short defense;
+    StatusEffect statusEffect[COMBAT_MAX_EFFECTS];
+    short statusEffectCount;
+}CombatFighter;
+
+typedef struct CombatAbility
+{
+    unsigned short abilityId;
+    short cooldown;
+    short cooldownRemaining;
+    float damageMultiplier;
+}CombatAbility;
+
+typedef struct CombatItem
+{
+    short itemID;
+    short value;
+    short quantity;
+    ItemType type;
+}CombatItem;
+
+// Everything a fight reads or changes, copied out of the Player, Enemy and Inventory so the kernel
+// never touches game state. Items sit in inventory order and an item used up is replaced by the last
+// one, as InventoryRemoveItem does, so slots line up with the inventory throughout.
+typedef struct CombatState //NOLINT(clang-diagnostic-padded)
+{
+    CombatFighter player;
+    CombatFighter enemy;
+    PlayerTrait trait;
+    CombatAbility abilities[MAX_ABILITIES];
+    unsigned short abilityCount;
+    CombatItem items[MAX_INVENTORY];
+    unsigned short itemCount;
+}CombatState;
+
+typedef struct CombatOutcome
+{
+    CombatResult result; // Only meaningful once the fight is over
+    unsigned short turns; // Player actions taken
+    unsigned int damageDealt; // Hits on the enemy, before clamping to its health
+    unsigned int damageTaken; // Hits on the player, before clamping to its health
+    unsigned short itemsUsed;
+    unsigned short abilitiesUsed;
+}CombatOutcome;
+
+// One thing that happened during a turn, for the interactive layer to show
+typedef struct CombatEvent //NOLINT(clang-diagnostic-padded)
+{
+    CombatEventType type;
+    CombatSide target; // Side the hit, heal, item or effect landed on
+    short value; // Damage, healing, the item's value, or the stat an expired effect gives back; 1 for a clean escape
+    short remaining; // Target's health afterwards
+    short slot; // Ability slot, -1 for a plain attack; the item's ID for COMBAT_EVENT_ITEM
+    short strike; // 1 and 2 for the hits of a two-hit ability, else 0
+    bool critical;
+    ItemType itemType;
+    StatusEffect effect; // As it stood before this tick, for the effect events
+}CombatEvent;
+
+typedef struct CombatTurnLog
+{
+    CombatEvent events[COMBAT_MAX_EVENTS];
+    short count;
+}CombatTurnLog;
+
+// The chances behind a fixed turn, in the order it rolled them
+typedef struct CombatRolls
+{
+    float chances[COMBAT_MAX_ROLLS];
+    short count;
+}CombatRolls;
+
+// Picks the player's next action; only ever asked while the fight is still on
+typedef CombatAction (*CombatPolicy)(void* context, const CombatState* state);
+
+//--------------------
+// COMBAT KERNEL FUNCTIONS
+//--------------------
+
+//
+// The combat rules with no I/O: a turn is the player's action, the enemy's reply, status effect
+// ticks on both sides and ability cooldowns, in that order, with every roll drawn from the
+// RandomState passed in. CombatStart is the interactive layer over CombatResolveTurn; a balance
+// run calls CombatResolve with a policy in place of the player.
+//
+// An action the state cannot take (an ability cooling down, an item slot that is empty) resolves
+// as a plain attack. Pass a null log when nothing needs to be shown. CombatResolveTurnFixed plays
+// a turn with chosen roll outcomes in place of the RandomState, for walking every branch of a fight.
+//
+void CombatStateInit(CombatState* state, const Player* player, const Enemy* enemy, const Inventory* inventory);
+void CombatStateApply(const CombatState* state, Player* player, Enemy* enemy);
+bool CombatActionIsValid(const CombatState* state, CombatAction action);
+bool CombatResolveTurn(CombatState* state, CombatAction action, RandomState* random, CombatOutcome* outcome, CombatTurnLog* log);
+bool CombatResolveTurnFixed(CombatState* state, CombatAction action, unsigned int rollOutcomes, CombatRolls* rolls, CombatOutcome* outcome);
+void CombatResolve(CombatState* state, CombatPolicy policy, void* context, RandomState* random, CombatOutcome* outcome);
+CombatAction CombatPolicyAttack(void* context, const CombatState* state);
+CombatAction CombatPolicyGreedy(void* context, const CombatState* state);
+CombatAction CombatPolicyCautious(void* context, const CombatState* state);
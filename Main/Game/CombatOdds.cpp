@@ -0,0 +1,374 @@
+﻿#include "CombatOdds.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#define COMBAT_ODDS_INITIAL_CAPACITY 1024 // NOLINT(modernize-macro-to-enum)
+#define COMBAT_ODDS_BRANCHES (1 << COMBAT_MAX_ROLLS) // NOLINT(modernize-macro-to-enum)
+#define COMBAT_ODDS_INITIAL_FRAMES 64 // NOLINT(modernize-macro-to-enum)
+
+// A state's odds; key 0 marks an empty slot, since a state still being fought has both fighters above 0 health
+typedef struct CombatOddsEntry
+{
+    unsigned long long key;
+    double win;
+    double escape;
+    double defeat;
+    double expectedTurns;
+}CombatOddsEntry;
+
+// A state whose odds are still being gathered: the turns that end the fight are already counted
+// into entry, the ones that go on wait in nextKeys until their own odds are known
+typedef struct CombatOddsFrame
+{
+    CombatOddsEntry entry;
+    unsigned long long nextKeys[COMBAT_ODDS_BRANCHES];
+    double chances[COMBAT_ODDS_BRANCHES];
+    short branchCount;
+    short next; // Branch whose odds are needed next
+}CombatOddsFrame;
+
+typedef struct CombatOddsWalk
+{
+    CombatState base; // The start; a state is this with the health and cooldowns from its key
+    CombatState scratch;
+    CombatPolicy policy;
+    void* context;
+    CombatOddsEntry* table; // Open addressing, capacity a power of two
+    unsigned int capacity;
+    unsigned int count;
+    CombatOddsFrame* frames; // Line of play being walked, kept on the heap rather than the call stack
+    unsigned int frameCapacity;
+}CombatOddsWalk;
+
+//--------------------
+// STATE TABLE
+//--------------------
+
+static unsigned long long CombatOddsKey(const CombatState* state)
+{
+    unsigned long long key = (unsigned long long)(unsigned short)state->player.health |
+        (unsigned long long)(unsigned short)state->enemy.health << 16;
+    for (unsigned short i = 0; i < state->abilityCount; i++)
+    {
+        short cooldown = state->abilities[i].cooldownRemaining > 0 ? state->abilities[i].cooldownRemaining : (short)0;
+        key |= (unsigned long long)cooldown << (32 + 4 * i);
+    }
+    return key;
+}
+
+static void CombatOddsLoad(const CombatOddsWalk* walk, unsigned long long key, CombatState* state)
+{
+    *state = walk->base;
+    state->player.health = (short)(key & 0xFFFF);
+    state->enemy.health = (short)((key >> 16) & 0xFFFF);
+    for (unsigned short i = 0; i < state->abilityCount; i++)
+    {
+        state->abilities[i].cooldownRemaining = (short)((key >> (32 + 4 * i)) & 0xF);
+    }
+}
+
+// The slot holding key, or the empty one it would go in
+static CombatOddsEntry* CombatOddsFind(const CombatOddsWalk* walk, unsigned long long key)
+{
+    unsigned int mask = walk->capacity - 1;
+    unsigned int index = (unsigned int)((key * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+    while (walk->table[index].key != 0 && walk->table[index].key != key)
+    {
+        index = (index + 1) & mask;
+    }
+    return &walk->table[index];
+}
+
+// Keeps the table at most half full
+static bool CombatOddsReserve(CombatOddsWalk* walk)
+{
+    if ((walk->count + 1) * 2 <= walk->capacity) return true;
+    
+    CombatOddsEntry* old = walk->table;
+    unsigned int oldCapacity = walk->capacity;
+    CombatOddsEntry* table = (CombatOddsEntry*)calloc(oldCapacity * 2, sizeof(CombatOddsEntry));
+    if (table == nullptr)
+    {
+        printf("ERROR - Failed to grow the state table in CombatOddsReserve()\n");
+        return false;
+    }
+    walk->table = table;
+    walk->capacity = oldCapacity * 2;
+    for (unsigned int i = 0; i < oldCapacity; i++)
+    {
+        if (old[i].key != 0) *CombatOddsFind(walk, old[i].key) = old[i];
+    }
+    free(old);
+    return true;
+}
+
+//--------------------
+// WALK
+//--------------------
+
+// What a roll of prob really comes out as: CombatChance draws 24 bits u and tests u / 2^24 < prob
+static double CombatOddsChance(float prob)
+{
+    double hits = ceil((double)prob * 16777216.0);
+    if (hits < 0.0) hits = 0.0;
+    if (hits > 16777216.0) hits = 16777216.0;
+    return hits / 16777216.0;
+}
+
+// Rolls out one turn from key into frame
+static void CombatOddsExpand(CombatOddsWalk* walk, unsigned long long key, CombatOddsFrame* frame)
+{
+    CombatOddsEntry entry = {key, 0.0, 0.0, 0.0, 1.0};
+    frame->branchCount = 0;
+    frame->next = 0;
+    
+    CombatOddsLoad(walk, key, &walk->scratch);
+    CombatAction action = walk->policy(walk->context, &walk->scratch);
+    for (unsigned int rolled = 0; rolled < COMBAT_ODDS_BRANCHES; rolled++)
+    {
+        CombatOddsLoad(walk, key, &walk->scratch);
+        CombatRolls rolls;
+        CombatOutcome outcome = {};
+        bool over = CombatResolveTurnFixed(&walk->scratch, action, rolled, &rolls, &outcome);
+        if ((rolled >> rolls.count) != 0) continue; // Set a bit no roll read, same as a smaller value
+        
+        double chance = 1.0;
+        for (short i = 0; i < rolls.count; i++)
+        {
+            double hit = CombatOddsChance(rolls.chances[i]);
+            chance *= ((rolled >> i) & 1) != 0 ? hit : 1.0 - hit;
+        }
+        if (over)
+        {
+            entry.win += outcome.result == COMBAT_VICTORY ? chance : 0.0;
+            entry.escape += outcome.result == COMBAT_ESCAPE ? chance : 0.0;
+            entry.defeat += outcome.result == COMBAT_DEFEAT ? chance : 0.0;
+            continue;
+        }
+        frame->nextKeys[frame->branchCount] = CombatOddsKey(&walk->scratch);
+        frame->chances[frame->branchCount] = chance;
+        frame->branchCount++;
+    }
+    frame->entry = entry;
+}
+
+// Adds the odds of the frame's current branch and moves on to the next
+static void CombatOddsFold(CombatOddsFrame* frame, const CombatOddsEntry* next)
+{
+    double chance = frame->chances[frame->next++];
+    frame->entry.win += chance * next->win;
+    frame->entry.escape += chance * next->escape;
+    frame->entry.defeat += chance * next->defeat;
+    frame->entry.expectedTurns += chance * next->expectedTurns;
+}
+
+// Depth first, one frame per turn of the line being played, so a long fight needs heap, not stack
+static bool CombatOddsPush(CombatOddsWalk* walk, unsigned int depth, unsigned long long key)
+{
+    if (depth >= COMBAT_ODDS_MAX_DEPTH)
+    {
+        printf("ERROR - Fight ran past %d turns in CombatOddsSolve()\n", COMBAT_ODDS_MAX_DEPTH);
+        return false;
+    }
+    if (depth == walk->frameCapacity)
+    {
+        unsigned int capacity = walk->frameCapacity * 2;
+        CombatOddsFrame* frames = (CombatOddsFrame*)realloc(walk->frames, capacity * sizeof(CombatOddsFrame));
+        if (frames == nullptr)
+        {
+            printf("ERROR - Failed to grow the frame stack in CombatOddsSolve()\n");
+            return false;
+        }
+        walk->frames = frames;
+        walk->frameCapacity = capacity;
+    }
+    CombatOddsExpand(walk, key, &walk->frames[depth]);
+    return true;
+}
+
+static bool CombatOddsSolve(CombatOddsWalk* walk, unsigned long long key, CombatOddsEntry* result)
+{
+    if (!CombatOddsPush(walk, 0, key)) return false;
+    unsigned int depth = 1;
+    while (true)
+    {
+        CombatOddsFrame* frame = &walk->frames[depth - 1];
+        if (frame->next < frame->branchCount)
+        {
+            unsigned long long nextKey = frame->nextKeys[frame->next];
+            const CombatOddsEntry* slot = CombatOddsFind(walk, nextKey);
+            if (slot->key == nextKey)
+            {
+                CombatOddsFold(frame, slot);
+                continue;
+            }
+            if (!CombatOddsPush(walk, depth, nextKey)) return false;
+            depth++;
+            continue;
+        }
+        
+        // Every branch is known, so this state's odds are final
+        CombatOddsEntry entry = frame->entry;
+        if (!CombatOddsReserve(walk)) return false;
+        *CombatOddsFind(walk, entry.key) = entry;
+        walk->count++;
+        if (--depth == 0)
+        {
+            *result = entry;
+            return true;
+        }
+        CombatOddsFold(&walk->frames[depth - 1], &entry);
+    }
+}
+
+//--------------------
+// COMBAT ODDS FUNCTIONS
+//--------------------
+
+bool CombatOddsEvaluate(const CombatState* start, CombatPolicy policy, void* context, CombatOdds* odds)
+{
+    if (start == nullptr || policy == nullptr || odds == nullptr)
+    {
+        printf("ERROR - Null argument in CombatOddsEvaluate()\n");
+        return false;
+    }
+    memset(odds, 0, sizeof(CombatOdds));
+    if (start->player.health <= 0 || start->enemy.health <= 0)
+    {
+        printf("ERROR - The fight is already over in CombatOddsEvaluate()\n");
+        return false;
+    }
+    if (start->abilityCount > COMBAT_ODDS_MAX_ABILITIES)
+    {
+        printf("ERROR - More than %d abilities in CombatOddsEvaluate()\n", COMBAT_ODDS_MAX_ABILITIES);
+        return false;
+    }
+    for (unsigned short i = 0; i < start->abilityCount; i++)
+    {
+        if (start->abilities[i].cooldown > COMBAT_ODDS_MAX_COOLDOWN || start->abilities[i].cooldownRemaining > COMBAT_ODDS_MAX_COOLDOWN)
+        {
+            printf("ERROR - Cooldown above %d in CombatOddsEvaluate()\n", COMBAT_ODDS_MAX_COOLDOWN);
+            return false;
+        }
+    }
+    
+    CombatOddsWalk* walk = (CombatOddsWalk*)malloc(sizeof(CombatOddsWalk));
+    if (walk == nullptr)
+    {
+        printf("ERROR - Failed to allocate memory in CombatOddsEvaluate()\n");
+        return false;
+    }
+    walk->base = *start;
+    walk->base.player.statusEffectCount = 0;
+    walk->base.enemy.statusEffectCount = 0;
+    walk->base.itemCount = 0;
+    walk->policy = policy;
+    walk->context = context;
+    walk->capacity = COMBAT_ODDS_INITIAL_CAPACITY;
+    walk->count = 0;
+    walk->table = (CombatOddsEntry*)calloc(walk->capacity, sizeof(CombatOddsEntry));
+    walk->frameCapacity = COMBAT_ODDS_INITIAL_FRAMES;
+    walk->frames = (CombatOddsFrame*)malloc(walk->frameCapacity * sizeof(CombatOddsFrame));
+    
+    CombatOddsEntry entry;
+    bool ok = walk->table != nullptr && walk->frames != nullptr && CombatOddsSolve(walk, CombatOddsKey(&walk->base), &entry);
+    if (ok)
+    {
+        odds->win = entry.win;
+        odds->escape = entry.escape;
+        odds->defeat = entry.defeat;
+        odds->expectedTurns = entry.expectedTurns;
+        odds->states = walk->count;
+    }
+    free(walk->frames);
+    free(walk->table);
+    free(walk);
+    return ok;
+}
+
+// A fresh character at level with the stats PlayerLevelup hands out and every ability unlocked by then
+static void CombatOddsPlayerAtLevel(const GameInstance* game, unsigned short level, Player* player)
+{
+    PlayerInitStats(player);
+    unsigned short levelsGained = (unsigned short)(level - 1);
+    player->level = level;
+    player->maxHealth = (unsigned short)(player->maxHealth + levelsGained * HP_LEVEL_GAIN);
+    player->health = player->maxHealth;
+    player->attack = (unsigned short)(player->attack + levelsGained * ATTACK_LEVEL_GAIN);
+    player->defense = (unsigned short)(player->defense + levelsGained * DEFENCE_LEVEL_GAIN);
+    
+    player->abilityCount = 0;
+    for (unsigned short i = 0; i < game->abilityCount; i++)
+    {
+        if (game->abilityList[i].unlockedAtLevel > level) continue;
+        player->unlockedAbilities[player->abilityCount] = game->abilityList[i];
+        player->unlockedAbilities[player->abilityCount].cooldownRemaining = 0;
+        player->abilityCount++;
+    }
+}
+
+void CombatOddsReport(GameInstance* game, CombatPolicy policy, const char* policyName, unsigned int verifyFights)
+{
+    if (game == nullptr || policy == nullptr)
+    {
+        printf("ERROR - Null argument in CombatOddsReport()\n");
+        return;
+    }
+    Player* player = PlayerCreate();
+    if (player == nullptr) return;
+    
+    printf("Combat odds, %s policy, no items or status effects\n", policyName);
+    printf("%-5s %-18s %5s %5s %8s %8s %8s %7s %7s %8s", "Level", "Enemy", "HP", "Atk", "Win", "Escape", "Defeat",
+           "Turns", "States", "Micros");
+    if (verifyFights > 0) printf(" %9s", "Played");
+    printf("\n");
+    
+    RandomState random;
+    RandomSeed(&random, COMBAT_ODDS_VERIFY_SEED);
+    double totalSeconds = 0.0;
+    unsigned int evaluations = 0;
+    for (unsigned short level = 1; level <= MAX_LEVEL; level++)
+    {
+        CombatOddsPlayerAtLevel(game, level, player);
+        for (short i = 0; i < game->enemyCount; i++)
+        {
+            Enemy enemy = game->enemyList[i];
+            enemy.statusEffectCount = 0;
+            EnemyScaleToLevel(&enemy, level);
+            CombatState start;
+            CombatStateInit(&start, player, &enemy, nullptr);
+            
+            CombatOdds odds;
+            auto begin = std::chrono::steady_clock::now();
+            bool ok = CombatOddsEvaluate(&start, policy, nullptr, &odds);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+            if (!ok) continue;
+            totalSeconds += seconds;
+            evaluations++;
+            
+            printf("%-5hu %-18s %5hd %5hd %7.3f%% %7.3f%% %7.3f%% %7.2f %7u %8.1f", level, StringPoolGet(enemy.name),
+                   enemy.health, enemy.attack, odds.win * 100.0, odds.escape * 100.0, odds.defeat * 100.0,
+                   odds.expectedTurns, odds.states, seconds * 1e6);
+            if (verifyFights > 0)
+            {
+                unsigned int wins = 0;
+                for (unsigned int f = 0; f < verifyFights; f++)
+                {
+                    CombatState state = start;
+                    CombatOutcome outcome;
+                    CombatResolve(&state, policy, nullptr, &random, &outcome);
+                    wins += outcome.result == COMBAT_VICTORY ? 1u : 0u;
+                }
+                printf(" %8.3f%%", wins * 100.0 / verifyFights);
+            }
+            printf("\n");
+        }
+    }
+    if (evaluations > 0)
+    {
+        printf("%u matchups in %.1f ms, %.1f us each\n", evaluations, totalSeconds * 1e3, totalSeconds * 1e6 / evaluations);
+    }
+    PlayerFree(player);
+}
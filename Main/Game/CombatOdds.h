@@ -0,0 +1,46 @@
+﻿#pragma once
+
+#include "CombatKernel.h"
+
+//--------------------
+// COMBAT ODDS CONSTANTS
+//--------------------
+
+#define COMBAT_ODDS_MAX_ABILITIES 8 // Cooldowns take four bits each in the top half of a state's key
+#define COMBAT_ODDS_MAX_COOLDOWN 15 // Largest cooldown four bits hold
+#define COMBAT_ODDS_MAX_DEPTH 4096 // Turns one line of play may run before the walk gives up; frames live on the heap
+#define COMBAT_ODDS_VERIFY_SEED 2024 // NOLINT(modernize-macro-to-enum)
+
+//--------------------
+// COMBAT ODDS STRUCTS
+//--------------------
+
+typedef struct CombatOdds
+{
+    double win;
+    double escape;
+    double defeat;
+    double expectedTurns; // Player actions until the fight ends
+    unsigned int states; // Distinct (player health, enemy health, cooldowns) states the fight can reach
+}CombatOdds;
+
+//--------------------
+// COMBAT ODDS FUNCTIONS
+//--------------------
+
+//
+// Exact outcome odds for a fight, in place of playing it out many times. With items and status
+// effects left out, a turn depends only on both fighters' health and the abilities' cooldowns, and
+// has at most COMBAT_MAX_ROLLS rolls, so the fight is a small Markov chain over those states.
+// CombatOddsEvaluate walks it depth first with CombatResolveTurnFixed, on a stack of its own rather
+// than by recursion, remembering each state's odds, and returns false when the start does not fit
+// the state key.
+//
+// The policy must pick its action from the state alone. Every turn either hurts the enemy or,
+// when an escape fails, the player, so no state comes round again and the walk always ends.
+//
+// CombatOddsReport prints the odds for every enemy in the game at every player level, optionally
+// next to the win rate of that many fights played out with CombatResolve.
+//
+bool CombatOddsEvaluate(const CombatState* start, CombatPolicy policy, void* context, CombatOdds* odds);
+void CombatOddsReport(GameInstance* game, CombatPolicy policy, const char* policyName, unsigned int verifyFights);
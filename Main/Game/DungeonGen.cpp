@@ -0,0 +1,270 @@
+﻿#include "DungeonGen.h"
+#include "DungeonGrid.h"
+#include <cstdio>
+#include <cstring>
+
+static const DungeonGenParams dungeonDefaultParams = {DUNGEON_ROWS, DUNGEON_COLS, 100, 25, 70, 10, 5, 8, 2, 6};
+static const DungeonGenParams dungeonLegacyParams = {DUNGEON_ROWS, DUNGEON_COLS, 100, 100, 70, 10, 5, 8, 1, 0};
+
+//--------------------
+// GENERATOR STAGES
+//--------------------
+
+static void DungeonGenOpenWall(short rows, short cols, unsigned char* exits, short roomIndex, short direction)
+{
+    short next = (short)DungeonGridStep(rows, cols, roomIndex, (Direction)direction);
+    exits[roomIndex] |= (unsigned char)(1 << direction);
+    exits[next] |= (unsigned char)(1 << ((direction + 2) & 3));
+}
+
+// Randomized Prim from the start: open a random wall on the edge of the carved area until enough
+// cells are rooms, then open each wall left between two rooms with the loop chance.
+static void DungeonGenCarve(const DungeonGenParams* params, unsigned int seed, unsigned int attempt, unsigned char* exits)
+{
+    short rows = params->rows;
+    short cols = params->cols;
+    short cellCount = (short)(rows * cols);
+    short target = (short)(cellCount * params->fillPercent / 100);
+    if (target < 2) target = 2;
+    if (target > cellCount) target = cellCount;
+
+    unsigned long long carveSeed = DUNGEON_GEN_CARVE_SALT ^ seed;
+    unsigned long long counter = (unsigned long long)attempt << 32;
+    bool carved[MAX_ROOMS] = {};
+    short walls[MAX_ROOMS * 4]; // Room * 4 + direction, one entry per wall facing rock
+    short wallCount = 0;
+    memset(exits, 0, (size_t)cellCount);
+
+    short carvedCount = 1;
+    carved[0] = true;
+    for (short d = 0; d < 4; d++)
+    {
+        if (DungeonGridStep(rows, cols, 0, (Direction)d) != -1) walls[wallCount++] = d;
+    }
+    while (carvedCount < target && wallCount > 0)
+    {
+        short pick = (short)(RandomHash(carveSeed, counter++) % (unsigned long long)wallCount);
+        short wall = walls[pick];
+        walls[pick] = walls[--wallCount];
+        short next = (short)DungeonGridStep(rows, cols, wall >> 2, (Direction)(wall & 3));
+        if (carved[next]) continue;
+
+        DungeonGenOpenWall(rows, cols, exits, (short)(wall >> 2), (short)(wall & 3));
+        carved[next] = true;
+        carvedCount++;
+        for (short d = 0; d < 4; d++)
+        {
+            int beyond = DungeonGridStep(rows, cols, next, (Direction)d);
+            if (beyond != -1 && !carved[beyond]) walls[wallCount++] = (short)(next * 4 + d);
+        }
+    }
+
+    for (short i = 0; i < cellCount; i++)
+    {
+        for (short d = EAST; d <= SOUTH; d++)
+        {
+            int next = DungeonGridStep(rows, cols, i, (Direction)d);
+            if (next == -1 || !carved[i] || !carved[next] || (exits[i] & (1 << d)) != 0) continue;
+            if (RandomHash(carveSeed, counter++) % 100 < params->loopPercent)
+            {
+                DungeonGenOpenWall(rows, cols, exits, i, d);
+            }
+        }
+    }
+}
+
+// Moves from the start to every cell, 0xFF where no path leads
+static void DungeonGenWalkFromStart(const Dungeon* dungeon, unsigned char* distance)
+{
+    memset(distance, 0xFF, MAX_ROOMS);
+    short queue[MAX_ROOMS];
+    short head = 0;
+    short tail = 0;
+    distance[0] = 0;
+    queue[tail++] = 0;
+    while (head < tail)
+    {
+        short room = queue[head++];
+        DungeonLink links[4];
+        short count = DungeonGetNeighbours(dungeon, room, links);
+        for (short i = 0; i < count; i++)
+        {
+            if (distance[links[i].room] != 0xFF) continue;
+            distance[links[i].room] = (unsigned char)(distance[room] + 1);
+            queue[tail++] = links[i].room;
+        }
+    }
+}
+
+// Returns the boss room, the farthest room with the highest index on ties, or -1 when a room
+// cannot be reached or the boss would be too close
+static short DungeonGenValidate(const Dungeon* dungeon, const DungeonGenParams* params, unsigned char* distance)
+{
+    short cellCount = (short)(params->rows * params->cols);
+    DungeonGenWalkFromStart(dungeon, distance);
+    short bossRoom = 0;
+    for (short i = 0; i < cellCount; i++)
+    {
+        if (!DungeonHasRoom(dungeon, i)) continue;
+        if (distance[i] == 0xFF) return -1;
+        if (distance[i] >= distance[bossRoom]) bossRoom = i;
+    }
+    if (bossRoom == 0 || distance[bossRoom] < params->minBossDistance) return -1;
+    return bossRoom;
+}
+
+// Rooms the player has entered keep their state; the rest are planned from the seed
+static void DungeonGenPlaceEncounters(Dungeon* dungeon, const DungeonGenParams* params)
+{
+    for (short i = 0; i < dungeon->totalRooms; i++)
+    {
+        Room* room = &dungeon->rooms[i];
+        if (RoomIsGenerated(room)) continue;
+
+        EncounterType encounter = EMPTY;
+        bool hasShop = false;
+        if (i == dungeon->bossRoom)
+        {
+            encounter = BOSS;
+        }
+        else if (i != 0 && DungeonHasRoom(dungeon, i))
+        {
+            float roll = (float)(RandomHash(dungeon->seed, (unsigned long long)i) >> 40) * (1.0f / 16777216.0f);
+            encounter = DungeonRollEncounter(roll, params, &hasShop);
+        }
+        room->state = (unsigned char)(encounter | (hasShop ? ROOM_FLAG_SHOP : 0) | (encounter == BOSS ? ROOM_FLAG_BOSS : 0));
+    }
+}
+
+// Tier 0 around the start up to difficultyTiers - 1 at the boss
+static void DungeonGenApplyGradient(Dungeon* dungeon, const DungeonGenParams* params, const unsigned char* distance)
+{
+    int bossDistance = distance[dungeon->bossRoom];
+    for (short i = 0; i < dungeon->totalRooms; i++)
+    {
+        int tier = distance[i] == 0xFF ? 0 : distance[i] * params->difficultyTiers / (bossDistance + 1);
+        dungeon->rooms[i].difficulty = (unsigned char)tier;
+    }
+}
+
+//--------------------
+// DUNGEON GENERATOR FUNCTIONS
+//--------------------
+
+void DungeonGenDefaultParams(DungeonGenParams* params)
+{
+    *params = dungeonDefaultParams;
+}
+
+void DungeonGenLegacyParams(DungeonGenParams* params)
+{
+    *params = dungeonLegacyParams;
+}
+
+bool DungeonGenerate(Dungeon* dungeon, unsigned int seed, const DungeonGenParams* params)
+{
+    if (dungeon == nullptr || params == nullptr)
+    {
+        printf("ERROR - Dungeon or params ptr is null in DungeonGenerate()\n");
+        return false;
+    }
+    if (params->rows <= 0 || params->cols <= 0 || params->rows * params->cols > MAX_ROOMS || params->rows * params->cols < 2 ||
+        params->enemyPercent + params->treasurePercent + params->questPercent + params->shopPercent > 100 ||
+        params->fillPercent > 100 || params->loopPercent > 100 || params->difficultyTiers == 0)
+    {
+        printf("ERROR - Invalid generator params in DungeonGenerate()\n");
+        return false;
+    }
+
+    unsigned char exits[MAX_ROOMS];
+    unsigned char distance[MAX_ROOMS];
+    short bossRoom = -1;
+    for (unsigned int attempt = 0; attempt < DUNGEON_GEN_MAX_ATTEMPTS && bossRoom == -1; attempt++)
+    {
+        DungeonGenCarve(params, seed, attempt, exits);
+        DungeonTopologyInitLinks(&dungeon->topology, params->rows, params->cols, exits);
+        bossRoom = DungeonGenValidate(dungeon, params, distance);
+    }
+    if (bossRoom == -1)
+    {
+        printf("ERROR - No layout met the generator params in %d attempts\n", DUNGEON_GEN_MAX_ATTEMPTS);
+        DungeonBumpGeneration(dungeon); // The failed attempts rewrote the topology
+        return false;
+    }
+
+    dungeon->seed = seed;
+    dungeon->params = *params;
+    dungeon->totalRooms = (short)(params->rows * params->cols);
+    dungeon->bossRoom = bossRoom;
+    DungeonGenPlaceEncounters(dungeon, params);
+    DungeonGenApplyGradient(dungeon, params, distance);
+    DungeonBumpGeneration(dungeon);
+    return true;
+}
+
+void DungeonGenMeasure(const Dungeon* dungeon, DungeonGenMetrics* metrics)
+{
+    memset(metrics, 0, sizeof(DungeonGenMetrics));
+    short links = 0;
+    for (short i = 0; i < dungeon->totalRooms; i++)
+    {
+        if (!DungeonHasRoom(dungeon, i)) continue;
+        DungeonLink exits[4];
+        short exitCount = DungeonGetNeighbours(dungeon, i, exits);
+        const Room* room = &dungeon->rooms[i];
+        metrics->rooms++;
+        links = (short)(links + exitCount);
+        if (exitCount == 1 && i != 0) metrics->deadEnds++;
+        if (RoomGetEncounter(room) == ENEMY) metrics->enemies++;
+        if (RoomHasShop(room)) metrics->shops++;
+    }
+    metrics->loops = (short)(links / 2 - (metrics->rooms - 1));
+
+    unsigned char distance[MAX_ROOMS];
+    DungeonGenWalkFromStart(dungeon, distance);
+    metrics->bossDistance = distance[dungeon->bossRoom] == 0xFF ? -1 : distance[dungeon->bossRoom];
+}
+
+// Encounter for an ordinary room from a roll in [0, 1), split by the params' percentages
+EncounterType DungeonRollEncounter(float roll, const DungeonGenParams* params, bool* hasShop)
+{
+    int threshold = params->enemyPercent;
+    *hasShop = false;
+    if (roll < (float)threshold / 100.0f)
+    {
+        return ENEMY;
+    }
+    threshold += params->treasurePercent;
+    if (roll < (float)threshold / 100.0f)
+    {
+        return TREASURE;
+    }
+    threshold += params->questPercent;
+    if (roll < (float)threshold / 100.0f)
+    {
+        return QUEST;
+    }
+    threshold += params->shopPercent;
+    if (roll < (float)threshold / 100.0f)
+    {
+        *hasShop = true;
+    }
+    return EMPTY;
+}
+
+// Room 0 is the empty start and the last room holds the boss; the rest roll from a hash of (seed, index).
+// The full-grid rule DungeonGrid uses, and the one the legacy params reproduce.
+EncounterType DungeonDeriveEncounter(unsigned long long seed, int roomIndex, int roomCount, bool* hasShop)
+{
+    *hasShop = false;
+    if (roomIndex == 0)
+    {
+        return EMPTY;
+    }
+    if (roomIndex == roomCount - 1)
+    {
+        return BOSS;
+    }
+    float roll = (float)(RandomHash(seed, (unsigned long long)roomIndex) >> 40) * (1.0f / 16777216.0f);
+    return DungeonRollEncounter(roll, &dungeonLegacyParams, hasShop);
+}
@@ -0,0 +1,50 @@
+﻿#pragma once
+
+#include "Game.h"
+
+//--------------------
+// DUNGEON GENERATOR CONSTANTS
+//--------------------
+
+#define DUNGEON_GEN_MAX_ATTEMPTS 16 // NOLINT(modernize-macro-to-enum)
+#define DUNGEON_GEN_CARVE_SALT 0x4341525645000000ull // Keeps carving hashes apart from encounter rolls
+
+//--------------------
+// DUNGEON GENERATOR STRUCTS
+//--------------------
+
+// What a bulk run filters candidate layouts on
+typedef struct DungeonGenMetrics
+{
+    short rooms;
+    short deadEnds; // Rooms with a single exit, the start excluded
+    short loops; // Walls opened beyond a spanning tree
+    short bossDistance;
+    short enemies;
+    short shops;
+}DungeonGenMetrics;
+
+//--------------------
+// DUNGEON GENERATOR FUNCTIONS
+//--------------------
+
+//
+// Builds a dungeon from a seed and a DungeonGenParams in four stages: carve a spanning tree of
+// rooms out of the rows x cols grid and open extra walls into loops, validate that every room is
+// reachable from the start and the boss sits far enough away, place the encounters, then set the
+// difficulty gradient by distance from the start. The boss takes the room farthest from the start.
+//
+// Every random choice is a RandomHash of the seed and a fixed counter, never the game's random
+// stream, so the same seed and params give the same dungeon on any thread. Loading a save runs the
+// generator again rather than storing rooms the player has not entered; rooms already entered
+// keep their state and only get their difficulty back.
+//
+// The legacy params reproduce dungeons from before the generator: a full 7x5 grid, the boss in
+// the last room, 70/10/5/8 encounter shares and no gradient.
+//
+void DungeonGenDefaultParams(DungeonGenParams* params);
+void DungeonGenLegacyParams(DungeonGenParams* params);
+bool DungeonGenerate(Dungeon* dungeon, unsigned int seed, const DungeonGenParams* params);
+void DungeonGenMeasure(const Dungeon* dungeon, DungeonGenMetrics* metrics);
+EncounterType DungeonRollEncounter(float roll, const DungeonGenParams* params, bool* hasShop);
+EncounterType DungeonDeriveEncounter(unsigned long long seed, int roomIndex, int roomCount, bool* hasShop);
@@ -0,0 +1,250 @@
+﻿#include "DungeonGrid.h"
+#include "DungeonGen.h"
+#include <atomic>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+//--------------------
+// GRID ARITHMETIC
+//--------------------
+
+int DungeonGridStep(int rows, int cols, int index, Direction direction)
+{
+    int row = index / cols;
+    int col = index % cols;
+    switch (direction)
+    {
+    case NORTH: return row > 0 ? index - cols : -1;
+    case EAST: return col < cols - 1 ? index + 1 : -1;
+    case SOUTH: return row < rows - 1 ? index + cols : -1;
+    case WEST: return col > 0 ? index - 1 : -1;
+    }
+    return -1;
+}
+
+// Chunk holding a room and the room's offset inside it
+static int DungeonGridLocate(const DungeonGrid* grid, int index, int* cell)
+{
+    int row = index / grid->cols;
+    int col = index % grid->cols;
+    *cell = ((row & (DUNGEON_CHUNK_SIZE - 1)) << DUNGEON_CHUNK_BITS) | (col & (DUNGEON_CHUNK_SIZE - 1));
+    return (row >> DUNGEON_CHUNK_BITS) * grid->chunkCols + (col >> DUNGEON_CHUNK_BITS);
+}
+
+static bool DungeonGridInBounds(const DungeonGrid* grid, int index)
+{
+    return grid != nullptr && index >= 0 && (long long)index < (long long)grid->rows * grid->cols;
+}
+
+//--------------------
+// CHUNK GENERATION
+//--------------------
+
+// Every room comes from DungeonDeriveEncounter, the full-grid rule of the legacy generator params,
+// so a chunk only depends on the seed and its position
+static DungeonChunk* DungeonGridBuildChunk(const DungeonGrid* grid, int chunk)
+{
+    DungeonChunk* built = (DungeonChunk*)calloc(1, sizeof(DungeonChunk));
+    if (built == nullptr)
+    {
+        printf("ERROR - Failed to allocate dungeon chunk %d\n", chunk);
+        return nullptr;
+    }
+
+    int firstRow = (chunk / grid->chunkCols) << DUNGEON_CHUNK_BITS;
+    int firstCol = (chunk % grid->chunkCols) << DUNGEON_CHUNK_BITS;
+    int rowCount = grid->rows - firstRow < DUNGEON_CHUNK_SIZE ? grid->rows - firstRow : DUNGEON_CHUNK_SIZE;
+    int colCount = grid->cols - firstCol < DUNGEON_CHUNK_SIZE ? grid->cols - firstCol : DUNGEON_CHUNK_SIZE;
+    int roomCount = grid->rows * grid->cols;
+
+    for (int r = 0; r < rowCount; r++)
+    {
+        for (int c = 0; c < colCount; c++)
+        {
+            int cell = (r << DUNGEON_CHUNK_BITS) | c;
+            int index = (firstRow + r) * grid->cols + firstCol + c;
+            bool hasShop;
+            EncounterType encounter = DungeonDeriveEncounter(grid->seed, index, roomCount, &hasShop);
+            Room* room = &built->rooms[cell];
+            room->description = DungeonGetRoomDescription(index);
+            room->state = (unsigned char)(encounter | (hasShop ? ROOM_FLAG_SHOP : 0) | (encounter == BOSS ? ROOM_FLAG_BOSS : 0) | ROOM_FLAG_GENERATED);
+            if (index == 0)
+            {
+                built->explored[0] |= 1ull;
+            }
+        }
+    }
+    return built;
+}
+
+static void DungeonGridGenerateWorker(DungeonGrid* grid, std::atomic<int>* next, std::atomic<bool>* failed)
+{
+    int chunkCount = grid->chunkRows * grid->chunkCols;
+    for (int chunk = next->fetch_add(1); chunk < chunkCount; chunk = next->fetch_add(1))
+    {
+        // Each chunk slot is claimed by exactly one worker, so the writes below never overlap
+        if (grid->chunks[chunk] != nullptr) continue;
+        grid->chunks[chunk] = DungeonGridBuildChunk(grid, chunk);
+        if (grid->chunks[chunk] == nullptr) failed->store(true);
+    }
+}
+
+//--------------------
+// DUNGEON GRID FUNCTIONS
+//--------------------
+
+DungeonGrid* DungeonGridCreate(int rows, int cols, unsigned long long seed)
+{
+    if (rows <= 0 || cols <= 0 || (long long)rows * cols > INT_MAX)
+    {
+        printf("ERROR - DungeonGridCreate: invalid size %d x %d\n", rows, cols);
+        return nullptr;
+    }
+
+    DungeonGrid* grid = (DungeonGrid*)malloc(sizeof(DungeonGrid));
+    if (grid == nullptr)
+    {
+        printf("ERROR - Failed to allocate memory for dungeon grid.\n");
+        return nullptr;
+    }
+    grid->rows = rows;
+    grid->cols = cols;
+    grid->chunkRows = (rows + DUNGEON_CHUNK_SIZE - 1) >> DUNGEON_CHUNK_BITS;
+    grid->chunkCols = (cols + DUNGEON_CHUNK_SIZE - 1) >> DUNGEON_CHUNK_BITS;
+    grid->seed = seed;
+    grid->residentChunks = 0;
+    grid->chunks = (DungeonChunk**)calloc((size_t)grid->chunkRows * grid->chunkCols, sizeof(DungeonChunk*));
+    if (grid->chunks == nullptr)
+    {
+        printf("ERROR - Failed to allocate dungeon chunk table.\n");
+        free(grid);
+        return nullptr;
+    }
+    return grid;
+}
+
+void DungeonGridFree(DungeonGrid* grid)
+{
+    if (grid == nullptr) return;
+    int chunkCount = grid->chunkRows * grid->chunkCols;
+    for (int i = 0; i < chunkCount; i++)
+    {
+        free(grid->chunks[i]);
+    }
+    free(grid->chunks);
+    free(grid);
+}
+
+// Materialises every chunk that is not resident yet. Returns the number of chunks built, or -1
+int DungeonGridGenerate(DungeonGrid* grid, unsigned int threadCount)
+{
+    if (grid == nullptr) return -1;
+    int chunkCount = grid->chunkRows * grid->chunkCols;
+    if (threadCount == 0) threadCount = std::thread::hardware_concurrency();
+    if (threadCount == 0) threadCount = 1;
+    if (threadCount > (unsigned int)chunkCount) threadCount = (unsigned int)chunkCount;
+
+    int residentBefore = 0;
+    for (int i = 0; i < chunkCount; i++)
+    {
+        if (grid->chunks[i] != nullptr) residentBefore++;
+    }
+
+    std::atomic<int> next(0);
+    std::atomic<bool> failed(false);
+    std::vector<std::thread> threads;
+    for (unsigned int t = 1; t < threadCount; t++)
+    {
+        threads.emplace_back(DungeonGridGenerateWorker, grid, &next, &failed);
+    }
+    DungeonGridGenerateWorker(grid, &next, &failed);
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    int resident = 0;
+    for (int i = 0; i < chunkCount; i++)
+    {
+        if (grid->chunks[i] != nullptr) resident++;
+    }
+    grid->residentChunks = resident;
+    return failed.load() ? -1 : resident - residentBefore;
+}
+
+// Room at index, building its chunk first if needed. Not safe to call while DungeonGridGenerate runs
+Room* DungeonGridTouch(DungeonGrid* grid, int index)
+{
+    if (!DungeonGridInBounds(grid, index)) return nullptr;
+    int cell;
+    int chunk = DungeonGridLocate(grid, index, &cell);
+    if (grid->chunks[chunk] == nullptr)
+    {
+        grid->chunks[chunk] = DungeonGridBuildChunk(grid, chunk);
+        if (grid->chunks[chunk] == nullptr) return nullptr;
+        grid->residentChunks++;
+    }
+    return &grid->chunks[chunk]->rooms[cell];
+}
+
+// Room at index, or nullptr when its chunk was never touched
+const Room* DungeonGridPeek(const DungeonGrid* grid, int index)
+{
+    if (!DungeonGridInBounds(grid, index)) return nullptr;
+    int cell;
+    int chunk = DungeonGridLocate(grid, index, &cell);
+    return grid->chunks[chunk] != nullptr ? &grid->chunks[chunk]->rooms[cell] : nullptr;
+}
+
+int DungeonGridNeighbour(const DungeonGrid* grid, int index, Direction direction)
+{
+    if (!DungeonGridInBounds(grid, index)) return -1;
+    return DungeonGridStep(grid->rows, grid->cols, index, direction);
+}
+
+// Marks a room explored. Returns true the first time
+bool DungeonGridExplore(DungeonGrid* grid, int index)
+{
+    if (DungeonGridTouch(grid, index) == nullptr) return false;
+    int cell;
+    DungeonChunk* chunk = grid->chunks[DungeonGridLocate(grid, index, &cell)];
+    unsigned long long bit = 1ull << (cell & 63);
+    if ((chunk->explored[cell >> 6] & bit) != 0) return false;
+    chunk->explored[cell >> 6] |= bit;
+    return true;
+}
+
+bool DungeonGridIsExplored(const DungeonGrid* grid, int index)
+{
+    if (DungeonGridPeek(grid, index) == nullptr) return false;
+    int cell;
+    const DungeonChunk* chunk = grid->chunks[DungeonGridLocate(grid, index, &cell)];
+    return (chunk->explored[cell >> 6] >> (cell & 63) & 1) != 0;
+}
+
+long long DungeonGridCountExplored(const DungeonGrid* grid)
+{
+    if (grid == nullptr) return 0;
+    long long count = 0;
+    int chunkCount = grid->chunkRows * grid->chunkCols;
+    for (int i = 0; i < chunkCount; i++)
+    {
+        if (grid->chunks[i] == nullptr) continue;
+        for (short w = 0; w < DUNGEON_CHUNK_EXPLORED_WORDS; w++)
+        {
+            count += CountBits(grid->chunks[i]->explored[w]);
+        }
+    }
+    return count;
+}
+
+size_t DungeonGridMemory(const DungeonGrid* grid)
+{
+    if (grid == nullptr) return 0;
+    return sizeof(DungeonGrid) + (size_t)grid->chunkRows * grid->chunkCols * sizeof(DungeonChunk*) +
+        (size_t)grid->residentChunks * sizeof(DungeonChunk);
+}
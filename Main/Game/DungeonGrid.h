@@ -0,0 +1,61 @@
+﻿#pragma once
+
+#include "Game.h"
+
+//--------------------
+// DUNGEON GRID CONSTANTS
+//--------------------
+
+#define DUNGEON_CHUNK_BITS 5 // NOLINT(modernize-macro-to-enum)
+#define DUNGEON_CHUNK_SIZE (1 << DUNGEON_CHUNK_BITS) // Rooms along each side of a chunk
+#define DUNGEON_CHUNK_ROOMS (DUNGEON_CHUNK_SIZE * DUNGEON_CHUNK_SIZE)
+#define DUNGEON_CHUNK_EXPLORED_WORDS (DUNGEON_CHUNK_ROOMS / 64)
+
+//--------------------
+// DUNGEON GRID STRUCTS
+//--------------------
+
+// A square block of rooms in the same packed form as Dungeon, stored row-major. Every in-bounds
+// neighbour is connected. Rooms past the grid edge stay zeroed and unused.
+typedef struct DungeonChunk
+{
+    Room rooms[DUNGEON_CHUNK_ROOMS];
+    unsigned long long explored[DUNGEON_CHUNK_EXPLORED_WORDS]; // Bit per room
+}DungeonChunk;
+
+typedef struct DungeonGrid
+{
+    int rows;
+    int cols;
+    int chunkRows;
+    int chunkCols;
+    unsigned long long seed;
+    DungeonChunk** chunks; // chunkRows * chunkCols entries, nullptr until a room inside is touched
+    int residentChunks;
+}DungeonGrid;
+
+//--------------------
+// DUNGEON GRID FUNCTIONS
+//--------------------
+
+//
+// Runtime-sized dungeon for maps far larger than MAX_ROOMS. Rooms are numbered row-major like
+// DungeonGetRoomIndex, with room 0 as the start and the last room as the boss. Storage is split
+// into DUNGEON_CHUNK_SIZE square chunks that are only allocated when a room inside them is first
+// touched, so memory follows the explored area instead of the map size. Each room is derived from
+// the grid seed and its index alone (DungeonDeriveEncounter), so generating chunks in any order,
+// on any number of threads, gives the same dungeon.
+//
+// DungeonGridStep is the neighbour arithmetic shared with the fixed 7x5 Dungeon.
+//
+int DungeonGridStep(int rows, int cols, int index, Direction direction);
+DungeonGrid* DungeonGridCreate(int rows, int cols, unsigned long long seed);
+void DungeonGridFree(DungeonGrid* grid);
+int DungeonGridGenerate(DungeonGrid* grid, unsigned int threadCount);
+Room* DungeonGridTouch(DungeonGrid* grid, int index);
+const Room* DungeonGridPeek(const DungeonGrid* grid, int index);
+int DungeonGridNeighbour(const DungeonGrid* grid, int index, Direction direction);
+bool DungeonGridExplore(DungeonGrid* grid, int index);
+bool DungeonGridIsExplored(const DungeonGrid* grid, int index);
+long long DungeonGridCountExplored(const DungeonGrid* grid);
+size_t DungeonGridMemory(const DungeonGrid* grid);
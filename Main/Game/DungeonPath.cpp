@@ -0,0 +1,207 @@
+﻿#include "DungeonPath.h"
+#include <cstdio>
+#include <cstring>
+
+//--------------------
+// FIELD BUILDING
+//--------------------
+
+static void DungeonPathsBuild(DungeonPaths* paths, const Dungeon* dungeon)
+{
+    memset(paths, 0, sizeof(DungeonPaths));
+    memcpy(&paths->topology, &dungeon->topology, sizeof(DungeonTopology));
+    for (short t = 0; t < PATH_TARGET_COUNT; t++)
+    {
+        paths->fields[t].dirty = true;
+    }
+    paths->built = true;
+}
+
+// Rooms join and leave the targets as they are entered and played out; only fields whose
+// targets moved are searched again
+static void DungeonPathsSync(DungeonPaths* paths, const Dungeon* dungeon)
+{
+    if (!paths->built || memcmp(&paths->topology, &dungeon->topology, sizeof(DungeonTopology)) != 0)
+    {
+        DungeonPathsBuild(paths, dungeon);
+    }
+    for (short t = 0; t < PATH_TARGET_COUNT; t++)
+    {
+        DungeonPathField* field = &paths->fields[t];
+        unsigned long long targets[DUNGEON_EXPLORED_WORDS] = {};
+        for (short i = 0; i < MAX_ROOMS; i++)
+        {
+            if (DungeonPathIsTarget(dungeon, (PathTarget)t, i))
+            {
+                targets[i >> 6] |= 1ull << (i & 63);
+            }
+        }
+        if (memcmp(field->targets, targets, sizeof(targets)) != 0)
+        {
+            memcpy(field->targets, targets, sizeof(targets));
+            field->dirty = true;
+        }
+    }
+    paths->generation = dungeon->generation;
+}
+
+// Multi-source search from the targets along links taken in reverse, so every room learns which
+// exit leads one move closer. Ties go to the lower room index, then to the lower direction.
+static void DungeonPathsSearch(const Dungeon* dungeon, DungeonPathField* field)
+{
+    const DungeonTopology* topology = &dungeon->topology;
+    short roomCount = (short)(topology->rows * topology->cols);
+    
+    // Incoming links per room, in the same compressed layout as DungeonTopology
+    unsigned short firstIncoming[MAX_ROOMS + 1] = {};
+    DungeonLink incoming[DUNGEON_MAX_LINKS];
+    DungeonLink links[4];
+    for (short i = 0; i < roomCount; i++)
+    {
+        short count = DungeonTopologyNeighbours(topology, i, links);
+        for (short j = 0; j < count; j++)
+        {
+            firstIncoming[links[j].room + 1]++;
+        }
+    }
+    for (short i = 0; i < roomCount; i++)
+    {
+        firstIncoming[i + 1] = (unsigned short)(firstIncoming[i + 1] + firstIncoming[i]);
+    }
+    unsigned short fill[MAX_ROOMS];
+    memcpy(fill, firstIncoming, sizeof(fill));
+    for (short i = 0; i < roomCount; i++)
+    {
+        short count = DungeonTopologyNeighbours(topology, i, links);
+        for (short j = 0; j < count; j++)
+        {
+            DungeonLink* link = &incoming[fill[links[j].room]++];
+            link->room = i;
+            link->direction = links[j].direction;
+        }
+    }
+    
+    memset(field->distance, PATH_UNREACHABLE, sizeof(field->distance));
+    memset(field->step, -1, sizeof(field->step));
+    short queue[MAX_ROOMS];
+    short head = 0;
+    short tail = 0;
+    for (short i = 0; i < roomCount; i++)
+    {
+        if ((field->targets[i >> 6] >> (i & 63) & 1) != 0)
+        {
+            field->distance[i] = 0;
+            queue[tail++] = i;
+        }
+    }
+    while (head < tail)
+    {
+        short room = queue[head++];
+        for (unsigned short i = firstIncoming[room]; i < firstIncoming[room + 1]; i++)
+        {
+            short from = incoming[i].room;
+            if (field->distance[from] != PATH_UNREACHABLE)
+            {
+                continue;
+            }
+            field->distance[from] = (unsigned char)(field->distance[room] + 1);
+            field->step[from] = (signed char)incoming[i].direction;
+            queue[tail++] = from;
+        }
+    }
+    field->dirty = false;
+}
+
+static DungeonPathField* DungeonPathsGetField(DungeonPaths* paths, const Dungeon* dungeon, PathTarget target)
+{
+    // The stamp changes with every room and layout change, so an unchanged dungeon costs one compare
+    if (!paths->built || paths->generation != dungeon->generation)
+    {
+        DungeonPathsSync(paths, dungeon);
+    }
+    DungeonPathField* field = &paths->fields[target];
+    if (field->dirty)
+    {
+        DungeonPathsSearch(dungeon, field);
+    }
+    return field;
+}
+
+//--------------------
+// DUNGEON PATH FUNCTIONS
+//--------------------
+
+// Only what the player could know: shops in rooms already entered, the boss wherever it waits
+bool DungeonPathIsTarget(const Dungeon* dungeon, PathTarget target, short roomIndex)
+{
+    if (roomIndex >= dungeon->totalRooms || !DungeonHasRoom(dungeon, roomIndex))
+    {
+        return false;
+    }
+    const Room* room = &dungeon->rooms[roomIndex];
+    switch (target)
+    {
+    case PATH_TARGET_BOSS:
+        {
+            return RoomHasBoss(room);
+        }
+    case PATH_TARGET_SHOP:
+        {
+            return RoomIsGenerated(room) && RoomHasShop(room);
+        }
+    case PATH_TARGET_UNEXPLORED:
+        {
+            return !DungeonIsExplored(dungeon, roomIndex);
+        }
+    case PATH_TARGET_COUNT:
+        {
+            break;
+        }
+    }
+    return false;
+}
+
+// Direction of the first move towards the nearest target, or -1 when standing on one or none is reachable
+short DungeonPathNextStep(DungeonPaths* paths, const Dungeon* dungeon, PathTarget target, short roomIndex)
+{
+    if (paths == nullptr || dungeon == nullptr || target < 0 || target >= PATH_TARGET_COUNT || roomIndex < 0 || roomIndex >= MAX_ROOMS)
+    {
+        return -1;
+    }
+    return DungeonPathsGetField(paths, dungeon, target)->step[roomIndex];
+}
+
+// Moves to the nearest target, or -1 when none is reachable
+short DungeonPathDistance(DungeonPaths* paths, const Dungeon* dungeon, PathTarget target, short roomIndex)
+{
+    if (paths == nullptr || dungeon == nullptr || target < 0 || target >= PATH_TARGET_COUNT || roomIndex < 0 || roomIndex >= MAX_ROOMS)
+    {
+        return -1;
+    }
+    unsigned char distance = DungeonPathsGetField(paths, dungeon, target)->distance[roomIndex];
+    return distance == PATH_UNREACHABLE ? -1 : distance;
+}
+
+const char* DungeonPathTargetName(PathTarget target)
+{
+    switch (target)
+    {
+    case PATH_TARGET_BOSS:
+        {
+            return "the boss";
+        }
+    case PATH_TARGET_SHOP:
+        {
+            return "the nearest shop";
+        }
+    case PATH_TARGET_UNEXPLORED:
+        {
+            return "the nearest unexplored room";
+        }
+    case PATH_TARGET_COUNT:
+        {
+            break;
+        }
+    }
+    return "nowhere";
+}
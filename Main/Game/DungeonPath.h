@@ -0,0 +1,29 @@
+﻿#pragma once
+
+#include "Game.h"
+
+//--------------------
+// DUNGEON PATH CONSTANTS
+//--------------------
+
+#define PATH_UNREACHABLE 0xFF // NOLINT(modernize-macro-to-enum)
+
+//--------------------
+// DUNGEON PATH FUNCTIONS
+//--------------------
+
+//
+// Cached distance fields over the dungeon topology, one per PathTarget, so travel and bots get the
+// next step towards the boss, the nearest known shop or the nearest unexplored room without a search.
+// A field is a breadth-first search run backwards from all of its target rooms at once.
+//
+// The cache is owned by the caller (GameInstance::paths) and kept out of the Dungeon, so saves,
+// autosave blocks and checkpoints never carry it. A query is O(1) while Dungeon::generation matches
+// the one the cache last saw. Every room or layout change bumps it (DungeonBumpGeneration); the next
+// query then checks the targets again, drops every field if the topology changed, and searches a
+// field again only when a room joined or left its targets.
+//
+bool DungeonPathIsTarget(const Dungeon* dungeon, PathTarget target, short roomIndex);
+short DungeonPathNextStep(DungeonPaths* paths, const Dungeon* dungeon, PathTarget target, short roomIndex);
+short DungeonPathDistance(DungeonPaths* paths, const Dungeon* dungeon, PathTarget target, short roomIndex);
+const char* DungeonPathTargetName(PathTarget target);
@@ -1,13 +1,118 @@
 ﻿#include "Game.h"
+#include "CombatKernel.h"
+#include "DungeonGen.h"
+#include "DungeonGrid.h"
+#include "DungeonPath.h"
+#include "../Save/Autosave.h"
+#include "../Save/Journal.h"
+#include "../Save/Save.h"
+#include "../UI/Input.h"
 #include "../UI/UI.h"
+#include <atomic>
 #include <cstdlib>
 #include <cstring>
+#include <mutex>
+
+// Game being played on this thread. Random rolls and item IDs come from its state,
+// so independent games can run on separate threads without sharing anything.
+static thread_local GameInstance* currentGame = nullptr;
+static thread_local RandomState fallbackRandom;
+static thread_local bool fallbackRandomSeeded = false;
+static thread_local short fallbackNextItemID = 1000;
+
+static RandomState* RandomGetCurrent();
+static bool FileReadTopology(FILE* file, char* buffer, DungeonTopology* topology);
+
+static const char* ROOM_DESCRIPTIONS[20] =
+    {
+    "A dark corridor with stone walls",
+    "A musty chamber filled with cobwebs",
+    "A huge hall with ancient pillars",
+    "A narrow passage with dripping water",
+    "A circular room with mysterious runes",
+    "A dusty library with old tombs",
+    "An armoury with rusty weapons",
+    "A torture chamber with old equipment",
+    "A throne room in ruins",
+    "A chapel with broken statues",
+    "A treasury vault which is empty",
+    "A kitchen with rotting food",
+    "A bedroom with tattered curtains",
+    "A study with scattered papers",
+    "A laboratory with strange equipments",
+    "A prison with empty cells and some skeleton ruins",
+    "A garden overgrown with weeds",
+    "A fountain room with stagnant water",
+    "A war room filled with faded maps",
+    "A crypt with ancient tombs"
+    };
+
+static const char* ENEMY_NAMES[5] = { "Goblin", "Skelly", "Omen", "Banished Knight", "Elden Beast" };
+
+static const char* ITEM_RARITY_PREFIXES[4] = {"Rusty", "Fine", "Masterwork", "Legendary"};
+static const char* WEAPON_NAMES[5] = {"Sword", "Axe", "Mace", "Dagger", "Spear"};
+static const char* ARMOR_NAMES[5] = {"Helmet", "Chestplate", "Gauntlets", "Boots", "Shield"};
+static const char* POTION_NAMES[4] = {"Health Potion", "Healing Elixir", "Life Flask", "Restoration Brew"};
+
+// String pool handles for the text above, filled once by GameInitStrings and read-only afterwards
+static std::once_flag gameStringsOnce;
+static StringID roomDescriptionIDs[20];
+static StringID emptyRoomDescriptionID;
+static StringID enemyNameIDs[5];
+static StringID eliteEnemyNameIDs[5];
+static StringID itemNameIDs[3][4][5]; // [type][rarity][variant]; potions have one name per rarity
+static StringID itemDescriptionIDs[3]; // Formats of generated items, by type
+static StringID itemCreateDescriptionIDs[3]; // Formats used by ItemCreate, by type
+
 //--------------------
 // GAME FUNCTIONS
 //--------------------
 
+// Interns every fixed piece of game text, so generating rooms, enemies and items only copies
+// handles. Safe to call from any thread; only the first call does the work.
+void GameInitStrings()
+{
+    std::call_once(gameStringsOnce, []
+    {
+        for (short i = 0; i < 20; i++)
+        {
+            roomDescriptionIDs[i] = StringPoolIntern(ROOM_DESCRIPTIONS[i]);
+        }
+        emptyRoomDescriptionID = StringPoolIntern("An empty room");
+
+        char buffer[MAX_NAME_LENGTH];
+        for (short i = 0; i < 5; i++)
+        {
+            enemyNameIDs[i] = StringPoolIntern(ENEMY_NAMES[i]);
+            sprintf_s(buffer, sizeof(buffer), "Elite %s", ENEMY_NAMES[i]);
+            eliteEnemyNameIDs[i] = StringPoolIntern(buffer);
+        }
+
+        for (short rarity = 0; rarity < 4; rarity++)
+        {
+            for (short variant = 0; variant < 5; variant++)
+            {
+                sprintf_s(buffer, sizeof(buffer), "%s %s", ITEM_RARITY_PREFIXES[rarity], WEAPON_NAMES[variant]);
+                itemNameIDs[WEAPON][rarity][variant] = StringPoolIntern(buffer);
+                sprintf_s(buffer, sizeof(buffer), "%s %s", ITEM_RARITY_PREFIXES[rarity], ARMOR_NAMES[variant]);
+                itemNameIDs[ARMOR][rarity][variant] = StringPoolIntern(buffer);
+                itemNameIDs[POTION][rarity][variant] = StringPoolIntern(POTION_NAMES[rarity]);
+            }
+        }
+
+        itemDescriptionIDs[WEAPON] = StringPoolInternFormat("A weapon that increases attack by %d");
+        itemDescriptionIDs[ARMOR] = StringPoolInternFormat("Armor that increases defense by %d");
+        itemDescriptionIDs[POTION] = StringPoolInternFormat("Restores %d health");
+        itemCreateDescriptionIDs[WEAPON] = StringPoolInternFormat("A weapon that increases attack by %d.");
+        itemCreateDescriptionIDs[ARMOR] = StringPoolInternFormat("Armor that increases defense by %d.");
+        itemCreateDescriptionIDs[POTION] = StringPoolInternFormat("A Potion that increases %d health.");
+    });
+}
+
 GameInstance* GameInit()
 {
+    GameInitStrings();
+
     GameInstance* game = (GameInstance*)malloc(sizeof(GameInstance));
     if (game == nullptr)
     {
@@ -32,6 +137,10 @@ GameInstance* GameInit()
     game->enemyCount = 0;
     game->abilityCount = 0;
     game->shop = nullptr;
+    game->nextItemID = 1000;
+    game->autosave = nullptr;
+    memset(&game->paths, 0, sizeof(DungeonPaths));
+    GameSetSeed(game, 1);
     
 
     GameInitializeEnemies(game);
@@ -41,8 +150,34 @@ GameInstance* GameInit()
     
 }
 
+void GameSetSeed(GameInstance* game, unsigned long long seed)
+{
+    if (game == nullptr) return;
+    RandomSeed(&game->random, seed);
+}
+
+void GameMakeCurrent(GameInstance* game)
+{
+    currentGame = game;
+}
+
+// While the player thinks: search any travel route a move made stale, so option 9 answers at once
+static void GameIdle(void* context)
+{
+    GameInstance* game = (GameInstance*)context;
+    if (game->dungeon == nullptr || game->player == nullptr) return;
+    short room = (short)game->player->currentRoom;
+    for (int target = 0; target < PATH_TARGET_COUNT; target++)
+    {
+        DungeonPathDistance(&game->paths, game->dungeon, (PathTarget)target, room);
+    }
+}
+
 void GameRun(GameInstance* game)
 {
+    GameMakeCurrent(game);
+    // Simulation workers run games headless on their own threads and never wait for input
+    if (!UI::UI_IsHeadless()) InputSetIdleHandler(GameIdle, game);
     while (game->isRunning)
     {
         CLEAR_SCREEN();
@@ -70,15 +205,24 @@ void GameRun(GameInstance* game)
                 UI::UI_DisplayInfoMessage("Generating Dungeon...");
                 UI::UI_DisplayLoadingBar();
                 game->dungeon = DungeonInit();
-                DungeonGenerateRooms(game->dungeon);
-                DungeonGenerateConnections(game->dungeon);
+                if (!DungeonGenerateRooms(game->dungeon))
+                {
+                    UI::UI_DisplayErrorMessage("Failed to generate the dungeon!");
+                    UI::UI_TimedPause(1500);
+                    free(game->dungeon);
+                    game->dungeon = nullptr;
+                    free(game->player);
+                    game->player = nullptr;
+                    game->currentState = MAIN_MENU;
+                    break;
+                }
                 
                 game->questLog = QuestInit();
                 game->inventory = InventoryCreate();
                 
                 QuestGenerate(game->questLog, game->player->level);
                 
-                game->dungeon->rooms[0].explored = true;
+                DungeonSetExplored(game->dungeon, 0);
                 game->player->currentRoom = 0;
                 game->currentState = GAME_LOOP;
                 break;
@@ -87,6 +231,9 @@ void GameRun(GameInstance* game)
             {
                 UI::UI_DisplayInfoMessage("Loading Saved Data..");
                 UI::UI_DisplayLoadingBar();
+                // The writer must be done with the files before they are read, and must not save over them afterwards
+                AutosaveStop(game->autosave);
+                game->autosave = nullptr;
                 if (game->player != nullptr) { free(game->player); game->player = nullptr; }
                 if (game->inventory != nullptr) { InventoryFree(game->inventory); game->inventory = nullptr; }
                 if (game->questLog != nullptr) { free(game->questLog); game->questLog = nullptr; }
@@ -95,49 +242,18 @@ void GameRun(GameInstance* game)
 
                 Dungeon* d = nullptr;
 
-
                 if (FileLoadGame(&game->player, &game->inventory, &game->questLog, (GameStatistics**)&game->stats, &d))
                 {
-                    if (d != nullptr)
-                    {
-                        DungeonGenerateConnections(d);
-                        // ADD THIS: Regenerate room descriptions
-                        const char* roomDescriptions[20] = {
-                            "A dark corridor with stone walls",
-                            "A musty chamber filled with cobwebs",
-                            "A huge hall with ancient pillars",
-                            "A narrow passage with dripping water",
-                            "A circular room with mysterious runes",
-                            "A dusty library with old tombs",
-                            "An armoury with rusty weapons",
-                            "A torture chamber with old equipment",
-                            "A throne room in ruins",
-                            "A chapel with broken statues",
-                            "A treasury vault which is empty",
-                            "A kitchen with rotting food",
-                            "A bedroom with tattered curtains",
-                            "A study with scattered papers",
-                            "A laboratory with strange equipments",
-                            "A prison with empty cells and some skeleton ruins",
-                            "A garden overgrown with weeds",
-                            "A fountain room with stagnant water",
-                            "A war room filled with faded maps",
-                            "A crypt with ancient tombs"
-                        };
-        
-                        for (short i = 0; i < d->totalRooms; i++)
-                        {
-                            strcpy_s(d->rooms[i].description, 
-                                     sizeof(d->rooms[i].description), 
-                                     roomDescriptions[i % 20]);
-                        }
-                    }
                     game->dungeon = d;
                     game->currentState = GAME_LOOP;
                 }
                 else
                 {
                     if (d != nullptr) free(d);
+                    if (game->stats == nullptr)
+                    {
+                        game->stats = (GameStats*)calloc(1, sizeof(GameStats));
+                    }
                     UI::UI_DisplayErrorMessage("Failed to load savegame!");
                     UI::UI_TimedPause(1500);
                     game->currentState = MAIN_MENU;
@@ -176,6 +292,7 @@ void GameRun(GameInstance* game)
             }
         }
     }
+    if (!UI::UI_IsHeadless()) InputSetIdleHandler(nullptr, nullptr);
 }
 
 void GameFree(GameInstance* game)
@@ -184,6 +301,12 @@ void GameFree(GameInstance* game)
     {
         return;
     }
+    if (currentGame == game)
+    {
+        GameMakeCurrent(nullptr);
+    }
+    AutosaveStop(game->autosave); // Finishes any save still in flight
+    game->autosave = nullptr;
     if (game->player != nullptr)
     {
         //PlayerFree(game->player);
@@ -197,14 +320,7 @@ void GameFree(GameInstance* game)
     }
     if (game->inventory != nullptr)
     {
-        InventoryNode* curr = game->inventory->head;
-        while (curr != nullptr)
-        {
-            InventoryNode* temp = curr;
-            curr = curr->next;
-            free(temp);
-        }
-        free(game->inventory);
+        InventoryFree(game->inventory);
         game->inventory = nullptr;
     }
     if (game->questLog != nullptr)
@@ -370,11 +486,11 @@ void GameHandleGameLoop(GameInstance* game)
     PlayerDisplayStatusBar(game->player);
     
     unsigned short currentRoom = game->player->currentRoom;
-    if (game->dungeon->rooms[currentRoom].hasBoss)
+    if (RoomHasBoss(&game->dungeon->rooms[currentRoom]))
     {
         UI::UI_DisplayWarningMessage("You sense a powerful presence ahead..");
     }
-    if (game->dungeon->rooms[currentRoom].hasShop)
+    if (RoomHasShop(&game->dungeon->rooms[currentRoom]))
     {
         UI::UI_DisplayInfoMessage("You see a merchant here!");
         printf("Press 'S' to visit the shop.\n");
@@ -388,7 +504,7 @@ void GameHandleGameLoop(GameInstance* game)
         {
             Direction direction = UI::UI_GetDirectionInput();
             DungeonMoveToRoom(game->player, game->dungeon, direction);
-            game->dungeon->rooms[game->player->currentRoom].explored = true;
+            DungeonSetExplored(game->dungeon, game->player->currentRoom);
             GameHandleEncounter(game);
             break;
         }
@@ -411,9 +527,7 @@ void GameHandleGameLoop(GameInstance* game)
                 if (invChoice == 'U' || invChoice == 'u')
                 {
                     printf("Enter item ID to use: ");
-                    short itemID;
-                    scanf_s("%hd", &itemID);
-                    while (getchar() != '\n') {}
+                    short itemID = UI::UI_GetNumberInput();
                     InventoryUseItem(game->inventory, game->player, itemID);
                 }
             }
@@ -455,7 +569,7 @@ void GameHandleGameLoop(GameInstance* game)
     case '7':
         {
             CLEAR_SCREEN();
-            if (FileSaveGame(game->player, game->inventory, game->questLog, game->stats, game->dungeon))
+            if (GameSave(game))
             {
                 UI::UI_DisplaySuccessMessage("Game saved successfully!");
             }
@@ -471,10 +585,15 @@ void GameHandleGameLoop(GameInstance* game)
             game->currentState = PAUSE_MENU;
             break;
         }
+    case '9':
+        {
+            GameAutoTravel(game, DungeonGetTravelTargetInput());
+            break;
+        }
     case 's':
     case 'S':
         {
-            if (game->dungeon->rooms[currentRoom].hasShop)
+            if (RoomHasShop(&game->dungeon->rooms[currentRoom]))
             {
                 if (game->shop == nullptr)
                 {
@@ -518,6 +637,10 @@ void GameHandleGameLoop(GameInstance* game)
     {
         game->currentState = GAME_OVER;
     }
+    else if (!GameAutosave(game))
+    {
+        UI::UI_DisplayWarningMessage("Autosave failed!");
+    }
 }
 
 void GameHandlePauseMenu(GameInstance* game)
@@ -578,9 +701,7 @@ void GameHandlePauseMenu(GameInstance* game)
                     if (invChoice == 'U' || invChoice == 'u')
                     {
                         printf("Enter item ID to use: ");
-                        short itemID;
-                        scanf_s("%hd", &itemID);
-                        while (getchar() != '\n') {}
+                        short itemID = UI::UI_GetNumberInput();
                         InventoryUseItem(game->inventory, game->player, itemID);
                     }
                 }
@@ -622,7 +743,7 @@ void GameHandlePauseMenu(GameInstance* game)
         case 7: // Save Game
             {
                 CLEAR_SCREEN();
-                if (FileSaveGame(game->player, game->inventory, game->questLog, game->stats, game->dungeon))
+                if (GameSave(game))
                 {
                     UI::UI_DisplaySuccessMessage("Game saved successfully!");
                 }
@@ -673,6 +794,10 @@ void GameHandlePauseMenu(GameInstance* game)
                 {
                     inPauseMenu = false;
                     
+                    // Stop autosaving first, or the next game's turns would be saved over this one
+                    AutosaveStop(game->autosave);
+                    game->autosave = nullptr;
+                    
                     // Clean up current game state
                     if (game->player != nullptr)
                     {
@@ -791,7 +916,7 @@ GameStatus GameCheckGameStatus(GameInstance* game)
             CLEAR_SCREEN();
             UI::UI_DisplaySuccessMessage("You found a treasure chest!");
             ItemData treasure = ItemGenerateTreasure(game->player->level);
-            printf("You found: %s\n", treasure.name);
+            printf("You found: %s\n", StringPoolGet(treasure.name));
             ItemDisplay(&treasure);
             
             // Inventory Management goes here
@@ -858,9 +983,9 @@ void GameHandleEncounter(GameInstance* game)
     
     unsigned short currentRoom = game->player->currentRoom;
     Room* room = &game->dungeon->rooms[currentRoom];
-    EncounterType encounter = room->encounterType;
+    EncounterType encounter = RoomGetEncounter(room);
     
-    room->explored = true;
+    DungeonSetExplored(game->dungeon, currentRoom);
     
     switch (encounter)
     {
@@ -872,7 +997,7 @@ void GameHandleEncounter(GameInstance* game)
         }
     case ENEMY:
         {
-            Enemy* enemy = EnemyGenerateForLevel(game, game->player->level);
+            Enemy* enemy = EnemyGenerateForLevel(game, (unsigned short)(game->player->level + room->difficulty));
             if (enemy != nullptr)
             {
                 CLEAR_SCREEN();
@@ -889,7 +1014,8 @@ void GameHandleEncounter(GameInstance* game)
                 case COMBAT_VICTORY:
                     {
                         CombatAwardVictory(game->player, enemy, game);
-                        room->encounterType = EMPTY;
+                        RoomSetEncounter(room, EMPTY);
+                        DungeonBumpGeneration(game->dungeon);
                         
                         // Update quest progress for killing enemies
                         if (game->questLog != nullptr)
@@ -933,7 +1059,8 @@ void GameHandleEncounter(GameInstance* game)
             else
             {
                 UI::UI_DisplayErrorMessage("Failed to generate enemy!");
-                room->encounterType = EMPTY;
+                RoomSetEncounter(room, EMPTY);
+                DungeonBumpGeneration(game->dungeon);
             }
             break;
         }
@@ -964,7 +1091,7 @@ void GameHandleEncounter(GameInstance* game)
                 printf("%s", MAGENTA);
                 break;
             }
-            printf("%s%s\n\n", treasure.name, RESET);
+            printf("%s%s\n\n", StringPoolGet(treasure.name), RESET);
             
             ItemDisplay(&treasure);
             printf("\n");
@@ -1004,9 +1131,7 @@ void GameHandleEncounter(GameInstance* game)
                         CLEAR_SCREEN();
                         InventoryDisplay(game->inventory);
                         printf("\nEnter item ID to drop (0 to cancel): ");
-                        short dropID;
-                        scanf_s("%hd", &dropID);
-                        while (getchar() != '\n') {}
+                        short dropID = UI::UI_GetNumberInput();
                         
                         if (dropID != 0)
                         {
@@ -1048,7 +1173,8 @@ void GameHandleEncounter(GameInstance* game)
             
             printf("\n%sYou also found %hu gold!%s\n", YELLOW, bonusGold, RESET);
             
-            room->encounterType = EMPTY;
+            RoomSetEncounter(room, EMPTY);
+            DungeonBumpGeneration(game->dungeon);
             UI::UI_PauseScreen();
             break;
         }
@@ -1097,7 +1223,8 @@ void GameHandleEncounter(GameInstance* game)
                 UI::UI_DisplayInfoMessage("Nothing of interest here...");
             }
             
-            room->encounterType = EMPTY;
+            RoomSetEncounter(room, EMPTY);
+            DungeonBumpGeneration(game->dungeon);
             UI::UI_PauseScreen();
             break;
         }
@@ -1120,8 +1247,9 @@ void GameHandleEncounter(GameInstance* game)
             if (boss == nullptr)
             {
                 printf("ERROR - Failed to generate boss enemy.\n");
-                room->encounterType = EMPTY;
-                room->hasBoss = false;
+                RoomSetEncounter(room, EMPTY);
+                RoomSetBoss(room, false);
+                DungeonBumpGeneration(game->dungeon);
                 return;
             }
             
@@ -1135,11 +1263,9 @@ void GameHandleEncounter(GameInstance* game)
             boss->lootRarity = LEGENDARY;
             
             // Give the boss a special name
-            char bossName[MAX_NAME_LENGTH];
-            sprintf_s(bossName, sizeof(bossName), "Elite %s", boss->name);
-            strcpy_s(boss->name, sizeof(boss->name), bossName);
+            if (boss->enemyID >= 0 && boss->enemyID < 5) boss->name = eliteEnemyNameIDs[boss->enemyID];
             
-            printf("%s=== %s ===%s\n\n", MAGENTA, boss->name, RESET);
+            printf("%s=== %s ===%s\n\n", MAGENTA, StringPoolGet(boss->name), RESET);
             EnemyDisplayStats(boss);
             
             printf("\n");
@@ -1190,11 +1316,12 @@ void GameHandleEncounter(GameInstance* game)
                         UI::UI_DisplayWarningMessage("Inventory full! Legendary item lost!");
                     }
                     
-                    room->encounterType = EMPTY;
-                    room->hasBoss = false;
+                    RoomSetEncounter(room, EMPTY);
+                    RoomSetBoss(room, false);
+                    DungeonBumpGeneration(game->dungeon);
                     
                     // Check for game victory condition
-                    if (currentRoom == MAX_ROOMS - 1)
+                    if (currentRoom == game->dungeon->bossRoom)
                     {
                         printf("\n");
                         UI::UI_DisplaySuccessMessage("You have conquered the dungeon!");
@@ -1245,6 +1372,50 @@ void GameHandleEncounter(GameInstance* game)
     }
 }
 
+// Walks towards the target a room at a time, playing each room out on the way. Stops on arrival,
+// in any room not explored before, or when a defeat sends the player back to the entrance.
+void GameAutoTravel(GameInstance* game, PathTarget target)
+{
+    if (game == nullptr || game->player == nullptr || game->dungeon == nullptr)
+    {
+        printf("ERROR - GameAutoTravel: game is null\n");
+        return;
+    }
+    Dungeon* dungeon = game->dungeon;
+    short distance = DungeonPathDistance(&game->paths, dungeon, target, (short)game->player->currentRoom);
+    if (distance == -1)
+    {
+        UI::UI_DisplayWarningMessage("You know of no way there!");
+        UI::UI_TimedPause(1000);
+        return;
+    }
+    if (distance == 0)
+    {
+        UI::UI_DisplayInfoMessage("You are already there.");
+        UI::UI_TimedPause(1000);
+        return;
+    }
+    
+    printf("Travelling to %s (%hd rooms away)...\n", DungeonPathTargetName(target), distance);
+    while (game->currentState == GAME_LOOP)
+    {
+        short step = DungeonPathNextStep(&game->paths, dungeon, target, (short)game->player->currentRoom);
+        if (step == -1)
+        {
+            break;
+        }
+        short nextRoom = DungeonGetConnection(dungeon, (short)game->player->currentRoom, (Direction)step);
+        bool wasExplored = DungeonIsExplored(dungeon, nextRoom);
+        DungeonMoveToRoom(game->player, dungeon, (Direction)step);
+        DungeonSetExplored(dungeon, nextRoom);
+        GameHandleEncounter(game);
+        if (!wasExplored || game->player->currentRoom != (unsigned short)nextRoom)
+        {
+            break;
+        }
+    }
+}
+
 void GameInitializeEnemies(GameInstance* game)
 {
     game->enemyCount = 5;
@@ -1253,12 +1424,7 @@ void GameInitializeEnemies(GameInstance* game)
     // Enemy 0: Goblin 
     //-----------------
     game->enemyList[0].enemyID = 0;
-    errno_t err = strcpy_s(game->enemyList[0].name, sizeof(game->enemyList[0].name), "Goblin");
-    if (err != 0)
-    {
-        UI::UI_DisplayErrorMessage("Failed to copy enemy name[0] -> Goblin");
-        printf("\n");
-    }
+    game->enemyList[0].name = enemyNameIDs[0];
     game->enemyList[0].baseHealth = 30;
     game->enemyList[0].attack = 8;
     game->enemyList[0].defense = 3;
@@ -1272,12 +1438,7 @@ void GameInitializeEnemies(GameInstance* game)
     // Enemy 1: Skelly
     //-----------------
     game->enemyList[1].enemyID = 1;
-    err = strcpy_s(game->enemyList[1].name, sizeof(game->enemyList[1].name), "Skelly");
-    if (err != 0)
-    {
-        UI::UI_DisplayErrorMessage("Failed to copy enemy name[1] -> Skelly");
-        printf("\n");
-    }
+    game->enemyList[1].name = enemyNameIDs[1];
     game->enemyList[1].baseHealth = 40;
     game->enemyList[1].attack = 12;
     game->enemyList[1].defense = 5;
@@ -1291,12 +1452,7 @@ void GameInitializeEnemies(GameInstance* game)
     // Enemy 2: Omen
     //-----------------
     game->enemyList[2].enemyID = 2;
-    err = strcpy_s(game->enemyList[2].name, sizeof(game->enemyList[2].name), "Omen");
-    if (err != 0)
-    {
-        UI::UI_DisplayErrorMessage("Failed to copy enemy name[2] -> Omen");
-        printf("\n");
-    }
+    game->enemyList[2].name = enemyNameIDs[2];
     game->enemyList[2].baseHealth = 60;
     game->enemyList[2].attack = 15;
     game->enemyList[2].defense = 8;
@@ -1310,12 +1466,7 @@ void GameInitializeEnemies(GameInstance* game)
     // Enemy 3: Banished Knight
     //-----------------
     game->enemyList[3].enemyID = 3;
-    err = strcpy_s(game->enemyList[3].name, sizeof(game->enemyList[3].name), "Banished Knight");
-    if (err != 0)
-    {
-        UI::UI_DisplayErrorMessage("Failed to copy enemy name[3] -> Banished Knight");
-        printf("\n");
-    }
+    game->enemyList[3].name = enemyNameIDs[3];
     game->enemyList[3].baseHealth = 80;
     game->enemyList[3].attack = 20;
     game->enemyList[3].defense = 12;
@@ -1329,12 +1480,7 @@ void GameInitializeEnemies(GameInstance* game)
     // Enemy 4: Elden Beast
     //-----------------
     game->enemyList[4].enemyID = 4;
-    err = strcpy_s(game->enemyList[4].name, sizeof(game->enemyList[4].name), "Elden Beast");
-    if (err != 0)
-    {
-        UI::UI_DisplayErrorMessage("Failed to copy enemy name[4] -> Elden Beast");
-        printf("\n");
-    }
+    game->enemyList[4].name = enemyNameIDs[4];
     game->enemyList[4].baseHealth = 120;
     game->enemyList[4].attack = 30;
     game->enemyList[4].defense = 18;
@@ -1359,9 +1505,8 @@ void GameInitializeAbilities(GameInstance* game)
     // ABILITY 1: Power Strike (Level 2)
     // ==================================
     game->abilityList[0].abilityId = 1;
-    strcpy_s(game->abilityList[0].name, sizeof(game->abilityList[0].name), "Power Strike");
-    strcpy_s(game->abilityList[0].description, sizeof(game->abilityList[0].description), 
-             "A powerful attack dealing 1.5x damage");
+    game->abilityList[0].name = StringPoolIntern("Power Strike");
+    game->abilityList[0].description = StringPoolIntern("A powerful attack dealing 1.5x damage");
     game->abilityList[0].unlockedAtLevel = 2;
     game->abilityList[0].damageMultiplier = 1.5f;
     game->abilityList[0].cooldown = 2;
@@ -1371,9 +1516,8 @@ void GameInitializeAbilities(GameInstance* game)
     // ABILITY 2: Double Slash (Level 4)
     // ==================================
     game->abilityList[1].abilityId = 2;
-    strcpy_s(game->abilityList[1].name, sizeof(game->abilityList[1].name), "Double Slash");
-    strcpy_s(game->abilityList[1].description, sizeof(game->abilityList[1].description), 
-             "Strike twice dealing normal damage each hit");
+    game->abilityList[1].name = StringPoolIntern("Double Slash");
+    game->abilityList[1].description = StringPoolIntern("Strike twice dealing normal damage each hit");
     game->abilityList[1].unlockedAtLevel = 4;
     game->abilityList[1].damageMultiplier = 1.0f;
     game->abilityList[1].cooldown = 3;
@@ -1383,9 +1527,8 @@ void GameInitializeAbilities(GameInstance* game)
     // ABILITY 3: Life Drain (Level 5)
     // ===============================
     game->abilityList[2].abilityId = 3;
-    strcpy_s(game->abilityList[2].name, sizeof(game->abilityList[2].name), "Life Drain");
-    strcpy_s(game->abilityList[2].description, sizeof(game->abilityList[2].description), 
-             "Attack that heals you for 50% of damage dealt");
+    game->abilityList[2].name = StringPoolIntern("Life Drain");
+    game->abilityList[2].description = StringPoolIntern("Attack that heals you for 50% of damage dealt");
     game->abilityList[2].unlockedAtLevel = 5;
     game->abilityList[2].damageMultiplier = 1.2f;
     game->abilityList[2].cooldown = 4;
@@ -1395,9 +1538,8 @@ void GameInitializeAbilities(GameInstance* game)
     // ABILITY 4: Whirlwind (Level 7)
     // ==============================
     game->abilityList[3].abilityId = 4;
-    strcpy_s(game->abilityList[3].name, sizeof(game->abilityList[3].name), "Whirlwind");
-    strcpy_s(game->abilityList[3].description, sizeof(game->abilityList[3].description), 
-             "Spinning attack dealing 2x damage");
+    game->abilityList[3].name = StringPoolIntern("Whirlwind");
+    game->abilityList[3].description = StringPoolIntern("Spinning attack dealing 2x damage");
     game->abilityList[3].unlockedAtLevel = 7;
     game->abilityList[3].damageMultiplier = 2.0f;
     game->abilityList[3].cooldown = 5;
@@ -1407,9 +1549,8 @@ void GameInitializeAbilities(GameInstance* game)
     // ABILITY 5: Devastating Blow (Level 9)
     // ========================================
     game->abilityList[4].abilityId = 5;
-    strcpy_s(game->abilityList[4].name, sizeof(game->abilityList[4].name), "Devastating Blow");
-    strcpy_s(game->abilityList[4].description, sizeof(game->abilityList[4].description), 
-             "Ultimate attack dealing 3x damage");
+    game->abilityList[4].name = StringPoolIntern("Devastating Blow");
+    game->abilityList[4].description = StringPoolIntern("Ultimate attack dealing 3x damage");
     game->abilityList[4].unlockedAtLevel = 9;
     game->abilityList[4].damageMultiplier = 3.0f;
     game->abilityList[4].cooldown = 6;
@@ -1497,18 +1638,18 @@ void PlayerDisplayStatusBar(Player* player)
         return;
     }
     
-    printf("%s", BOLD);
+    UI::UI_Printf("%s", BOLD);
     UI::UI_PrintDivider();
-    printf("%s", RESET);
+    UI::UI_Printf("%s", RESET);
     
-    printf("Name: %s | [LVL: %hu]\n", player->name, player->level);
+    UI::UI_Printf("Name: %s | [LVL: %hu]\n", player->name, player->level);
     UI::UI_DisplayHealthBar(player->health, player->maxHealth);
     UI::UI_DisplayExperienceBar(player->exp, XP_PER_LEVEL);
-    printf("Gold: %hu\n", player->gold);
+    UI::UI_Printf("Gold: %hu\n", player->gold);
     
-    printf("%s", BOLD);
+    UI::UI_Printf("%s", BOLD);
     UI::UI_PrintDivider();
-    printf("%s", RESET);
+    UI::UI_Printf("%s", RESET);
 }
 
 void PlayerLevelup(Player* player)
@@ -1547,7 +1688,13 @@ void PlayerDamage(Player* player, unsigned short damage)
         printf("ERROR - PlayerDamage: Player is null\n");
         return;
     }
-    player->health -= damage;
+    if (damage >= player->health)
+    {
+        player->health = 0;
+    }else
+    {
+        player->health -= damage;
+    }
 }
 
 void PlayerHeal(Player* player, unsigned short heal)
@@ -1751,6 +1898,85 @@ void PlayerApplyStatusEffects(Player* player, StatusEffect effect)
     player->statusEffectCount++;
 }
 
+// Messages for one tick of an effect, with the duration as it stood before the tick
+static void PlayerDisplayStatusTick(const StatusEffect* effect)
+{
+    switch (effect->type)
+    {
+    case POISON:
+        {
+            printf("%s", MAGENTA);
+            printf("💀 Poison deals %d damage! (%d turns left)\n",
+                  effect->damagePerTurn, effect->duration);
+            printf("%s", RESET);
+            break;
+        }
+    case BLEED:
+        {
+            printf("%s", RED);
+            printf("🩸 Bleeding deals %d damage! (%d turns left)\n",
+                  effect->damagePerTurn, effect->duration);
+            printf("%s", RESET);
+            break;
+        }
+    case STUN:
+        {
+            printf("%s", YELLOW);
+            printf("😵 You are stunned! (%d turns left)\n", effect->duration);
+            printf("%s", RESET);
+            break;
+        }
+    case FORTIFIED:
+        {
+            printf("%s", GREEN);
+            printf("🛡️  Fortified! (+%hd defense, %d turns left)\n",
+                  effect->statModifier, effect->duration);
+            printf("%s", RESET);
+            break;
+        }
+    case WEAKENED:
+        {
+            printf("%s", RED);
+            printf("💔 Weakened! (-%hd attack, %d turns left)\n",
+                  effect->statModifier, effect->duration);
+            printf("%s", RESET);
+            break;
+        }
+    }
+}
+
+static void PlayerDisplayStatusExpired(const StatusEffect* effect)
+{
+    switch (effect->type)
+    {
+    case FORTIFIED:
+        {
+            printf("%s", CYAN);
+            printf("⚠️  Fortification wore off! (Defense decreased by %hd)\n",
+                  effect->statModifier);
+            printf("%s", RESET);
+            break;
+        }
+    case WEAKENED:
+        {
+            printf("%s", CYAN);
+            printf("⚠️  Weakness wore off! (Attack restored by %hd)\n",
+                  effect->statModifier);
+            printf("%s", RESET);
+            break;
+        }
+    case STUN:
+    case BLEED:
+    case POISON:
+        {
+            printf("%s", CYAN);
+            printf("⚠️  Status effect wore off!\n");
+            printf("%s", RESET);
+            break;
+        }
+    }
+}
+
 void PlayerUpdateStatusEffects(Player* player)
 {
     if (player == nullptr)
@@ -1771,83 +1997,23 @@ void PlayerUpdateStatusEffects(Player* player)
     for (unsigned short i = 0; i < player->statusEffectCount; i++)
     {
         StatusEffect* effect = &player->statusEffect[i];
-        switch (effect->type)
+        if (effect->type == POISON || effect->type == BLEED)
         {
-        case POISON:
-            {
-                PlayerDamage(player, effect->damagePerTurn);
-                printf("%s", MAGENTA);
-                printf("💀 Poison deals %d damage! (%d turns left)\n",
-                      effect->damagePerTurn, effect->duration);
-                printf("%s", RESET);
-                break;
-            }
-        case BLEED:
-            {
-                PlayerDamage(player, effect->damagePerTurn);
-                printf("%s", RED);
-                printf("🩸 Bleeding deals %d damage! (%d turns left)\n",
-                      effect->damagePerTurn, effect->duration);
-                printf("%s", RESET);
-                break;
-            }
-        case STUN:
-            {
-                printf("%s", YELLOW);
-                printf("😵 You are stunned! (%d turns left)\n", effect->duration);
-                printf("%s", RESET);
-                break;
-            }
-        case FORTIFIED:
-            {
-                printf("%s", GREEN);
-                printf("🛡️  Fortified! (+%hd defense, %d turns left)\n",
-                      effect->statModifier, effect->duration);
-                printf("%s", RESET);
-                break;
-            }
-        case WEAKENED:
-            {
-                printf("%s", RED);
-                printf("💔 Weakened! (-%hd attack, %d turns left)\n",
-                      effect->statModifier, effect->duration);
-                printf("%s", RESET);
-                break;
-            }
+            PlayerDamage(player, effect->damagePerTurn);
         }
+        PlayerDisplayStatusTick(effect);
         effect->duration--;
         if (effect->duration <= 0)
         {
-            switch (effect->type)
+            if (effect->type == FORTIFIED)
             {
-            case FORTIFIED:
-                {
-                    player->defense -= effect->statModifier;
-                    printf("%s", CYAN);
-                    printf("⚠️  Fortification wore off! (Defense decreased by %hd)\n",
-                          effect->statModifier);
-                    printf("%s", RESET);
-                    break;
-                }
-            case WEAKENED:
-                {
-                    player->attack += effect->statModifier;
-                    printf("%s", CYAN);
-                    printf("⚠️  Weakness wore off! (Attack restored by %hd)\n",
-                          effect->statModifier);
-                    printf("%s", RESET);
-                    break;
-                }
-            case STUN:
-            case BLEED:
-            case POISON:
-                {
-                    printf("%s", CYAN);
-                    printf("⚠️  Status effect wore off!\n");
-                    printf("%s", RESET);
-                    break;
-                }
+                player->defense -= effect->statModifier;
             }
+            else if (effect->type == WEAKENED)
+            {
+                player->attack += effect->statModifier;
+            }
+            PlayerDisplayStatusExpired(effect);
             for (unsigned short j = i; j <player->statusEffectCount - 1; j++)
             {
                 player->statusEffect[j] = player->statusEffect[j + 1];
@@ -1942,6 +2108,15 @@ Enemy* EnemyGenerateForLevel(GameInstance* game, unsigned short playerLevel)
     {
         return nullptr;
     }
+    EnemyScaleToLevel(enemy, playerLevel);
+    
+    return enemy;
+}
+
+// Ten percent stronger per level the player is above the enemy's difficulty, weaker below it
+void EnemyScaleToLevel(Enemy* enemy, unsigned short playerLevel)
+{
+    if (enemy == nullptr) return;
     
     float levelDiff = (float)(playerLevel - enemy->difficulty);
     float levelMultiplier = 1.f + (levelDiff * 0.1f);
@@ -1952,8 +2127,6 @@ Enemy* EnemyGenerateForLevel(GameInstance* game, unsigned short playerLevel)
     enemy->defense = (short) (enemy->defense * levelMultiplier);
     enemy->expReward = (short) (enemy->expReward * levelMultiplier);
     enemy->goldReward = (short) (enemy->goldReward * levelMultiplier);
-    
-    return enemy;
 }
 
 void EnemyDisplayStats(Enemy* enemy)
@@ -1964,18 +2137,18 @@ void EnemyDisplayStats(Enemy* enemy)
         printf("Pointer to enemy is a nullptr - EnemyDisplayStats()\n");
         return;
     }
-    UI::UI_PrintSection(enemy->name);
-    printf("Health: [%hd/%hd]\n", enemy->health, enemy->baseHealth);
+    UI::UI_PrintSection(StringPoolGet(enemy->name));
+    UI::UI_Printf("Health: [%hd/%hd]\n", enemy->health, enemy->baseHealth);
     
     //Combat stats
-    printf("Attack: %hd\n", enemy->attack);
-    printf("Defense %hd\n", enemy->defense);
+    UI::UI_Printf("Attack: %hd\n", enemy->attack);
+    UI::UI_Printf("Defense %hd\n", enemy->defense);
     
     //diff
-    printf("Difficulty: %hd\n", enemy->difficulty);
+    UI::UI_Printf("Difficulty: %hd\n", enemy->difficulty);
     if (enemy->statusEffectCount > 0)
     {
-        printf("Status Effects: %hd active\n", enemy->statusEffectCount);
+        UI::UI_Printf("Status Effects: %hd active\n", enemy->statusEffectCount);
     }
     UI::UI_PrintDivider();
     
@@ -1991,38 +2164,6 @@ bool EnemyIsAlive(Enemy* enemy)
     return enemy->health > 0;
 }
 
-void EnemyUpdateStatusEffects(Enemy* enemy)
-{
-    if (enemy == nullptr) return;
-    
-    for (short i=0; i < enemy->statusEffectCount; i++)
-    {
-        StatusEffect* effect = &enemy->statusEffect[i];
-        switch (effect->type) //NOLINT
-        {
-        case POISON:
-        case BLEED:
-            {
-                EnemyDamage(enemy, effect->damagePerTurn);
-                char mssg[50];
-                sprintf_s(mssg, "%s takes %hu damage from %s!\n", enemy->name, effect->damagePerTurn, (effect->type == POISON ? "Poison" : "Bleed")); //NOLINT
-                printf("%s%s%s", CYAN, mssg, RESET);
-                break;
-            }
-        }
-        effect->duration--;
-        if (effect->duration <= 0)
-        {
-            for (short j = i; j < enemy->statusEffectCount - 1; j++)
-                enemy->statusEffect[j] = enemy->statusEffect[j + 1];
-            
-            enemy->statusEffectCount--;
-            i--;
-        }
-    }
-}
-
-
 void EnemyDamage(Enemy* enemy, unsigned short damage)
 {
     if (enemy == nullptr) return;
@@ -2044,33 +2185,36 @@ ItemData ItemCreate(short itemID, const char* name, ItemType type, ItemRarity ra
 {
     ItemData item;
     item.itemID = itemID;
-    errno_t err = strcpy_s(item.name, sizeof(item.name), name);
-    if (err != 0) printf("Failed to copy item name -> ItemCreate().\n");
+    item.name = StringPoolIntern(name);
+    item.description = itemCreateDescriptionIDs[type];
     item.type = type;
     item.rarity = rarity;
     item.value = value;
     item.cost = cost;
     item.quantity = 1;
+    return item;
+}
 
+static void ItemDisplayEffect(ItemType type, short value)
+{
     switch (type)
     {
     case WEAPON:
         {
-            sprintf_s(item.description, "A weapon that increases attack by %hd.", value);
+            printf("%sAttack increased by %hd!%s\n", GREEN, value, RESET);
             break;
         }
-        case ARMOR:
+    case ARMOR:
         {
-            sprintf_s(item.description, "Armor that increases defense by %hd.", value);
+            printf("%sDefense increased by %hd!%s\n", GREEN, value, RESET);
             break;
         }
     case POTION:
         {
-            sprintf_s(item.description, "A Potion that increases %hd health.", value);
+            printf("%sRestored %hd health!%s\n", GREEN, value, RESET);
             break;
         }
     }
-    return item;
 }
 
 void ItemApplyEffect(ItemData* item, Player* player)
@@ -2081,23 +2225,20 @@ void ItemApplyEffect(ItemData* item, Player* player)
     case WEAPON:
         {
             player->attack += item->value;
-            printf("%sAttack increased by %hd!%s\n", GREEN, item->value, RESET);
             break;
         }
     case ARMOR:
         {
             player->defense += item->value;
-            printf("%sDefense increased by %hd!%s\n", GREEN, item->value, RESET);
             break;
         }
     case POTION:
         {
             PlayerHeal(player, item->value);
-            printf("%sRestored %hd health!%s\n", GREEN, item->value, RESET);
             break;
         }
     }
-    
+    ItemDisplayEffect(item->type, item->value);
 }
 
 const char* ItemGetTypeName(ItemType type)
@@ -2170,18 +2311,27 @@ void ItemDisplay(ItemData* item)
             printf("%s", MAGENTA);
         }
     }
-    printf("%s%s\n", item->name, RESET);
+    printf("%s%s\n", StringPoolGet(item->name), RESET);
     printf("Type: %s\n", ItemGetTypeName(item->type));
     printf("Rarity: %s\n", ItemGetRarityName(item->rarity));
     printf("Value: %hd\n", item->value);
     printf("Cost: %hd gold\n", item->cost);
-    printf("Description: %s\n", item->description);
+    char description[MAX_DESCRIPTION_LENGTH];
+    printf("Description: %s\n", ItemGetDescription(item, description, sizeof(description)));
+}
+
+// Generated descriptions are formats; they are only expanded with the item's value when shown or saved
+const char* ItemGetDescription(const ItemData* item, char* buffer, size_t bufferSize)
+{
+    return StringPoolFormat(item->description, item->value, buffer, bufferSize);
 }
 
 ItemData ItemGenerateTreasure(unsigned short playerLevel)
 {
     ItemRarity rarity;
-    float roll = RandomFloat(0.f, 1.f);
+    float rolls[2];
+    RandomFillFloats(rolls, 2, 0.f, 1.f);
+    float roll = rolls[0];
     
     if (playerLevel < 3)
     {
@@ -2238,7 +2388,7 @@ ItemData ItemGenerateTreasure(unsigned short playerLevel)
     }
     
     ItemType type;
-    float typeRoll = RandomFloat(0.f, 1.f);
+    float typeRoll = rolls[1];
     if (typeRoll < 0.40f)
     {
         type = WEAPON;
@@ -2256,10 +2406,10 @@ ItemData ItemGenerateTreasure(unsigned short playerLevel)
 
 ItemData ItemGenerateRandom(ItemRarity rarity, ItemType type)
 {
-    static short nextItemID = 1000;
+    short* nextItemID = currentGame != nullptr ? &currentGame->nextItemID : &fallbackNextItemID;
     
     ItemData item;
-    item.itemID = nextItemID++;
+    item.itemID = (*nextItemID)++;
     item.type = type;
     item.rarity = rarity;
     item.quantity = 1;
@@ -2296,32 +2446,22 @@ ItemData ItemGenerateRandom(ItemRarity rarity, ItemType type)
     item.value = baseValue;
     item.cost = baseCost;
     
-    const char* rarityPrefix[4] = {"Rusty", "Fine", "Masterwork", "Legendary"};
-    const char* weaponNames[5] = {"Sword", "Axe", "Mace", "Dagger", "Spear"};
-    const char* armorNames[5] = {"Helmet", "Chestplate", "Gauntlets", "Boots", "Shield"};
-    const char* potionNames[4] = {"Health Potion", "Healing Elixir", "Life Flask", "Restoration Brew"};
-    
+    // Names and description formats were interned at startup
     switch (type)
     {
     case WEAPON:
-        {
-            sprintf_s(item.name, "%s %s", rarityPrefix[rarity], weaponNames[RandomShort(0, 4)]);
-            sprintf_s(item.description, "A weapon that increases attack by %hd", baseValue);
-            break;
-        }
     case ARMOR:
         {
-            sprintf_s(item.name, "%s %s", rarityPrefix[rarity], armorNames[RandomShort(0, 4)]);
-            sprintf_s(item.description, "Armor that increases defense by %hd", baseValue);
+            item.name = itemNameIDs[type][rarity][RandomShort(0, 4)];
             break;
         }
     case POTION:
         {
-            sprintf_s(item.name, "%s", potionNames[rarity]);
-            sprintf_s(item.description, "Restores %hd health", baseValue);
+            item.name = itemNameIDs[POTION][rarity][0];
             break;
         }
     }
+    item.description = itemDescriptionIDs[type];
     return item;
 }
 //--------------------
@@ -2331,7 +2471,8 @@ ItemData ItemGenerateRandom(ItemRarity rarity, ItemType type)
 
 Dungeon* DungeonInit()
 {
-    Dungeon* dungeon = (Dungeon*)malloc(sizeof(Dungeon));
+    // Zeroed so padding and unused links compare equal between copies (journal, checkpoints)
+    Dungeon* dungeon = (Dungeon*)calloc(1, sizeof(Dungeon));
     if (dungeon == nullptr)
     {
         printf("ERROR - Failed to allocate memory for dungeon.\n");
@@ -2339,149 +2480,172 @@ Dungeon* DungeonInit()
     }
     
     dungeon->totalRooms = MAX_ROOMS;
+    dungeon->bossRoom = MAX_ROOMS - 1;
+    dungeon->seed = 0;
+    DungeonGenLegacyParams(&dungeon->params);
     
     for (short i = 0; i < MAX_ROOMS; i++)
     {
-        dungeon->rooms[i].roomID = (short)1000 + i;
-        
-        dungeon->rooms[i].hasShop = false;
-        dungeon->rooms[i].hasBoss = false;
-        dungeon->rooms[i].explored = false;
-        dungeon->rooms[i].encounterType = EMPTY;
-        
-        for (short j = 0; j < 4; j++)
-        {
-            dungeon->rooms[i].connections[j] = -1;
-        }
-        
-        errno_t err = strcpy_s(dungeon->rooms[i].description, sizeof(dungeon->rooms[i].description), "An empty room");
-        if (err!=0)
-        {
-            printf("Failed to copy room description data.\n");
-        }
+        dungeon->rooms[i].state = EMPTY;
+        dungeon->rooms[i].description = emptyRoomDescriptionID;
     }
+    DungeonTopologyInitGrid(&dungeon->topology, DUNGEON_ROWS, DUNGEON_COLS);
+    DungeonBumpGeneration(dungeon);
     return dungeon;
 }
 
-void DungeonGenerateRooms(Dungeon* dungeon)
+// Picks the seed and plans the layout; rooms show their content once entered (DungeonMaterializeRoom).
+// A seed the default params cannot lay out falls back to the full legacy grid. False only when
+// neither works, which leaves the dungeon without a boss, so it must not be played.
+bool DungeonGenerateRooms(Dungeon* dungeon)
 {
     if (dungeon == nullptr)
     {
         printf("ERROR - Dungeon ptr is null in DungeonGenRooms()\n");
-        return;
+        return false;
     }
-    const char* roomDescriptions[20] = 
-        {
-        "A dark corridor with stone walls",
-        "A musty chamber filled with cobwebs",
-        "A huge hall with ancient pillars",
-        "A narrow passage with dripping water",
-        "A circular room with mysterious runes",
-        "A dusty library with old tombs",
-        "An armoury with rusty weapons",
-        "A torture chamber with old equipment",
-        "A throne room in ruins",
-        "A chapel with broken statues",
-        "A treasury vault which is empty",
-        "A kitchen with rotting food",
-        "A bedroom with tattered curtains",
-        "A study with scattered papers",
-        "A laboratory with strange equipments",
-        "A prison with empty cells and some skeleton ruins",
-        "A garden overgrown with weeds",
-        "A fountain room with stagnant water",
-        "A war room filled with faded maps",
-        "A crypt with ancient tombs"
-        };
-    for (short i = 0; i < MAX_ROOMS; i++)
+    unsigned int seed = RandomNextU32(RandomGetCurrent());
+    DungeonGenParams params;
+    DungeonGenDefaultParams(&params);
+    if (!DungeonGenerate(dungeon, seed, &params))
     {
-        errno_t err = strcpy_s(dungeon->rooms[i].description, sizeof(dungeon->rooms[i].description), roomDescriptions[i % 20]);
-        if (err!=0)
-        {
-            printf("Failed to copy room description data.\n");
-        }
-        
-        dungeon->rooms[i].hasShop = false;
-        
-        if (i == 0)
-        {
-            dungeon->rooms[i].encounterType = EMPTY;
-            dungeon->rooms[i].hasShop = false;
-            dungeon->rooms[i].explored = true;
-            continue;
-        }
-        if (i == MAX_ROOMS - 1)
-        {
-            dungeon->rooms[i].encounterType = BOSS;
-            dungeon->rooms[i].hasBoss = true;
-            dungeon->rooms[i].hasShop = false;
-            continue;
-        }
-        float roll = RandomFloat(0.0f, 1.0f);
-        if (roll < 0.70f)
+        printf("ERROR - Falling back to the legacy dungeon grid\n");
+        DungeonGenLegacyParams(&params);
+        if (!DungeonGenerate(dungeon, seed, &params))
         {
-            dungeon->rooms[i].encounterType = ENEMY;
-        }
-        else if (roll < 0.80f)
-        {
-            dungeon->rooms[i].encounterType = TREASURE;
-        }
-        else if (roll < 0.85f)
-        {
-            dungeon->rooms[i].encounterType = QUEST;
-        }
-        else if (roll < 0.93f)
-        {
-            dungeon->rooms[i].encounterType = EMPTY;
-            dungeon->rooms[i].hasShop = true;
-        }else
-        {
-            dungeon->rooms[i].encounterType = EMPTY;
+            return false;
         }
     }
+    DungeonMaterializeRoom(dungeon, 0);
+    return true;
 }
 
-void DungeonGenerateConnections(Dungeon* dungeon)
+Room* DungeonMaterializeRoom(Dungeon* dungeon, short roomIndex)
 {
-    if (dungeon == nullptr)
+    if (dungeon == nullptr || roomIndex < 0 || roomIndex >= dungeon->totalRooms)
     {
-        return;
+        return nullptr;
     }
-    for (short i = 0; i < MAX_ROOMS; i++)
+    Room* room = &dungeon->rooms[roomIndex];
+    if (RoomIsGenerated(room))
     {
-        for (short j = 0; j < 4; j++)
-        {
-            dungeon->rooms[i].connections[j] = -1;
-        }
+        return room;
+    }
+    if (!DungeonHasRoom(dungeon, roomIndex))
+    {
+        return nullptr;
     }
     
-    for (short row = 0; row < DUNGEON_ROWS; row++)
+    // The encounter was planned by DungeonGenerate; entering the room reveals it
+    room->description = DungeonGetRoomDescription(roomIndex);
+    room->state |= ROOM_FLAG_GENERATED;
+    DungeonBumpGeneration(dungeon);
+    if (roomIndex == 0)
     {
-        for (short col = 0; col < DUNGEON_COLS; col++)
+        DungeonSetExplored(dungeon, 0);
+    }
+    return room;
+}
+
+StringID DungeonGetRoomDescription(int roomIndex)
+{
+    return roomDescriptionIDs[roomIndex % 20];
+}
+
+short DungeonGetRoomID(short roomIndex)
+{
+    return (short)(1000 + roomIndex);
+}
+
+// Room through an exit, or -1 when that way is closed
+short DungeonGetConnection(const Dungeon* dungeon, short roomIndex, Direction direction)
+{
+    return DungeonTopologyStep(&dungeon->topology, roomIndex, direction);
+}
+
+// Fills out (room for 4) with every open exit in direction order, returns how many
+short DungeonGetNeighbours(const Dungeon* dungeon, short roomIndex, DungeonLink* out)
+{
+    return DungeonTopologyNeighbours(&dungeon->topology, roomIndex, out);
+}
+
+// False for solid rock between the corridors of a carved dungeon
+bool DungeonHasRoom(const Dungeon* dungeon, short roomIndex)
+{
+    const DungeonTopology* topology = &dungeon->topology;
+    if (roomIndex < 0 || roomIndex >= topology->rows * topology->cols)
+    {
+        return false;
+    }
+    if (topology->kind == TOPOLOGY_GRID || roomIndex == 0)
+    {
+        return true;
+    }
+    return topology->firstLink[roomIndex + 1] > topology->firstLink[roomIndex];
+}
+
+short DungeonCountRooms(const Dungeon* dungeon)
+{
+    short count = 0;
+    for (short i = 0; i < dungeon->topology.rows * dungeon->topology.cols; i++)
+    {
+        if (DungeonHasRoom(dungeon, i))
         {
-            short currentIndex = DungeonGetRoomIndex(row,col);
-            if (row > 0)
-            {
-                short northIndex = DungeonGetRoomIndex((short)row-1,col);
-                dungeon->rooms[currentIndex].connections[NORTH] = northIndex;
-            }
-            if (col < DUNGEON_COLS - 1)
-            {
-                short eastIndex = DungeonGetRoomIndex(row,(short)col + 1);
-                dungeon->rooms[currentIndex].connections[EAST] = eastIndex;
-            }
-            if (row < DUNGEON_ROWS - 1)
-            {
-                short southIndex = DungeonGetRoomIndex((short)row + 1,col);
-                dungeon->rooms[currentIndex].connections[SOUTH] = southIndex;
-            }
-            if (col > 0)
-            {
-                short westIndex = DungeonGetRoomIndex(row,(short)col - 1);
-                dungeon->rooms[currentIndex].connections[WEST] = westIndex;
-            }
+            count++;
         }
     }
+    return count;
+}
+
+bool DungeonIsExplored(const Dungeon* dungeon, short roomIndex)
+{
+    return (dungeon->explored[roomIndex >> 6] >> (roomIndex & 63) & 1) != 0;
+}
+
+void DungeonSetExplored(Dungeon* dungeon, short roomIndex)
+{
+    if (DungeonIsExplored(dungeon, roomIndex)) return;
+    dungeon->explored[roomIndex >> 6] |= 1ull << (roomIndex & 63);
+    DungeonBumpGeneration(dungeon);
+}
+
+// Marks the dungeon as changed for caches built from it (DungeonPaths). Values come from one
+// counter shared by every dungeon, so a freed, reloaded or copied-over dungeon never repeats a
+// value some cache already saw.
+void DungeonBumpGeneration(Dungeon* dungeon)
+{
+    static std::atomic<unsigned int> nextGeneration(1);
+    dungeon->generation = nextGeneration.fetch_add(1, std::memory_order_relaxed);
+}
+
+EncounterType RoomGetEncounter(const Room* room)
+{
+    return (EncounterType)(room->state & ROOM_ENCOUNTER_MASK);
+}
+
+void RoomSetEncounter(Room* room, EncounterType encounter)
+{
+    room->state = (unsigned char)((room->state & ~ROOM_ENCOUNTER_MASK) | encounter);
+}
+
+bool RoomHasShop(const Room* room)
+{
+    return (room->state & ROOM_FLAG_SHOP) != 0;
+}
+
+bool RoomHasBoss(const Room* room)
+{
+    return (room->state & ROOM_FLAG_BOSS) != 0;
+}
+
+void RoomSetBoss(Room* room, bool hasBoss)
+{
+    room->state = (unsigned char)(hasBoss ? room->state | ROOM_FLAG_BOSS : room->state & ~ROOM_FLAG_BOSS);
+}
+
+bool RoomIsGenerated(const Room* room)
+{
+    return (room->state & ROOM_FLAG_GENERATED) != 0;
 }
 
 void DungeonFree(Dungeon* dungeon)
@@ -2505,40 +2669,35 @@ void DungeonDisplayRoom(Player* player, Dungeon* dungeon)
     CLEAR_SCREEN();
     UI::UI_PrintHeader("CURRENT ROOM");
     printf("\n");
-    printf("Room: %hd: - %s\n", room->roomID, room->description);
+    printf("Room: %hd: - %s\n", DungeonGetRoomID((short)currRoom), StringPoolGet(room->description));
     printf("\n");
     
     //Exits
     UI::UI_PrintSection("Available Exits");
-    bool hasExits = false;
-    for (short i = 0; i < 4; i++)
+    DungeonLink exits[4];
+    short exitCount = DungeonGetNeighbours(dungeon, (short)currRoom, exits);
+    for (short i = 0; i < exitCount; i++)
     {
-        if (room->connections[i] != -1)
-        {
-            hasExits = true;
-            
-            short connectedRoomIndex = room->connections[i];
-            bool isExplored = dungeon->rooms[connectedRoomIndex].explored;
-            printf("- %s (to room %hd)%s\n", DungeonGetDirectionName((Direction) i), connectedRoomIndex, isExplored ? " (explored)" : "");
-        }
+        bool isExplored = DungeonIsExplored(dungeon, exits[i].room);
+        printf("- %s (to room %hd)%s\n", DungeonGetDirectionName((Direction)exits[i].direction), exits[i].room, isExplored ? " (explored)" : "");
     }
     
-    if (!hasExits)
+    if (exitCount == 0)
     {
         printf("No Exits are available!\n");
     }
     printf("\n");
-    if (room->hasShop)
+    if (RoomHasShop(room))
     {
         UI::UI_DisplayInfoMessage("There's a shop in this room!");
     }
     
-    if (room->hasBoss)
+    if (RoomHasBoss(room))
     {
         UI::UI_DisplayWarningMessage("You sense a powerful boss here!");
     }
     
-    if (room->encounterType != EMPTY && !room->explored)
+    if (RoomGetEncounter(room) != EMPTY && !DungeonIsExplored(dungeon, (short)currRoom))
     {
         UI::UI_DisplayWarningMessage("Something awaits you here...");
     }
@@ -2555,6 +2714,7 @@ void DungeonDisplayActionMenu()
     printf("6) View Map\n");
     printf("7) Save Game\n");
     printf("8) Pause Menu\n");
+    printf("9) Travel\n");
     printf("\nYour Choice: ");
 }
 
@@ -2566,7 +2726,7 @@ void DungeonMoveToRoom(Player* player, Dungeon* dungeon, Direction direction)
         return;
     }
     unsigned short currRoom = player->currentRoom;
-    short nextRoom = dungeon->rooms[currRoom].connections[direction];
+    short nextRoom = DungeonGetConnection(dungeon, (short)currRoom, direction);
     if (nextRoom == -1)
     {
         UI::UI_DisplayErrorMessage("You cannot go that way!");
@@ -2574,6 +2734,7 @@ void DungeonMoveToRoom(Player* player, Dungeon* dungeon, Direction direction)
         return;
     }
     player->currentRoom = nextRoom;
+    DungeonMaterializeRoom(dungeon, nextRoom);
     UI::UI_DisplaySuccessMessage("Moving to next room...");
     UI::UI_TimedPause(500);
 }
@@ -2590,6 +2751,17 @@ Direction DungeonGetDirectionInput()
     return Direction(choice - 1);
 }
 
+PathTarget DungeonGetTravelTargetInput()
+{
+    UI::UI_PrintCentered("Travel To:");
+    printf("1) The Boss\n");
+    printf("2) Nearest Shop\n");
+    printf("3) Nearest Unexplored Room\n");
+    
+    unsigned short choice = UI::UI_GetMenuInput(1, 3);
+    return PathTarget(choice - 1);
+}
+
 const char* DungeonGetDirectionName(Direction dir)
 {
     switch (dir)
@@ -2622,41 +2794,47 @@ void DungeonDisplayMap(Player* player, Dungeon* dungeon)
     }
     UI::UI_PrintHeader("DUNGEON MAP");
     printf("\nLegend: [P]=You | [X]=Explored | [?] = Unknown | [B]=Boss [S]=Shop\n\n");
-    for (short row=0; row < DUNGEON_ROWS; row++)
+    char line[MAX_ROOMS * 4 + 1];
+    for (short row=0; row < dungeon->topology.rows; row++)
     {
-        for (short col=0; col < DUNGEON_COLS; col++)
+        for (short col=0; col < dungeon->topology.cols; col++)
         {
-            short index = DungeonGetRoomIndex(row, col);
+            short index = (short)(dungeon->topology.cols * row + col);
             Room* room = &dungeon->rooms[index];
-            if (index == player->currentRoom)
+            const char* cell = "[?] ";
+            if (!DungeonHasRoom(dungeon, index))
+            {
+                cell = "    ";
+            }
+            else if (index == player->currentRoom)
             {
-                printf("[P]");
+                cell = "[P] ";
             }
-            else if (room->explored)
+            else if (DungeonIsExplored(dungeon, index))
             {
-                if (room->hasBoss)
+                if (RoomHasBoss(room))
                 {
-                    printf("[B]");
+                    cell = "[B] ";
                 }
-                else if (room->hasShop)
+                else if (RoomHasShop(room))
                 {
-                    printf("[S]");
+                    cell = "[S] ";
                 }
                 else
                 {
-                    printf("[X]");
+                    cell = "[X] ";
                 }
-            }else
-            {
-                printf("[?]");
             }
-            printf(" ");
+            
+            // A row goes out as one string
+            memcpy(line + col * 4, cell, 4);
         }
-        printf("\n");
+        line[dungeon->topology.cols * 4] = '\0';
+        printf("%s\n", line);
     }
     printf("\n");
     printf("Current Position: Room %hd\n", player->currentRoom);
-    printf("Explored: %hd/%hd\n", CountExploredRooms(dungeon), MAX_ROOMS);
+    printf("Explored: %hd/%hd\n", CountExploredRooms(dungeon), DungeonCountRooms(dungeon));
 }
 
 short DungeonGetRoomIndex(short row, short col)
@@ -2665,221 +2843,133 @@ short DungeonGetRoomIndex(short row, short col)
 }
 
 //--------------------
-// COMBAT FUNCTIONS
+// DUNGEON TOPOLOGY FUNCTIONS
 //--------------------
 
-CombatResult CombatStart(Player* player, Enemy* enemy, GameInstance* game)
+// Every in-bounds neighbour connected; nothing is stored past the size
+void DungeonTopologyInitGrid(DungeonTopology* topology, short rows, short cols)
 {
-    if (player == nullptr || enemy == nullptr || game == nullptr) return COMBAT_DEFEAT;
+    memset(topology, 0, sizeof(DungeonTopology));
+    topology->kind = TOPOLOGY_GRID;
+    topology->rows = rows;
+    topology->cols = cols;
+}
+
+// Builds the links from one exit mask per cell (bit per Direction). Exits off the edge of the
+// grid are dropped. Falls back to a grid topology when every in-bounds exit is open, so the
+// plain layout never pays for the link table.
+bool DungeonTopologyInitLinks(DungeonTopology* topology, short rows, short cols, const unsigned char* exits)
+{
+    if (rows <= 0 || cols <= 0 || rows * cols > MAX_ROOMS || exits == nullptr)
+    {
+        printf("ERROR - Invalid %hdx%hd topology in DungeonTopologyInitLinks()\n", rows, cols);
+        return false;
+    }
+    memset(topology, 0, sizeof(DungeonTopology));
+    topology->kind = TOPOLOGY_LINKS;
+    topology->rows = rows;
+    topology->cols = cols;
     
-    bool combatActive = true;
-    CombatResult result = COMBAT_DEFEAT;
-    while (combatActive)
+    bool full = true;
+    short linkCount = 0;
+    for (short i = 0; i < rows * cols; i++)
     {
-        CLEAR_SCREEN();
-        UI::UI_PrintHeader("COMBAT");
-        
-        UI::UI_PrintSection("YOU");
-        PlayerDisplayStatusBar(player);
-        printf("\n");
-        
-        UI::UI_PrintSection("ENEMY");
-        EnemyDisplayStats(enemy);
-        printf("\n");
-        
-        CombatDisplayMenu(player, enemy);
-        unsigned short choice = UI::UI_GetMenuInput(1, 4);
-        switch (choice)
+        topology->firstLink[i] = (unsigned short)linkCount;
+        for (short d = 0; d < 4; d++)
         {
-        case 1:
-            {
-                CombatPlayerAttack(player, enemy, game);
-                break;
-            }
-        case 2:
-            {
-                if (player->abilityCount > 0)
-                {
-                    CombatUseAbility(player, enemy, game);
-                }
-                else
-                {
-                    UI::UI_DisplayErrorMessage("No abilities unlocked yet!");
-                    UI::UI_TimedPause(1000);
-                    continue;
-                }
-                break;
-            }
-        case 3:
-            {
-                if (game->inventory != nullptr && game->inventory->itemCount > 0)
-                {
-                    CombatUseItem(player, enemy, game);
-                }else
-                {
-                    UI::UI_DisplayErrorMessage("No items in the inventory!");
-                    UI::UI_TimedPause(1000);
-                    continue;
-                }
-                break;
-            }
-        case 4:
+            int next = DungeonGridStep(rows, cols, i, (Direction)d);
+            if (next == -1)
             {
-                if (CombatAttemptEscape(player) == true)
-                {
-                    UI::UI_DisplaySuccessMessage("Escaped Successfully!");
-                    UI::UI_TimedPause(1000);
-                    result = COMBAT_ESCAPE;
-                    combatActive = false;
-                    continue;
-                }
-                else
-                {
-                    UI::UI_DisplayErrorMessage("Failed to escape!");
-                    UI::UI_TimedPause(1000);
-                }
-                break;
+                continue;
             }
-        default:
+            if ((exits[i] & (1 << d)) == 0)
             {
-                UI::UI_DisplayWarningMessage("Invalid choice!");
-                UI::UI_TimedPause(500);
+                full = false;
                 continue;
             }
+            topology->links[linkCount].room = (short)next;
+            topology->links[linkCount].direction = d;
+            linkCount++;
         }
-        if (!EnemyIsAlive(enemy))
-        {
-            result = COMBAT_VICTORY;
-            combatActive = false;
-            continue;
-        }
-        
-        UI::UI_PrintSection("Enemy's Turn");
-        UI::UI_TimedPause(500);
-        CombatEnemyAttack(player, enemy, game);
-        UI::UI_TimedPause(1000);
-        
-        if (player->health <= 0)
+    }
+    topology->firstLink[rows * cols] = (unsigned short)linkCount;
+    topology->linkCount = linkCount;
+    
+    if (full)
+    {
+        DungeonTopologyInitGrid(topology, rows, cols);
+    }
+    return true;
+}
+
+short DungeonTopologyStep(const DungeonTopology* topology, short roomIndex, Direction direction)
+{
+    if (roomIndex < 0 || roomIndex >= topology->rows * topology->cols)
+    {
+        return -1;
+    }
+    if (topology->kind == TOPOLOGY_GRID)
+    {
+        return (short)DungeonGridStep(topology->rows, topology->cols, roomIndex, direction);
+    }
+    for (unsigned short i = topology->firstLink[roomIndex]; i < topology->firstLink[roomIndex + 1]; i++)
+    {
+        if (topology->links[i].direction == direction)
         {
-            result = COMBAT_DEFEAT;
-            combatActive = false;
-            continue;
+            return topology->links[i].room;
         }
-        PlayerUpdateStatusEffects(player);
-        EnemyUpdateStatusEffects(enemy);
-        
-        CombatUpdateCooldowns(player);
-        UI::UI_PauseScreen();
     }
-    return result;
+    return -1;
 }
 
-void CombatAwardVictory(Player* player, Enemy* enemy, GameInstance* game)
+short DungeonTopologyNeighbours(const DungeonTopology* topology, short roomIndex, DungeonLink* out)
 {
-    if (player == nullptr || enemy == nullptr || game == nullptr) return;
-    
-    CLEAR_SCREEN();
-    UI::UI_PrintHeader("VICTORY");
-    printf("\n");
-    
-    PlayerGainExperience(player, enemy->expReward);
-    PlayerGainGold(player, enemy->goldReward);
-    
-    game->stats->totalEnemiesDefeated++;
-    game->stats->totalGoldEarned += enemy->goldReward;
-    
-    //QuestUpdateProgress(game->questLog, KILL_ENEMIES, 1);
-    
-    if (RandomChance(0.30f))
+    if (roomIndex < 0 || roomIndex >= topology->rows * topology->cols)
     {
-        printf("\n");
-        ItemData loot = ItemGenerateRandom(enemy->lootRarity, (ItemType)RandomShort(0,2));
-        printf("%s dropped: %s\n", enemy->name, loot.name);
-        
-        if (!InventoryIsFull(game->inventory))
+        return 0;
+    }
+    short count = 0;
+    if (topology->kind == TOPOLOGY_GRID)
+    {
+        for (short d = 0; d < 4; d++)
         {
-            if (InventoryAddItem(game->inventory, loot))
+            int next = DungeonGridStep(topology->rows, topology->cols, roomIndex, (Direction)d);
+            if (next != -1)
             {
-                UI::UI_DisplaySuccessMessage("Item added to inventory!");
-                game->stats->itemsCollected++;
+                out[count].room = (short)next;
+                out[count].direction = d;
+                count++;
             }
         }
-        else
-        {
-            UI::UI_DisplayWarningMessage("Inventory full! Item left behind.");
-        }
+        return count;
     }
-    printf("\n");
-    UI::UI_PauseScreen();
-} // Quest left..
-
-void CombatDisplayMenu(Player* player, Enemy* enemy)
-{
-    UI::UI_PrintDivider();
-    printf("Choose your action:\n");
-    printf("1) Attack.\n");
-    printf("2) Use Ability. [%hu unlocked]\n", player->abilityCount);
-    printf("3) Use Item.\n");
-    printf("4) Attempt Escape.\n");
-    UI::UI_PrintDivider();
-}
-
-void CombatPlayerAttack(Player* player, Enemy* enemy, GameInstance* game)
-{
-    if (player == nullptr || enemy == nullptr || game == nullptr) return;
-    
-    bool isCritical = RandomChance(0.15f);
-    float multiplier = isCritical ? 2.0f : 1.0f;
-    
-    unsigned short damage = CombatCalculateDamage(player->attack, enemy->defense, multiplier);
-    
-    EnemyDamage(enemy, damage);
-    
-    game->stats->totalDamageDealt += damage;
-    
-    UI::UI_DisplayCombatAnimation("Your attack", damage, isCritical);
-    
-    if (!EnemyIsAlive(enemy))
+    for (unsigned short i = topology->firstLink[roomIndex]; i < topology->firstLink[roomIndex + 1]; i++)
     {
-        UI::UI_DisplaySuccessMessage("Enemy Defeated!");
+        out[count++] = topology->links[i];
     }
+    return count;
 }
 
-void CombatEnemyAttack(Player* player, Enemy* enemy, GameInstance* game)
+// Bit per open Direction, the form the saves store
+unsigned char DungeonTopologyGetExits(const DungeonTopology* topology, short roomIndex)
 {
-    if (player == nullptr || enemy == nullptr || game == nullptr) return;
-    
-    bool isCritical = RandomChance(0.10f);
-    float multiplier = isCritical ? 1.5f : 1.0f;
-    unsigned short damage = CombatCalculateDamage(enemy->attack, player->defense, multiplier);
-    
-    PlayerDamage(player, damage);
-    game->stats->totalDamageTaken += damage;
-    
-    char action[50];
-    sprintf_s(action, "%s's attack", enemy->name);
-    UI::UI_DisplayCombatAnimation(action, damage, isCritical);
-    
-    if (player->health <= 0)
+    DungeonLink links[4];
+    short count = DungeonTopologyNeighbours(topology, roomIndex, links);
+    unsigned char exits = 0;
+    for (short i = 0; i < count; i++)
     {
-        UI::UI_DisplayErrorMessage("You have been defeated!");
+        exits |= (unsigned char)(1 << links[i].direction);
     }
+    return exits;
 }
 
-void CombatUseAbility(Player* player, Enemy* enemy, GameInstance* game)
+//--------------------
+// COMBAT FUNCTIONS
+//--------------------
+
+// Ability slot to use, or -1 when the player backs out
+static short CombatSelectAbility(Player* player)
 {
-    if (player == nullptr || enemy == nullptr || game == nullptr)
-    {
-        return;
-    }
-    
-    if (player->abilityCount == 0)
-    {
-        UI::UI_DisplayErrorMessage("No abilities unlocked yet!");
-        UI::UI_TimedPause(1000);
-        return;
-    }
-    
     CLEAR_SCREEN();
     UI::UI_PrintHeader("SELECT ABILITY");
     printf("\n");
@@ -2890,8 +2980,8 @@ void CombatUseAbility(Player* player, Enemy* enemy, GameInstance* game)
     {
         Ability* ability = &player->unlockedAbilities[i];
         
-        printf("%d. %s%s%s\n", i + 1, CYAN, ability->name, RESET);
-        printf("   %s\n", ability->description);
+        printf("%d. %s%s%s\n", i + 1, CYAN, StringPoolGet(ability->name), RESET);
+        printf("   %s\n", StringPoolGet(ability->description));
         printf("   Damage: %.1fx | Cooldown: %d turns\n", ability->damageMultiplier, ability->cooldown);
         
         if (ability->cooldownRemaining > 0)
@@ -2913,7 +3003,7 @@ void CombatUseAbility(Player* player, Enemy* enemy, GameInstance* game)
     {
         UI::UI_DisplayWarningMessage("All abilities are on cooldown!");
         UI::UI_TimedPause(1500);
-        return;
+        return -1;
     }
     
     printf("Select ability (0 to cancel): ");
@@ -2923,189 +3013,363 @@ void CombatUseAbility(Player* player, Enemy* enemy, GameInstance* game)
     {
         UI::UI_DisplayInfoMessage("Cancelled.");
         UI::UI_TimedPause(500);
-        return;
+        return -1;
     }
     
     Ability* selectedAbility = &player->unlockedAbilities[choice - 1];
-    
-    // Check if ability is on cooldown
     if (selectedAbility->cooldownRemaining > 0)
     {
         UI::UI_DisplayErrorMessage("That ability is still on cooldown!");
         printf("Turns remaining: %d\n", selectedAbility->cooldownRemaining);
         UI::UI_TimedPause(1500);
-        return;
+        return -1;
     }
+    return (short)(choice - 1);
+}
+
+// Item slot in the combat state, or -1 when the player backs out
+static short CombatSelectItem(const CombatState* state, GameInstance* game)
+{
+    CLEAR_SCREEN();
+    InventoryDisplay(game->inventory);
+    
+    printf("Enter ItemID to use (0 to cancel): > ");
+    short itemID = UI::UI_GetNumberInput();
+    
+    if (itemID == 0)
+        return -1;
+    for (unsigned short i = 0; i < state->itemCount; i++)
+    {
+        if (state->items[i].itemID == itemID)
+            return (short)i;
+    }
+    UI::UI_DisplayErrorMessage("No item with that ID!");
+    UI::UI_TimedPause(1000);
+    return -1;
+}
+
+// Shows an ability's hits and healing starting at its first event; returns the index of its last
+static short CombatDisplayAbility(const CombatTurnLog* log, short first, Player* player)
+{
+    short slot = log->events[first].slot;
+    const Ability* ability = &player->unlockedAbilities[slot];
+    const char* name = StringPoolGet(ability->name);
     
-    // Use the ability
     printf("\n");
-    printf("%s>>> Using %s%s%s <<<%s\n\n", CYAN, YELLOW, selectedAbility->name, CYAN, RESET);
+    printf("%s>>> Using %s%s%s <<<%s\n\n", CYAN, YELLOW, name, CYAN, RESET);
     UI::UI_TimedPause(500);
+    if (ability->abilityId == 4)
+    {
+        printf("%s🌀 You spin with devastating force!%s\n", CYAN, RESET);
+    }
+    else if (ability->abilityId == 5)
+    {
+        printf("%s💥 You unleash a DEVASTATING BLOW!%s\n", RED, RESET);
+    }
     
-    // Calculate base damage
-    unsigned short baseDamage = CombatCalculateDamage(player->attack, enemy->defense, selectedAbility->damageMultiplier);
-    
-    // Handle different ability types based on abilityId
-    switch (selectedAbility->abilityId)
+    short last = first;
+    unsigned short totalDamage = 0;
+    bool defeated = false;
+    for (short i = first; i < log->count && log->events[i].slot == slot; i++)
     {
-    case 1: // Power Strike - 1.5x damage
+        const CombatEvent* event = &log->events[i];
+        if (event->type == COMBAT_EVENT_HEAL)
         {
-            bool isCritical = RandomChance(0.20f); // Slightly higher crit chance for abilities
-            unsigned short finalDamage = isCritical ? (unsigned short)(baseDamage * 1.5f) : baseDamage;
-            
-            EnemyDamage(enemy, finalDamage);
-            game->stats->totalDamageDealt += finalDamage;
-            
-            char action[100];
-            sprintf_s(action, sizeof(action), "%s", selectedAbility->name);
-            UI::UI_DisplayCombatAnimation(action, finalDamage, isCritical);
-            break;
+            printf("%s🩸 %s restored %hd health!%s\n", GREEN, name, event->value, RESET);
         }
-    case 2: // Double Slash - Hit twice
+        else if (event->type == COMBAT_EVENT_HIT && event->target == COMBAT_SIDE_ENEMY)
         {
-            unsigned short hit1Damage = CombatCalculateDamage(player->attack, enemy->defense, 1.0f);
-            unsigned short hit2Damage = CombatCalculateDamage(player->attack, enemy->defense, 1.0f);
-            
-            // First hit
-            EnemyDamage(enemy, hit1Damage);
-            game->stats->totalDamageDealt += hit1Damage;
-            
-            char action1[100];
-            sprintf_s(action1, sizeof(action1), "%s (1st Strike)", selectedAbility->name);
-            UI::UI_DisplayCombatAnimation(action1, hit1Damage, false);
-            UI::UI_TimedPause(600);
+            char action[100];
+            if (event->strike == 0)
+            {
+                sprintf_s(action, sizeof(action), "%s", name);
+            }
+            else
+            {
+                sprintf_s(action, sizeof(action), "%s (%s Strike)", name, event->strike == 1 ? "1st" : "2nd");
+            }
+            UI::UI_DisplayCombatAnimation(action, (unsigned short)event->value, event->critical);
+            totalDamage = (unsigned short)(totalDamage + event->value);
+            defeated = event->remaining <= 0;
             
-            // Second hit (only if enemy still alive)
-            if (EnemyIsAlive(enemy))
+            if (event->strike == 1)
             {
-                EnemyDamage(enemy, hit2Damage);
-                game->stats->totalDamageDealt += hit2Damage;
-                
-                char action2[100];
-                sprintf_s(action2, sizeof(action2), "%s (2nd Strike)", selectedAbility->name);
-                UI::UI_DisplayCombatAnimation(action2, hit2Damage, false);
-                
-                printf("\n%sTotal Damage: %hu%s\n", YELLOW, hit1Damage + hit2Damage, RESET);
+                UI::UI_TimedPause(600);
+            }
+            else if (event->strike == 2)
+            {
+                printf("\n%sTotal Damage: %hu%s\n", YELLOW, totalDamage, RESET);
+            }
+            if (ability->abilityId == 5 && event->critical)
+            {
+                printf("%s⚡ MASSIVE CRITICAL HIT! ⚡%s\n", YELLOW, RESET);
             }
-            break;
         }
-    case 3: // Life Drain - Damage + heal 50% of damage dealt
+        else
         {
-            EnemyDamage(enemy, baseDamage);
-            game->stats->totalDamageDealt += baseDamage;
-            
-            char action[100];
-            sprintf_s(action, sizeof(action), "%s", selectedAbility->name);
-            UI::UI_DisplayCombatAnimation(action, baseDamage, false);
-            
-            // Heal for 50% of damage dealt
-            unsigned short healAmount = baseDamage / 2;
-            if (healAmount < 1) healAmount = 1;
-            
-            PlayerHeal(player, healAmount);
-            printf("%s🩸 Life Drain restored %hu health!%s\n", GREEN, healAmount, RESET);
             break;
         }
-    case 4: // Whirlwind - 2x damage
+        last = i;
+    }
+    
+    if (defeated)
+    {
+        printf("\n");
+        UI::UI_DisplaySuccessMessage("Enemy Defeated!");
+    }
+    UI::UI_TimedPause(1000);
+    return last;
+}
+
+static void CombatDisplayTurn(const CombatTurnLog* log, Player* player, Enemy* enemy)
+{
+    bool effectsShown = false;
+    for (short i = 0; i < log->count; i++)
+    {
+        const CombatEvent* event = &log->events[i];
+        switch (event->type)
         {
-            bool isCritical = RandomChance(0.15f);
-            unsigned short finalDamage = isCritical ? (unsigned short)(baseDamage * 1.5f) : baseDamage;
-            
-            EnemyDamage(enemy, finalDamage);
-            game->stats->totalDamageDealt += finalDamage;
-            
-            printf("%s🌀 You spin with devastating force!%s\n", CYAN, RESET);
-            
-            char action[100];
-            sprintf_s(action, sizeof(action), "%s", selectedAbility->name);
-            UI::UI_DisplayCombatAnimation(action, finalDamage, isCritical);
-            break;
+        case COMBAT_EVENT_HIT:
+            {
+                if (event->target == COMBAT_SIDE_PLAYER)
+                {
+                    UI::UI_PrintSection("Enemy's Turn");
+                    UI::UI_TimedPause(500);
+                    char action[50];
+                    sprintf_s(action, "%s's attack", StringPoolGet(enemy->name));
+                    UI::UI_DisplayCombatAnimation(action, (unsigned short)event->value, event->critical);
+                    if (event->remaining <= 0)
+                    {
+                        UI::UI_DisplayErrorMessage("You have been defeated!");
+                    }
+                    UI::UI_TimedPause(1000);
+                }
+                else if (event->slot >= 0)
+                {
+                    i = CombatDisplayAbility(log, i, player);
+                }
+                else
+                {
+                    UI::UI_DisplayCombatAnimation("Your attack", (unsigned short)event->value, event->critical);
+                    if (event->remaining <= 0)
+                    {
+                        UI::UI_DisplaySuccessMessage("Enemy Defeated!");
+                    }
+                }
+                break;
+            }
+        case COMBAT_EVENT_ITEM:
+            {
+                ItemDisplayEffect(event->itemType, event->value);
+                UI::UI_DisplaySuccessMessage("Item used!");
+                UI::UI_TimedPause(1000);
+                break;
+            }
+        case COMBAT_EVENT_ESCAPE:
+            {
+                if (event->value != 0)
+                {
+                    UI::UI_DisplaySuccessMessage("Escaped Successfully!");
+                }
+                else
+                {
+                    UI::UI_DisplayErrorMessage("Failed to escape!");
+                }
+                UI::UI_TimedPause(1000);
+                break;
+            }
+        case COMBAT_EVENT_EFFECT_TICK:
+            {
+                if (event->target == COMBAT_SIDE_ENEMY)
+                {
+                    if (event->effect.type == POISON || event->effect.type == BLEED)
+                    {
+                        printf("%s%s takes %hd damage from %s!\n%s", CYAN, StringPoolGet(enemy->name), event->value,
+                               event->effect.type == POISON ? "Poison" : "Bleed", RESET);
+                    }
+                    break;
+                }
+                if (!effectsShown)
+                {
+                    printf("\n");
+                    UI::UI_PrintColored("Status Effects", CYAN, true);
+                    printf("%s", RESET);
+                    effectsShown = true;
+                }
+                PlayerDisplayStatusTick(&event->effect);
+                break;
+            }
+        case COMBAT_EVENT_EFFECT_EXPIRED:
+            {
+                if (event->target == COMBAT_SIDE_PLAYER)
+                {
+                    PlayerDisplayStatusExpired(&event->effect);
+                }
+                break;
+            }
+        case COMBAT_EVENT_HEAL:
+            {
+                break; // Shown with the ability that healed
+            }
         }
-    case 5: // Devastating Blow - 3x damage
+    }
+    if (effectsShown)
+    {
+        printf("\n");
+    }
+}
+
+// The interactive layer over the combat kernel: read the player's action, resolve the turn on a
+// CombatState, copy the result back to the player, enemy and inventory, then show what happened
+CombatResult CombatStart(Player* player, Enemy* enemy, GameInstance* game)
+{
+    if (player == nullptr || enemy == nullptr || game == nullptr) return COMBAT_DEFEAT;
+    
+    CombatState state;
+    CombatStateInit(&state, player, enemy, game->inventory);
+    CombatOutcome outcome = {};
+    CombatTurnLog log;
+    bool combatActive = true;
+    while (combatActive)
+    {
+        CombatDisplayScreen(player, enemy);
+        unsigned short choice = UI::UI_GetMenuInput(1, 4);
+        CombatAction action = {COMBAT_ACTION_ATTACK, 0};
+        switch (choice)
         {
-            bool isCritical = RandomChance(0.25f); // Higher crit chance for ultimate
-            unsigned short finalDamage = isCritical ? (unsigned short)(baseDamage * 1.5f) : baseDamage;
-            
-            EnemyDamage(enemy, finalDamage);
-            game->stats->totalDamageDealt += finalDamage;
-            
-            printf("%s💥 You unleash a DEVASTATING BLOW!%s\n", RED, RESET);
-            
-            char action[100];
-            sprintf_s(action, sizeof(action), "%s", selectedAbility->name);
-            UI::UI_DisplayCombatAnimation(action, finalDamage, isCritical);
-            
-            if (isCritical)
+        case 1:
             {
-                printf("%s⚡ MASSIVE CRITICAL HIT! ⚡%s\n", YELLOW, RESET);
+                break;
+            }
+        case 2:
+            {
+                if (player->abilityCount == 0)
+                {
+                    UI::UI_DisplayErrorMessage("No abilities unlocked yet!");
+                    UI::UI_TimedPause(1000);
+                    continue;
+                }
+                action.type = COMBAT_ACTION_ABILITY;
+                action.slot = CombatSelectAbility(player);
+                if (action.slot < 0) continue;
+                break;
+            }
+        case 3:
+            {
+                if (state.itemCount == 0)
+                {
+                    UI::UI_DisplayErrorMessage("No items in the inventory!");
+                    UI::UI_TimedPause(1000);
+                    continue;
+                }
+                action.type = COMBAT_ACTION_ITEM;
+                action.slot = CombatSelectItem(&state, game);
+                if (action.slot < 0) continue;
+                break;
+            }
+        case 4:
+            {
+                action.type = COMBAT_ACTION_ESCAPE;
+                break;
+            }
+        default:
+            {
+                UI::UI_DisplayWarningMessage("Invalid choice!");
+                UI::UI_TimedPause(500);
+                continue;
+            }
+        }
+        
+        short itemID = action.type == COMBAT_ACTION_ITEM ? state.items[action.slot].itemID : (short)0;
+        unsigned int damageDealt = outcome.damageDealt;
+        unsigned int damageTaken = outcome.damageTaken;
+        combatActive = !CombatResolveTurn(&state, action, &game->random, &outcome, &log);
+        
+        CombatStateApply(&state, player, enemy);
+        if (itemID != 0)
+        {
+            InventoryRemoveItem(game->inventory, itemID);
+        }
+        game->stats->totalDamageDealt += (unsigned short)(outcome.damageDealt - damageDealt);
+        game->stats->totalDamageTaken += (unsigned short)(outcome.damageTaken - damageTaken);
+        
+        CombatDisplayTurn(&log, player, enemy);
+        if (combatActive)
+        {
+            UI::UI_PauseScreen();
+        }
+    }
+    UI::UI_ScreenEnd();
+    return outcome.result;
+}
+
+void CombatAwardVictory(Player* player, Enemy* enemy, GameInstance* game)
+{
+    if (player == nullptr || enemy == nullptr || game == nullptr) return;
+    
+    CLEAR_SCREEN();
+    UI::UI_PrintHeader("VICTORY");
+    printf("\n");
+    
+    PlayerGainExperience(player, enemy->expReward);
+    PlayerGainGold(player, enemy->goldReward);
+    
+    game->stats->totalEnemiesDefeated++;
+    game->stats->totalGoldEarned += enemy->goldReward;
+    
+    //QuestUpdateProgress(game->questLog, KILL_ENEMIES, 1);
+    
+    if (RandomChance(0.30f))
+    {
+        printf("\n");
+        ItemData loot = ItemGenerateRandom(enemy->lootRarity, (ItemType)RandomShort(0,2));
+        printf("%s dropped: %s\n", StringPoolGet(enemy->name), StringPoolGet(loot.name));
+        
+        if (!InventoryIsFull(game->inventory))
+        {
+            if (InventoryAddItem(game->inventory, loot))
+            {
+                UI::UI_DisplaySuccessMessage("Item added to inventory!");
+                game->stats->itemsCollected++;
             }
-            break;
         }
-    default:
+        else
         {
-            // Generic ability handling for any future abilities
-            EnemyDamage(enemy, baseDamage);
-            game->stats->totalDamageDealt += baseDamage;
-            
-            char action[100];
-            sprintf_s(action, sizeof(action), "%s", selectedAbility->name);
-            UI::UI_DisplayCombatAnimation(action, baseDamage, false);
-            break;
+            UI::UI_DisplayWarningMessage("Inventory full! Item left behind.");
         }
     }
-    
-    // Set cooldown
-    selectedAbility->cooldownRemaining = selectedAbility->cooldown;
-    
-    // Check if enemy is defeated
-    if (!EnemyIsAlive(enemy))
-    {
-        printf("\n");
-        UI::UI_DisplaySuccessMessage("Enemy Defeated!");
-    }
-    
-    UI::UI_TimedPause(1000);
-}
-
-void CombatUseItem(Player* player, Enemy* enemy, GameInstance* game)
-{
-    if (player == nullptr || enemy == nullptr || game == nullptr) return;
-    
-    CLEAR_SCREEN();
-    InventoryDisplay(game->inventory);
-    
-    printf("Enter ItemID to use (0 to cancel): > ");
-    short itemID;
-    scanf_s("%hd", &itemID);
-    while (getchar() != '\n');
-    
-    if (itemID == 0)
-        return;
-    InventoryUseItem(game->inventory, player, itemID);
-    UI::UI_TimedPause(1000);
-}
+    printf("\n");
+    UI::UI_PauseScreen();
+} // Quest left..
 
-bool CombatAttemptEscape(Player* player)
+// The screen each combat turn starts from. Kept on the terminal between turns, so a turn only
+// rewrites the numbers and bars that changed.
+void CombatDisplayScreen(Player* player, Enemy* enemy)
 {
-    if (player == nullptr) return false;
+    UI::UI_ScreenBegin();
+    UI::UI_PrintHeader("COMBAT");
     
-    float escapeChance = 0.40f;
+    UI::UI_PrintSection("YOU");
+    PlayerDisplayStatusBar(player);
+    UI::UI_Printf("\n");
     
-    if (player->trait == TRAIT_QUICK_HANDS)
-        escapeChance += 0.15f;
+    UI::UI_PrintSection("ENEMY");
+    EnemyDisplayStats(enemy);
+    UI::UI_Printf("\n");
     
-    return RandomChance(escapeChance);
+    CombatDisplayMenu(player, enemy);
+    UI::UI_ScreenPresent();
 }
 
-void CombatUpdateCooldowns(Player* player)
+void CombatDisplayMenu(Player* player, Enemy* enemy)
 {
-    if (player == nullptr) return;
-    
-    for (unsigned short i = 0; i < player->abilityCount; i++)
-    {
-        if (player->unlockedAbilities[i].cooldownRemaining > 0)
-            player->unlockedAbilities[i].cooldownRemaining--;
-    }
+    UI::UI_PrintDivider();
+    UI::UI_Printf("Choose your action:\n");
+    UI::UI_Printf("1) Attack.\n");
+    UI::UI_Printf("2) Use Ability. [%hu unlocked]\n", player->abilityCount);
+    UI::UI_Printf("3) Use Item.\n");
+    UI::UI_Printf("4) Attempt Escape.\n");
+    UI::UI_PrintDivider();
 }
 
 unsigned short CombatCalculateDamage(unsigned short attack, unsigned short defense, float multiplier)
@@ -3133,25 +3397,64 @@ Inventory* InventoryCreate()
         printf("Failed to allocate memory for Inventory.\n");
         return nullptr;
     }
-    inventory->head = nullptr;
     inventory->itemCount = 0;
+    InventoryRebuildIndex(inventory);
     return inventory;
 }
 
+// Items live inside the inventory, so one free releases everything
 void InventoryFree(Inventory* inventory)
 {
-    if (inventory == nullptr)
+    free(inventory);
+}
+
+// Fibonacci hashing, so the sequential IDs the game hands out spread across the table
+static unsigned short InventoryIndexHome(short itemID)
+{
+    return (unsigned short)(((unsigned int)(unsigned short)itemID * 2654435761u) >> (32 - INVENTORY_INDEX_BITS));
+}
+
+// Slot holding itemID, or the empty slot that ends its probe run. The table is never more than
+// MAX_INVENTORY / INVENTORY_INDEX_SIZE full, so an empty slot always exists.
+static unsigned short InventoryIndexProbe(const Inventory* inventory, short itemID)
+{
+    unsigned short slot = InventoryIndexHome(itemID);
+    while (inventory->index[slot] != INVENTORY_INDEX_EMPTY && inventory->items[inventory->index[slot]].itemID != itemID)
     {
-        return;
+        slot = (unsigned short)((slot + 1) & (INVENTORY_INDEX_SIZE - 1));
+    }
+    return slot;
+}
+
+// Backward-shift deletion: pull later entries of the run into the hole so no tombstones build up
+static void InventoryIndexErase(Inventory* inventory, unsigned short slot)
+{
+    unsigned short hole = slot;
+    unsigned short next = (unsigned short)((hole + 1) & (INVENTORY_INDEX_SIZE - 1));
+    while (inventory->index[next] != INVENTORY_INDEX_EMPTY)
+    {
+        unsigned short home = InventoryIndexHome(inventory->items[inventory->index[next]].itemID);
+        if (((next - home) & (INVENTORY_INDEX_SIZE - 1)) >= ((next - hole) & (INVENTORY_INDEX_SIZE - 1)))
+        {
+            inventory->index[hole] = inventory->index[next];
+            hole = next;
+        }
+        next = (unsigned short)((next + 1) & (INVENTORY_INDEX_SIZE - 1));
+    }
+    inventory->index[hole] = INVENTORY_INDEX_EMPTY;
+}
+
+// For callers that reorder items[] directly
+void InventoryRebuildIndex(Inventory* inventory)
+{
+    for (short i = 0; i < INVENTORY_INDEX_SIZE; i++)
+    {
+        inventory->index[i] = INVENTORY_INDEX_EMPTY;
     }
-    InventoryNode* current = inventory->head;
-    while (current != nullptr)
+    for (short i = 0; i < inventory->itemCount; i++)
     {
-        InventoryNode* next = current->next;
-        free(current);
-        current = next;
+        inventory->index[InventoryIndexProbe(inventory, inventory->items[i].itemID)] = i;
     }
-    free(inventory);
 }
 
 bool InventoryIsFull(Inventory* inventory)
@@ -3164,11 +3467,9 @@ unsigned short InventoryGetTotalValue(Inventory* inventory)
 {
     if (inventory == nullptr) return 0;
     unsigned short totalValue = 0;
-    InventoryNode* current = inventory->head;
-    while (current != nullptr)
+    for (short i = 0; i < inventory->itemCount; i++)
     {
-        totalValue += (current->item.cost * current->item.quantity);
-        current = current->next;
+        totalValue += (inventory->items[i].cost * inventory->items[i].quantity);
     }
     return totalValue;
 }
@@ -3186,29 +3487,15 @@ bool InventoryAddItem(Inventory* inventory, ItemData item)
         return false;
     }
     
-    InventoryNode* current = inventory->head;
-    while (current != nullptr)
+    unsigned short slot = InventoryIndexProbe(inventory, item.itemID);
+    if (inventory->index[slot] != INVENTORY_INDEX_EMPTY)
     {
-        if (current->item.itemID == item.itemID)
-        {
-            current->item.quantity += (short)item.quantity;
-            return true;
-        }
-        current = current->next;
-    }
-    
-    InventoryNode* newNode = (InventoryNode*)malloc(sizeof(InventoryNode));
-
-    if (newNode == nullptr)
-    {
-        printf("ERROR - Failed to allocate memory for inventory node\n");
-        return false;
+        inventory->items[inventory->index[slot]].quantity += (short)item.quantity;
+        return true;
     }
 
-    newNode->item = item;
-    newNode->next = inventory->head;
-    
-    inventory->head = newNode;
+    inventory->items[inventory->itemCount] = item;
+    inventory->index[slot] = inventory->itemCount;
     inventory->itemCount++;
     
     return true;
@@ -3216,40 +3503,40 @@ bool InventoryAddItem(Inventory* inventory, ItemData item)
 
 bool InventoryRemoveItem(Inventory* inventory, short itemID)
 {
-    if (inventory == nullptr || inventory->head == nullptr) return false;
-    InventoryNode* current = inventory->head;
-    InventoryNode* prev = nullptr;
-    while (current != nullptr)
+    if (inventory == nullptr || inventory->itemCount == 0) return false;
+    unsigned short slot = InventoryIndexProbe(inventory, itemID);
+    short position = inventory->index[slot];
+    if (position == INVENTORY_INDEX_EMPTY) return false;
+
+    inventory->items[position].quantity--;
+    if (inventory->items[position].quantity <= 0)
     {
-        if (current->item.itemID == itemID)
+        InventoryIndexErase(inventory, slot);
+        short last = (short)(inventory->itemCount - 1);
+        if (position != last)
         {
-            current->item.quantity--;
-            if (current->item.quantity <= 0)
-            {
-                // remove node from list
-                if (prev == nullptr)
-                    inventory->head = current->next;
-                else
-                    prev->next = current->next;
-                free(current);
-                inventory->itemCount--;
-            }
-            return true;
+            // Fill the gap with the last item; its index entry still finds it by ID at the old position
+            inventory->items[position] = inventory->items[last];
+            inventory->index[InventoryIndexProbe(inventory, inventory->items[position].itemID)] = position;
         }
-        prev = current;
-        current = current->next;
+        inventory->itemCount--;
     }
-    return false;
+    return true;
 }
 
 ItemData* InventoryFindItem(Inventory* inventory, short itemID)
 {
     if (inventory == nullptr) return nullptr;
-    InventoryNode* current = inventory->head;
-    while (current != nullptr)
+    short position = inventory->index[InventoryIndexProbe(inventory, itemID)];
+    return position != INVENTORY_INDEX_EMPTY ? &inventory->items[position] : nullptr;
+}
+
+ItemData* InventoryFindFirstOfType(Inventory* inventory, ItemType type)
+{
+    if (inventory == nullptr) return nullptr;
+    for (short i = 0; i < inventory->itemCount; i++)
     {
-        if (current->item.itemID == itemID) return &current->item;
-        current = current->next;
+        if (inventory->items[i].type == type) return &inventory->items[i];
     }
     return nullptr;
 }
@@ -3269,11 +3556,10 @@ void InventoryDisplay(Inventory* inventory)
     }
     printf("\nItems: %hd/%hd\n\n", inventory->itemCount, MAX_INVENTORY);
     UI::UI_PrintDivider();
-    InventoryNode* current = inventory->head;
-    short index = 1;
-    while (current != nullptr)
+    for (short index = 1; index <= inventory->itemCount; index++)
     {
-        ItemData* item = &current->item;
+        ItemData* item = &inventory->items[index - 1];
+        char description[MAX_DESCRIPTION_LENGTH];
         printf("%hd. ", index);
         
         switch (item->rarity)
@@ -3299,12 +3585,9 @@ void InventoryDisplay(Inventory* inventory)
                 break;
             }
         }
-        printf("%s%s (x %hd)\n", item->name, RESET, item->quantity);
+        printf("%s%s (x %hd)\n", StringPoolGet(item->name), RESET, item->quantity);
         printf(" ID: %hd | Type: %s | Value: %hd | Cost: %hd\n", item->itemID, ItemGetTypeName(item->type), item->value, item->cost);
-        printf("%s\n\n", item->description);
-        
-        current = current->next;
-        index++;
+        printf("%s\n\n", ItemGetDescription(item, description, sizeof(description)));
     }
     UI::UI_PrintDivider();
     printf("Total Value: %hd gold\n", InventoryGetTotalValue(inventory));
@@ -3537,8 +3820,8 @@ void AbilityDisplayList(Player* player)
     {
         Ability* ability = &player->unlockedAbilities[i];
         
-        printf("%d. %s%s%s\n", i + 1, CYAN, ability->name, RESET);
-        printf("   %s\n", ability->description);
+        printf("%d. %s%s%s\n", i + 1, CYAN, StringPoolGet(ability->name), RESET);
+        printf("   %s\n", StringPoolGet(ability->description));
         printf("   Damage Multiplier: %.1fx\n", ability->damageMultiplier);
         printf("   Cooldown: %d turns\n", ability->cooldown);
         
@@ -3600,9 +3883,9 @@ void AbilityCheckUnlocks(Player* player, GameInstance* game)
                 printf("%s", RESET);
                 printf("\n");
                 
-                printf("%s⚔️  %s%s%s  ⚔️%s\n\n", CYAN, YELLOW, ability->name, CYAN, RESET);
+                printf("%s⚔️  %s%s%s  ⚔️%s\n\n", CYAN, YELLOW, StringPoolGet(ability->name), CYAN, RESET);
                 
-                printf("%s\n\n", ability->description);
+                printf("%s\n\n", StringPoolGet(ability->description));
                 
                 UI::UI_PrintSection("ABILITY STATS");
                 printf("Damage Multiplier: %s%.1fx%s\n", GREEN, ability->damageMultiplier, RESET);
@@ -3674,14 +3957,14 @@ void AbilityUse(Player* player, Enemy* enemy, Ability* ability, GameInstance* ga
     {
         EnemyDamage(enemy, damage);
         char action[100];
-        sprintf_s(action, sizeof(action), "%s (1st hit)", ability->name);
+        sprintf_s(action, sizeof(action), "%s (1st hit)", StringPoolGet(ability->name));
         UI::UI_DisplayCombatAnimation(action, damage, false);
         UI::UI_TimedPause(500);
         
         if (EnemyIsAlive(enemy))
         {
             EnemyDamage(enemy, damage);
-            sprintf_s(action, sizeof(action), "%s (2nd hit)", ability->name);
+            sprintf_s(action, sizeof(action), "%s (2nd hit)", StringPoolGet(ability->name));
             UI::UI_DisplayCombatAnimation(action, damage, false);
         }
     }
@@ -3692,14 +3975,14 @@ void AbilityUse(Player* player, Enemy* enemy, Ability* ability, GameInstance* ga
         PlayerHeal(player, healAmount);
         printf("%sYou drained %hd health!%s\n", GREEN, healAmount, RESET);
         char action[100];
-        sprintf_s(action, sizeof(action), "%s", ability->name);
+        sprintf_s(action, sizeof(action), "%s", StringPoolGet(ability->name));
         UI::UI_DisplayCombatAnimation(action, damage, false);
     }
     else
     {
         EnemyDamage(enemy, damage);
         char action[100];
-        sprintf_s(action, sizeof(action), "%s", ability->name);
+        sprintf_s(action, sizeof(action), "%s", StringPoolGet(ability->name));
         UI::UI_DisplayCombatAnimation(action, damage, false);
     }
 }
@@ -3802,6 +4085,7 @@ void ShopDisplay(Shop* shop)
     for (short i = 0; i < shop->itemCount; i++)
     {
         ItemData* item = &shop->items[i];
+        char description[MAX_DESCRIPTION_LENGTH];
         printf("%hd. ", i+1);
         switch (item->rarity)
         {
@@ -3824,9 +4108,9 @@ void ShopDisplay(Shop* shop)
                 printf("%s", MAGENTA);break;
             }
         }
-        printf("%s%s - %hd gold\n", item->name, RESET, item->cost);
+        printf("%s%s - %hd gold\n", StringPoolGet(item->name), RESET, item->cost);
         printf("   Type: %s | Value: %hd\n", ItemGetTypeName(item->type), item->value);
-        printf("   %s\n\n", item->description);
+        printf("   %s\n\n", ItemGetDescription(item, description, sizeof(description)));
     }
     UI::UI_PrintDivider();
 }
@@ -3898,11 +4182,12 @@ bool ShopSellItem(Shop* shop, Player* player, Inventory* inventory, short itemID
     }
     
     int sellPrice = item->cost / 2;
+    StringID name = item->name; // Removing may move another item into this slot
     
     player->gold += sellPrice;
     InventoryRemoveItem(inventory, itemID);
     
-    printf("Sold %s for %d gold!\n", item->name, sellPrice);
+    printf("Sold %s for %d gold!\n", StringPoolGet(name), sellPrice);
     UI::UI_DisplaySuccessMessage("Sale complete!");
     
     return true;
@@ -3942,9 +4227,7 @@ void ShopMenu(Shop* shop, Player* player, Inventory* inventory)
                 }
                 
                 printf("Enter item number to buy (0 to cancel): ");
-                short itemNum;
-                scanf_s("%hd", &itemNum);
-                while (getchar() != '\n') {}
+                short itemNum = UI::UI_GetNumberInput();
                 
                 if (itemNum > 0 && itemNum <= shop->itemCount)
                 {
@@ -3969,9 +4252,7 @@ void ShopMenu(Shop* shop, Player* player, Inventory* inventory)
                 InventoryDisplay(inventory);
                 
                 printf("\nEnter item ID to sell (0 to cancel): ");
-                short itemID;
-                scanf_s("%hd", &itemID);
-                while (getchar() != '\n') {}
+                short itemID = UI::UI_GetNumberInput();
                 
                 if (itemID > 0)
                 {
@@ -3997,10 +4278,60 @@ void ShopMenu(Shop* shop, Player* player, Inventory* inventory)
 // FILE I/O FUNCTIONS
 //--------------------
 
+// Saves through the background writer but waits for it, so the player is told whether the
+// save reached the disk. Only the per-turn autosave returns before the write.
+bool GameSave(GameInstance* game)
+{
+    if (game == nullptr) return false;
+    if (game->autosave == nullptr)
+    {
+        game->autosave = AutosaveStart(SAVE_FILE_NAME, SAVE_JOURNAL_FILE_NAME);
+    }
+    
+    // A failed earlier turn is written again as part of this save, so only this write counts
+    AutosaveTakeFailure(game->autosave);
+    if (!AutosaveQueue(game->autosave, game)) return false;
+    AutosaveFlush(game->autosave);
+    return !AutosaveTakeFailure(game->autosave);
+}
+
+// Runs after every turn once the player has saved this session
+bool GameAutosave(GameInstance* game)
+{
+    if (game == nullptr || game->autosave == nullptr) return true;
+    return !AutosaveTakeFailure(game->autosave) && AutosaveQueue(game->autosave, game);
+}
+
 bool FileSaveGame(Player* player, Inventory* inventory, QuestLog* questLog, GameStatistics* stats, Dungeon* dungeon)
+{
+    return SaveWriteSnapshot(SAVE_FILE_NAME, player, inventory, questLog, stats, dungeon);
+}
+
+bool FileLoadGame(Player** player, Inventory** inventory, QuestLog** questLog, GameStatistics** stats, Dungeon** dungeon)
+{
+    FILE* probe;
+    if (fopen_s(&probe, SAVE_FILE_NAME, "rb") == 0 && probe != nullptr)
+    {
+        fclose(probe);
+        if (!SaveReadSnapshot(SAVE_FILE_NAME, player, inventory, questLog, stats, dungeon)) return false;
+
+        // Turns saved after the snapshot live in the journal
+        unsigned int checksum = 0;
+        if (SaveReadSnapshotChecksum(SAVE_FILE_NAME, &checksum))
+        {
+            SaveJournalReplay(SAVE_JOURNAL_FILE_NAME, checksum, *player, *inventory, *questLog, *stats, *dungeon);
+        }
+        return true;
+    }
+    
+    // Saves from before the binary format are still readable
+    return FileLoadGameText(LEGACY_SAVE_FILE_NAME, player, inventory, questLog, stats, dungeon);
+}
+
+bool FileSaveGameText(const char* path, Player* player, Inventory* inventory, QuestLog* questLog, GameStatistics* stats, Dungeon* dungeon)
 {
     FILE* file;
-    errno_t err = fopen_s(&file, "savegame.txt", "w");
+    errno_t err = fopen_s(&file, path, "w");
     
     if (err != 0 || file == nullptr)
     {
@@ -4018,10 +4349,10 @@ bool FileSaveGame(Player* player, Inventory* inventory, QuestLog* questLog, Game
     return true;
 }
 
-bool FileLoadGame(Player** player, Inventory** inventory, QuestLog** questLog, GameStatistics** stats, Dungeon** dungeon)
+bool FileLoadGameText(const char* path, Player** player, Inventory** inventory, QuestLog** questLog, GameStatistics** stats, Dungeon** dungeon)
 {
     FILE* file;
-    errno_t err = fopen_s(&file, "savegame.txt", "r");
+    errno_t err = fopen_s(&file, path, "r");
     
     if (err != 0 || file == nullptr)
     {
@@ -4033,9 +4364,25 @@ bool FileLoadGame(Player** player, Inventory** inventory, QuestLog** questLog, G
     FileReadInventory(file, inventory);
     FileReadQuests(file, questLog);
     FileReadStats(file, stats);
-    FileReadDungeon(file, dungeon);
+    bool isDungeonRead = FileReadDungeon(file, dungeon);
     
     fclose(file);
+    if (!isDungeonRead)
+    {
+        return false;
+    }
+    
+    // The text format does not store room descriptions
+    if (*dungeon != nullptr)
+    {
+        for (short i = 0; i < (*dungeon)->totalRooms; i++)
+        {
+            if (RoomIsGenerated(&(*dungeon)->rooms[i]))
+            {
+                (*dungeon)->rooms[i].description = DungeonGetRoomDescription(i);
+            }
+        }
+    }
     return true;
 }
 
@@ -4094,18 +4441,17 @@ void FileWriteInventory(FILE* file, Inventory* inventory)
     fprintf_s(file, "INVENTORY\n");
     fprintf_s(file, "%hd\n", inventory->itemCount);
 
-    InventoryNode* current = inventory->head;
-    while (current != nullptr)
+    for (short i = 0; i < inventory->itemCount; i++)
     {
+        const ItemData* item = &inventory->items[i];
         fprintf_s(file, "%hd|%s|%hd|%d|%d|%hd|%hd\n",
-            current->item.itemID,
-            current->item.name,
-            current->item.value,
-            (int)current->item.rarity,
-            (int)current->item.type,
-            current->item.cost,
-            current->item.quantity);
-        current = current->next;
+            item->itemID,
+            StringPoolGet(item->name),
+            item->value,
+            (int)item->rarity,
+            (int)item->type,
+            item->cost,
+            item->quantity);
     }
 }
 
@@ -4126,23 +4472,24 @@ void FileReadInventory(FILE* file, Inventory** inventory)
     for (short i = 0; i < itemCount; i++)
     {
         ItemData item{};
+        char name[MAX_NAME_LENGTH] = "";
         int rarity = 0, type = 0;
 
         if (!fgets(buffer, 256, file)) break;
 
         sscanf_s(buffer, "%hd|%49[^|]|%hd|%d|%d|%hd|%hd",
             &item.itemID,
-            item.name, (unsigned)sizeof(item.name),
+            name, (unsigned)sizeof(name),
             &item.value,
             &rarity,
             &type,
             &item.cost,
             &item.quantity);
 
+        item.name = StringPoolIntern(name);
         item.rarity = (ItemRarity)rarity;
         item.type = (ItemType)type;
-
-        sprintf_s(item.description, sizeof(item.description), "Loaded item");
+        item.description = StringPoolIntern("Loaded item");
 
         InventoryAddItem(*inventory, item);
     }
@@ -4220,79 +4567,367 @@ void FileReadStats(FILE* file, GameStatistics** stats)
            &(*stats)->totalPlaytime, &(*stats)->deathCount);
 }
 
+// Rooms that were never entered are left out; loading plans them again from the seed and params
 void FileWriteDungeon(FILE* file, Dungeon* dungeon)
 {
     if (file == nullptr || dungeon == nullptr) return;
     
+    short generatedCount = 0;
+    for (short i = 0; i < dungeon->totalRooms; i++)
+    {
+        if (RoomIsGenerated(&dungeon->rooms[i])) generatedCount++;
+    }
+    
     fprintf_s(file, "DUNGEON\n");
-    fprintf_s(file, "%hd\n", dungeon->totalRooms);
+    fprintf_s(file, "%hd %u %hd\n", dungeon->totalRooms, dungeon->seed, generatedCount);
     
     for (short i = 0; i < dungeon->totalRooms; i++)
     {
+        const Room* room = &dungeon->rooms[i];
+        if (!RoomIsGenerated(room)) continue;
         fprintf_s(file, "%hd %d %d %d %d\n",
-                dungeon->rooms[i].roomID, dungeon->rooms[i].encounterType,
-                dungeon->rooms[i].hasShop, dungeon->rooms[i].hasBoss,
-                dungeon->rooms[i].explored);
+                i, RoomGetEncounter(room),
+                RoomHasShop(room), RoomHasBoss(room),
+                DungeonIsExplored(dungeon, i));
+    }
+    
+    // Grids are implied by their size; carved layouts add a hex digit exit mask per cell
+    const DungeonTopology* topology = &dungeon->topology;
+    fprintf_s(file, "TOPOLOGY %hd %hd %hd\n", topology->kind, topology->rows, topology->cols);
+    if (topology->kind == TOPOLOGY_LINKS)
+    {
+        for (short i = 0; i < topology->rows * topology->cols; i++)
+        {
+            fprintf_s(file, "%x", DungeonTopologyGetExits(topology, i));
+        }
+        fprintf_s(file, "\n");
     }
+    const DungeonGenParams* params = &dungeon->params;
+    fprintf_s(file, "GENERATOR %hd %hd %d %d %d %d %d %d %d %d\n", params->rows, params->cols, params->fillPercent,
+              params->loopPercent, params->enemyPercent, params->treasurePercent, params->questPercent,
+              params->shopPercent, params->difficultyTiers, params->minBossDistance);
 }
 
-void FileReadDungeon(FILE* file, Dungeon** dungeon)
+// Older saves list every room by roomID after a bare room count; treat all of them as generated.
+// False when the dungeon cannot be rebuilt as it was saved.
+bool FileReadDungeon(FILE* file, Dungeon** dungeon)
 {
-    if (file == nullptr) return;
+    if (file == nullptr) return false;
     
-    *dungeon = (Dungeon*)malloc(sizeof(Dungeon));
-    if (*dungeon == nullptr) return;
+    *dungeon = DungeonInit();
+    if (*dungeon == nullptr) return false;
     
     char buffer[256];
     fgets(buffer, 256, file);
     
     fgets(buffer, 256, file);
-    sscanf_s(buffer, "%hd", &(*dungeon)->totalRooms);
+    short totalRooms = 0;
+    short listedRooms = 0;
+    unsigned int seed = 0;
+    bool seeded = sscanf_s(buffer, "%hd %u %hd", &totalRooms, &seed, &listedRooms) == 3;
+    if (!seeded)
+    {
+        listedRooms = totalRooms;
+    }
+    if (totalRooms < 0 || totalRooms > MAX_ROOMS || listedRooms < 0 || listedRooms > totalRooms)
+    {
+        printf("ERROR - Save file has an invalid dungeon size\n");
+        return false;
+    }
+    (*dungeon)->totalRooms = totalRooms;
+    (*dungeon)->seed = seed;
     
-    for (short i = 0; i < (*dungeon)->totalRooms; i++)
+    for (short i = 0; i < listedRooms; i++)
     {
+        short id;
         int encounterType, hasShop, hasBoss, explored;
         fgets(buffer, 256, file);
         sscanf_s(buffer, "%hd %d %d %d %d",
-               &(*dungeon)->rooms[i].roomID, &encounterType,
+               &id, &encounterType,
                &hasShop, &hasBoss, &explored);
-        (*dungeon)->rooms[i].encounterType = (EncounterType)encounterType;
-        (*dungeon)->rooms[i].hasShop = (bool)hasShop;
-        (*dungeon)->rooms[i].hasBoss = (bool)hasBoss;
-        (*dungeon)->rooms[i].explored = (bool)explored;
+        short index = seeded ? id : i;
+        if (index < 0 || index >= totalRooms) continue;
+        (*dungeon)->rooms[index].state = (unsigned char)((encounterType & ROOM_ENCOUNTER_MASK) | (hasShop ? ROOM_FLAG_SHOP : 0) |
+            (hasBoss ? ROOM_FLAG_BOSS : 0) | ROOM_FLAG_GENERATED);
+        if (explored)
+        {
+            DungeonSetExplored(*dungeon, index);
+        }
+    }
+    
+    // Saves from before carved layouts end here, saves from before the generator after the
+    // topology; both were full grids, which the legacy params rebuild
+    DungeonTopology saved;
+    DungeonTopologyInitGrid(&saved, DUNGEON_ROWS, DUNGEON_COLS);
+    DungeonGenParams params;
+    DungeonGenLegacyParams(&params);
+    if (fgets(buffer, 256, file) != nullptr && strncmp(buffer, "TOPOLOGY", 8) == 0)
+    {
+        if (!FileReadTopology(file, buffer, &saved))
+        {
+            return false;
+        }
+        int values[10];
+        if (fgets(buffer, 256, file) != nullptr &&
+            sscanf_s(buffer, "GENERATOR %d %d %d %d %d %d %d %d %d %d", &values[0], &values[1], &values[2], &values[3],
+                     &values[4], &values[5], &values[6], &values[7], &values[8], &values[9]) == 10)
+        {
+            params.rows = (short)values[0];
+            params.cols = (short)values[1];
+            params.fillPercent = (unsigned char)values[2];
+            params.loopPercent = (unsigned char)values[3];
+            params.enemyPercent = (unsigned char)values[4];
+            params.treasurePercent = (unsigned char)values[5];
+            params.questPercent = (unsigned char)values[6];
+            params.shopPercent = (unsigned char)values[7];
+            params.difficultyTiers = (unsigned char)values[8];
+            params.minBossDistance = (unsigned char)values[9];
+        }
+    }
+    
+    // Rooms not listed are planned again from the seed; the layout has to come out as saved
+    if (!DungeonGenerate(*dungeon, seed, &params) || memcmp(&saved, &(*dungeon)->topology, sizeof(DungeonTopology)) != 0)
+    {
+        printf("ERROR - Save file does not match its dungeon generator\n");
+        return false;
+    }
+    return true;
+}
+
+// Reads the exit masks that follow a "TOPOLOGY kind rows cols" line already in buffer
+static bool FileReadTopology(FILE* file, char* buffer, DungeonTopology* topology)
+{
+    short kind = TOPOLOGY_GRID;
+    short rows = 0;
+    short cols = 0;
+    if (sscanf_s(buffer, "TOPOLOGY %hd %hd %hd", &kind, &rows, &cols) != 3 || rows <= 0 || cols <= 0 || rows * cols > MAX_ROOMS)
+    {
+        printf("ERROR - Save file has an invalid dungeon topology\n");
+        return false;
+    }
+    if (kind == TOPOLOGY_GRID)
+    {
+        DungeonTopologyInitGrid(topology, rows, cols);
+        return true;
+    }
+    unsigned char exits[MAX_ROOMS] = {};
+    if (fgets(buffer, 256, file) == nullptr)
+    {
+        printf("ERROR - Save file has a truncated dungeon topology\n");
+        return false;
+    }
+    for (short i = 0; i < rows * cols; i++)
+    {
+        char digit = buffer[i];
+        if (digit >= '0' && digit <= '9')
+        {
+            exits[i] = (unsigned char)(digit - '0');
+        }
+        else if (digit >= 'a' && digit <= 'f')
+        {
+            exits[i] = (unsigned char)(digit - 'a' + 10);
+        }
+        else
+        {
+            printf("ERROR - Save file has a truncated dungeon topology\n");
+            return false;
+        }
     }
+    return DungeonTopologyInitLinks(topology, rows, cols, exits);
 }
 
 //--------------------
 // UTILITY FUNCTIONS
 //--------------------
 
-float RandomFloat(float min, float max)
+static RandomState* RandomGetCurrent()
+{
+    if (currentGame != nullptr) return &currentGame->random;
+    if (!fallbackRandomSeeded)
+    {
+        RandomSeed(&fallbackRandom, 1);
+        fallbackRandomSeeded = true;
+    }
+    return &fallbackRandom;
+}
+
+static unsigned int RandomRotl(unsigned int x, int k)
+{
+    return (x << k) | (x >> (32 - k));
+}
+
+// Top 24 bits as a float in [0, 1)
+static float RandomToUnitFloat(unsigned int x)
+{
+    return (float)(x >> 8) * (1.0f / 16777216.0f);
+}
+
+// Lemire's multiply-shift with rejection, unbiased for any range up to 2^32
+static unsigned int RandomBounded(RandomState* random, unsigned int range)
+{
+    unsigned long long m = (unsigned long long)RandomNextU32(random) * range;
+    unsigned int low = (unsigned int)m;
+    if (low < range)
+    {
+        unsigned int threshold = (0u - range) % range;
+        while (low < threshold)
+        {
+            m = (unsigned long long)RandomNextU32(random) * range;
+            low = (unsigned int)m;
+        }
+    }
+    return (unsigned int)(m >> 32);
+}
+
+void RandomSeed(RandomState* random, unsigned long long seed)
+{
+    if (random == nullptr) return;
+    
+    // splitmix64 expands the seed so that nearby seeds give unrelated states
+    for (short i = 0; i < 4; i += 2)
+    {
+        seed += 0x9E3779B97F4A7C15ull;
+        unsigned long long z = seed;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        z = z ^ (z >> 31);
+        random->s[i] = (unsigned int)z;
+        random->s[i + 1] = (unsigned int)(z >> 32);
+    }
+    if ((random->s[0] | random->s[1] | random->s[2] | random->s[3]) == 0)
+    {
+        random->s[0] = 1;
+    }
+}
+
+unsigned int RandomNextU32(RandomState* random)
+{
+    unsigned int* s = random->s;
+    unsigned int result = RandomRotl(s[1] * 5, 7) * 9;
+    unsigned int t = s[1] << 9;
+    
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = RandomRotl(s[3], 11);
+    
+    return result;
+}
+
+// Counter-based: the same (seed, counter) always gives the same bits, with no state to advance
+unsigned long long RandomHash(unsigned long long seed, unsigned long long counter)
 {
+    unsigned long long z = seed + (counter + 1) * 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Advances the generator by 2^64 draws
+void RandomJump(RandomState* random)
+{
+    if (random == nullptr) return;
     
+    static const unsigned int JUMP[4] = { 0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b };
+    unsigned int s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for (short i = 0; i < 4; i++)
+    {
+        for (short b = 0; b < 32; b++)
+        {
+            if (JUMP[i] & (1u << b))
+            {
+                s0 ^= random->s[0];
+                s1 ^= random->s[1];
+                s2 ^= random->s[2];
+                s3 ^= random->s[3];
+            }
+            RandomNextU32(random);
+        }
+    }
+    random->s[0] = s0;
+    random->s[1] = s1;
+    random->s[2] = s2;
+    random->s[3] = s3;
+}
+
+// Hands the parent's next 2^64 draws to the child as an independent stream
+void RandomSplit(RandomState* parent, RandomState* child)
+{
+    if (parent == nullptr || child == nullptr) return;
+    *child = *parent;
+    RandomJump(parent);
+}
 
+float RandomFloat(float min, float max)
+{
     if (min > max)
     {
         float temp = min;
         min = max;
         max = temp;
     }
+    
+    return min + RandomToUnitFloat(RandomNextU32(RandomGetCurrent())) * (max - min);
+}
 
-    float r = rand() % 10000; // NOLINT
-    r = r / 10000.0f; 
+short RandomShort(short min, short max)
+{
+    if (min > max)
+    {
+        short temp = min;
+        min = max;
+        max = temp;
+    }
+    unsigned int range = (unsigned int)(max - min) + 1;
+    return (short)(min + (int)RandomBounded(RandomGetCurrent(), range));
+}
 
-    return min + r * (max - min);
+void RandomFillFloats(float* out, short count, float min, float max)
+{
+    if (out == nullptr || count <= 0) return;
+    if (min > max)
+    {
+        float temp = min;
+        min = max;
+        max = temp;
+    }
+    
+    // Draw raw words first so the conversion loop below has no dependency chain
+    RandomState* random = RandomGetCurrent();
+    unsigned int block[64];
+    float span = max - min;
+    for (short start = 0; start < count; start += 64)
+    {
+        short n = (short)(count - start < 64 ? count - start : 64);
+        for (short i = 0; i < n; i++)
+        {
+            block[i] = RandomNextU32(random);
+        }
+        for (short i = 0; i < n; i++)
+        {
+            out[start + i] = min + RandomToUnitFloat(block[i]) * span;
+        }
+    }
 }
 
-short RandomShort(short min, short max)
+void RandomFillShorts(short* out, short count, short min, short max)
 {
+    if (out == nullptr || count <= 0) return;
     if (min > max)
     {
         short temp = min;
         min = max;
         max = temp;
     }
-    return (short)min + rand() % (max - min + 1);
+    
+    RandomState* random = RandomGetCurrent();
+    unsigned int range = (unsigned int)(max - min) + 1;
+    for (short i = 0; i < count; i++)
+    {
+        out[i] = (short)(min + (int)RandomBounded(random, range));
+    }
 }
 
 bool RandomChance(float prob)
@@ -4310,12 +4945,20 @@ short CountExploredRooms(const Dungeon* dungeon)
     {
         return 0;
     }
-    short count = 0;
-    for (short i = 0; i < MAX_ROOMS; i++)
+    int count = 0;
+    for (short i = 0; i < DUNGEON_EXPLORED_WORDS; i++)
     {
-        if (dungeon->rooms[i].explored)
-            count++;
+        count += CountBits(dungeon->explored[i]);
     }
-    return count;
+    return (short)count;
+}
+
+// Portable popcount (SWAR), so no compiler intrinsics are needed
+int CountBits(unsigned long long value)
+{
+    value = value - ((value >> 1) & 0x5555555555555555ull);
+    value = (value & 0x3333333333333333ull) + ((value >> 2) & 0x3333333333333333ull);
+    value = (value + (value >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return (int)((value * 0x0101010101010101ull) >> 56);
 }
 
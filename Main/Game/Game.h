@@ -2,6 +2,7 @@
 #define GAME_H
 
 #include <cstdio>
+#include "StringPool.h"
 
 //--------------------
 // COLOR CODES FOR TERMINAL
@@ -15,12 +16,6 @@
 #define CYAN "\x1b[36m"
 #define RESET "\x1b[0m"
 
-//--------------------
-// Clearing Screen
-//--------------------
-
-#define CLEAR_SCREEN() system("cls")
-
 //--------------------
 // CONSTANTS
 //--------------------
@@ -32,9 +27,18 @@
 #define MAX_ROOMS 35 // NOLINT(modernize-macro-to-enum)
 #define MAX_QUESTS 20 // NOLINT(modernize-macro-to-enum)
 #define MAX_INVENTORY 50 // NOLINT(modernize-macro-to-enum)
+#define INVENTORY_INDEX_BITS 7 // NOLINT(modernize-macro-to-enum)
+#define INVENTORY_INDEX_SIZE (1 << INVENTORY_INDEX_BITS) // At least twice MAX_INVENTORY so probe runs stay short
+#define INVENTORY_INDEX_EMPTY (-1)
 #define MAX_ENEMIES 10 // NOLINT(modernize-macro-to-enum)
 #define DUNGEON_ROWS 7 // NOLINT(modernize-macro-to-enum)
 #define DUNGEON_COLS 5 // NOLINT(modernize-macro-to-enum)
+#define DUNGEON_EXPLORED_WORDS ((MAX_ROOMS + 63) / 64)
+#define DUNGEON_MAX_LINKS (MAX_ROOMS * 4)
+#define ROOM_ENCOUNTER_MASK 0x07 // NOLINT(modernize-macro-to-enum)
+#define ROOM_FLAG_SHOP 0x08 // NOLINT(modernize-macro-to-enum)
+#define ROOM_FLAG_BOSS 0x10 // NOLINT(modernize-macro-to-enum)
+#define ROOM_FLAG_GENERATED 0x20 // Entered yet; see DungeonMaterializeRoom
 
 //--------------------
 // PLAYER STARTING STATS
@@ -106,6 +110,22 @@ typedef enum
     
 }EncounterType;
 
+typedef enum
+{
+    TOPOLOGY_GRID = 0,
+    TOPOLOGY_LINKS = 1,
+    
+}DungeonTopologyKind;
+
+typedef enum
+{
+    PATH_TARGET_BOSS = 0,
+    PATH_TARGET_SHOP = 1,
+    PATH_TARGET_UNEXPLORED = 2,
+    PATH_TARGET_COUNT = 3,
+    
+}PathTarget;
+
 typedef enum
 {
     NORTH = 0,
@@ -176,8 +196,8 @@ typedef struct StatusEffect //NOLINT
 typedef struct Ability
 {
     unsigned short abilityId;
-    char name[MAX_NAME_LENGTH];
-    char description[MAX_DESCRIPTION_LENGTH];
+    StringID name;
+    StringID description;
     unsigned short unlockedAtLevel;
     float damageMultiplier; //NOLINT
     int cooldown;
@@ -211,7 +231,7 @@ typedef struct Player
 typedef struct Enemy //NOLINT
 {
     short enemyID;
-    char name[MAX_NAME_LENGTH];
+    StringID name;
     short baseHealth;
     short health;
     short attack;
@@ -224,46 +244,108 @@ typedef struct Enemy //NOLINT
     short statusEffectCount;
 }Enemy;
 //Item struct - data
+// Only the fields inventory, shop and valuation loops read are stored inline; name and
+// description are string pool handles that display and save code resolve. The description is
+// usually a format expanded with value, see ItemGetDescription.
 typedef struct ItemData//NOLINT
 {
     short itemID;
-    char name[MAX_NAME_LENGTH];
-    char description[MAX_DESCRIPTION_LENGTH];
-    ItemRarity rarity;
-    ItemType type;
     short value;
     short cost;
     short quantity;
-    
+    StringID name;
+    StringID description;
+    ItemRarity rarity;
+    ItemType type;
 }Item;
 
-typedef struct InventoryNode
-{
-    Item item;
-    struct InventoryNode* next;
-}InventoryNode;
-
+// Items are packed at the front of items[]; index maps an itemID to its position by open addressing.
+// Removing an item moves the last one into the gap, so the order is insertion order only until then.
 typedef struct Inventory //NOLINT
 {
-    InventoryNode* head;
+    Item items[MAX_INVENTORY];
     short itemCount;
+    short index[INVENTORY_INDEX_SIZE]; // Position in items, or INVENTORY_INDEX_EMPTY
 }Inventory;
 
+// Packed so the whole map is a few cache lines: the ID is 1000 + index (DungeonGetRoomID), exits
+// come from the dungeon's topology and explored lives in a bitset on the Dungeon. Read and write
+// the fields through the Room and Dungeon accessors.
 typedef struct Room //NOLINT
 {
-    short roomID;
-    char description[MAX_DESCRIPTION_LENGTH];
-    EncounterType encounterType; //NOLINT
-    short connections[4];
-    bool hasShop;
-    bool hasBoss;
-    bool explored;
+    StringID description;
+    unsigned char state; // EncounterType in ROOM_ENCOUNTER_MASK, plus ROOM_FLAG_*
+    unsigned char difficulty; // Tier of the gradient from the start, added to enemy levels
 }Room;
 
+typedef struct DungeonLink
+{
+    short room;
+    short direction; // Direction taken to get there
+}DungeonLink;
+
+// How rooms connect. Rooms always sit on a rows x cols grid, which is what the map draws. A grid
+// topology stores nothing else: every in-bounds neighbour is connected. A links topology is
+// compressed sparse rows over the same cells, for carved layouts with walls, corridors and dead
+// ends; a cell with no links is solid rock. Go through DungeonTopologyStep/Neighbours either way.
+typedef struct DungeonTopology
+{
+    short kind; // DungeonTopologyKind
+    short rows;
+    short cols;
+    short linkCount;
+    unsigned short firstLink[MAX_ROOMS + 1]; // Links of room i are links[firstLink[i]] up to links[firstLink[i + 1]]
+    DungeonLink links[DUNGEON_MAX_LINKS];
+}DungeonTopology;
+
+// Knobs for DungeonGenerate. Percentages run 0-100; the four encounter shares split the ordinary
+// rooms and whatever they leave over is empty.
+typedef struct DungeonGenParams
+{
+    short rows;
+    short cols;
+    unsigned char fillPercent; // Cells carved into rooms, 100 = every cell
+    unsigned char loopPercent; // Chance to open each wall left between two rooms after carving
+    unsigned char enemyPercent;
+    unsigned char treasurePercent;
+    unsigned char questPercent;
+    unsigned char shopPercent;
+    unsigned char difficultyTiers; // Steps from the start to the boss room, 1 = flat
+    unsigned char minBossDistance; // Moves from the start; shorter layouts are carved again
+}DungeonGenParams;
+
+// Distance from every room to the nearest room of one PathTarget, and the first step on the way
+typedef struct DungeonPathField
+{
+    unsigned long long targets[DUNGEON_EXPLORED_WORDS]; // Bit per room the field was built towards
+    unsigned char distance[MAX_ROOMS]; // Moves to the nearest target, PATH_UNREACHABLE when none
+    signed char step[MAX_ROOMS]; // Direction to take, -1 on a target or when none is reachable
+    bool dirty;
+}DungeonPathField;
+
+// Derived from the rooms and topology, so kept in the GameInstance rather than the saved Dungeon.
+// A zeroed cache is unbuilt and fills on first query.
+typedef struct DungeonPaths
+{
+    DungeonPathField fields[PATH_TARGET_COUNT];
+    DungeonTopology topology; // What the fields were searched over
+    unsigned int generation; // Dungeon::generation the targets were last checked against
+    bool built;
+}DungeonPaths;
+
+// Layout and every room's content follow from seed and params (DungeonGenerate), so saves only
+// keep the rooms the player has entered. Rooms not entered yet hold their planned encounter but
+// keep the description placeholder.
 typedef struct Dungeon //NOLINT
 {
     Room rooms[MAX_ROOMS];
+    unsigned long long explored[DUNGEON_EXPLORED_WORDS]; // Bit per room
     short totalRooms;
+    short bossRoom;
+    unsigned int seed;
+    DungeonGenParams params;
+    DungeonTopology topology;
+    unsigned int generation; // New value on every change to a room or the layout, see DungeonBumpGeneration
 }Dungeon;
 
 typedef struct QuestData  // NOLINT(clang-diagnostic-padded)
@@ -302,6 +384,14 @@ typedef struct GameStatistics
     unsigned short deathCount;
 }GameStats;
 
+// xoshiro128** generator state
+typedef struct RandomState
+{
+    unsigned int s[4];
+}RandomState;
+
+struct Autosave;
+
 struct GameInstance //NOLINT(clang-diagnostic-padded)
 {
     GameState currentState;
@@ -316,6 +406,10 @@ struct GameInstance //NOLINT(clang-diagnostic-padded)
     Ability abilityList[MAX_ABILITIES];  // NOLINT(clang-diagnostic-padded)
     short abilityCount;
     bool isRunning;
+    RandomState random; // Per-game RNG so games can run side by side
+    short nextItemID;
+    Autosave* autosave; // Started by the first save of a session; writes happen off the game thread
+    DungeonPaths paths; // Travel routes over the dungeon, see DungeonPath.h
 };
 
 //--------------------
@@ -324,6 +418,8 @@ struct GameInstance //NOLINT(clang-diagnostic-padded)
 
 GameInstance* GameInit();
 void GameFree(GameInstance* game);
+void GameSetSeed(GameInstance* game, unsigned long long seed);
+void GameMakeCurrent(GameInstance* game);
 void GameRun(GameInstance* game);
 GameState GameShowMainMenu();
 void GameHandleCharacterCreation(GameInstance* game);
@@ -332,8 +428,10 @@ void GameHandleGameLoop(GameInstance* game);
 void GameHandlePauseMenu(GameInstance* game);
 GameStatus GameCheckGameStatus(GameInstance* game);
 void GameHandleEncounter(GameInstance* game);
+void GameAutoTravel(GameInstance* game, PathTarget target);
 void GameInitializeEnemies(GameInstance* game);
 void GameInitializeAbilities(GameInstance* game);
+void GameInitStrings();
 
 //--------------------
 // PLAYER FUNCTIONS
@@ -361,9 +459,9 @@ void PlayerGainGold(Player* player, unsigned short gold);
 
 Enemy* EnemyInit(GameInstance* game, short enemyID);
 Enemy* EnemyGenerateForLevel(GameInstance* game, unsigned short playerLevel);
+void EnemyScaleToLevel(Enemy* enemy, unsigned short playerLevel);
 void EnemyDisplayStats(Enemy* enemy);
 bool EnemyIsAlive(Enemy* enemy);
-void EnemyUpdateStatusEffects(Enemy* enemy);
 void EnemyApplyStatusEffect(Enemy* enemy, StatusEffect effect);
 void EnemyDamage(Enemy* enemy, unsigned short damage);
 void EnemyHeal(Enemy* enemy, short heal);
@@ -377,6 +475,7 @@ void ItemApplyEffect(ItemData* item, Player* player);
 const char* ItemGetTypeName(ItemType type);
 const char* ItemGetRarityName(ItemRarity rarity);
 void ItemDisplay(ItemData* item);
+const char* ItemGetDescription(const ItemData* item, char* buffer, size_t bufferSize);
 ItemData ItemGenerateTreasure(unsigned short playerLevel);
 ItemData ItemGenerateRandom(ItemRarity rarity, ItemType type);
 
@@ -391,11 +490,32 @@ void DungeonDisplayRoom(Player* player, Dungeon* dungeon);
 void DungeonDisplayActionMenu();
 void DungeonMoveToRoom(Player* player, Dungeon* dungeon, Direction direction);
 Direction DungeonGetDirectionInput();
+PathTarget DungeonGetTravelTargetInput();
 const char* DungeonGetDirectionName(Direction dir);
 void DungeonDisplayMap(Player* player, Dungeon* dungeon);
 short DungeonGetRoomIndex(short row, short col);
-void DungeonGenerateRooms(Dungeon* dungeon);
-void DungeonGenerateConnections(Dungeon* dungeon);
+bool DungeonGenerateRooms(Dungeon* dungeon);
+short DungeonGetRoomID(short roomIndex);
+short DungeonGetConnection(const Dungeon* dungeon, short roomIndex, Direction direction);
+short DungeonGetNeighbours(const Dungeon* dungeon, short roomIndex, DungeonLink* out);
+bool DungeonHasRoom(const Dungeon* dungeon, short roomIndex);
+short DungeonCountRooms(const Dungeon* dungeon);
+void DungeonTopologyInitGrid(DungeonTopology* topology, short rows, short cols);
+bool DungeonTopologyInitLinks(DungeonTopology* topology, short rows, short cols, const unsigned char* exits);
+short DungeonTopologyStep(const DungeonTopology* topology, short roomIndex, Direction direction);
+short DungeonTopologyNeighbours(const DungeonTopology* topology, short roomIndex, DungeonLink* out);
+unsigned char DungeonTopologyGetExits(const DungeonTopology* topology, short roomIndex);
+bool DungeonIsExplored(const Dungeon* dungeon, short roomIndex);
+void DungeonSetExplored(Dungeon* dungeon, short roomIndex);
+void DungeonBumpGeneration(Dungeon* dungeon);
+EncounterType RoomGetEncounter(const Room* room);
+void RoomSetEncounter(Room* room, EncounterType encounter);
+bool RoomHasShop(const Room* room);
+bool RoomHasBoss(const Room* room);
+void RoomSetBoss(Room* room, bool hasBoss);
+bool RoomIsGenerated(const Room* room);
+Room* DungeonMaterializeRoom(Dungeon* dungeon, short roomIndex);
+StringID DungeonGetRoomDescription(int roomIndex);
 
 //--------------------
 // COMBAT FUNCTIONS
@@ -403,13 +523,8 @@ void DungeonGenerateConnections(Dungeon* dungeon);
 
 CombatResult CombatStart(Player* player, Enemy* enemy, GameInstance* game);
 void CombatAwardVictory(Player* player, Enemy* enemy, GameInstance* game);
+void CombatDisplayScreen(Player* player, Enemy* enemy);
 void CombatDisplayMenu(Player* player, Enemy* enemy);
-void CombatPlayerAttack(Player* player, Enemy* enemy, GameInstance* game);
-void CombatEnemyAttack(Player* player, Enemy* enemy, GameInstance* game);
-void CombatUseAbility(Player* player, Enemy* enemy, GameInstance* game);
-void CombatUseItem(Player* player, Enemy* enemy, GameInstance* game);
-bool CombatAttemptEscape(Player* player);
-void CombatUpdateCooldowns(Player* player);
 unsigned short CombatCalculateDamage(unsigned short attack, unsigned short defense, float multiplier);
 
 //--------------------
@@ -418,9 +533,11 @@ unsigned short CombatCalculateDamage(unsigned short attack, unsigned short defen
 
 Inventory* InventoryCreate();
 void InventoryFree(Inventory* inventory);
+void InventoryRebuildIndex(Inventory* inventory);
 bool InventoryAddItem(Inventory* inventory, ItemData item);
 bool InventoryRemoveItem(Inventory* inventory, short itemID);
 ItemData* InventoryFindItem(Inventory* inventory, short itemID);
+ItemData* InventoryFindFirstOfType(Inventory* inventory, ItemType type);
 void InventoryDisplay(Inventory* inventory);
 void InventoryUseItem(Inventory* inventory, Player* player, short itemID);
 bool InventoryIsFull(Inventory* inventory);
@@ -466,8 +583,12 @@ void ShopMenu(Shop* shop, Player* player, Inventory* inventory);
 // FILE I/O FUNCTIONS
 //--------------------
 
+bool GameSave(GameInstance* game);
+bool GameAutosave(GameInstance* game);
 bool FileSaveGame(Player* player, Inventory* inventory, QuestLog* questLog, GameStatistics* stats, Dungeon* dungeon);
 bool FileLoadGame(Player** player, Inventory** inventory, QuestLog** questLog, GameStatistics** stats, Dungeon** dungeon);
+bool FileSaveGameText(const char* path, Player* player, Inventory* inventory, QuestLog* questLog, GameStatistics* stats, Dungeon* dungeon);
+bool FileLoadGameText(const char* path, Player** player, Inventory** inventory, QuestLog** questLog, GameStatistics** stats, Dungeon** dungeon);
 void FileWritePlayer(FILE* file, Player* player);
 void FileReadPlayer(FILE* file, Player** player);
 void FileWriteInventory(FILE* file, Inventory* inventory);
@@ -477,7 +598,7 @@ void FileReadQuests(FILE* file, QuestLog** questLog);
 void FileWriteStats(FILE* file, GameStatistics* stats);
 void FileReadStats(FILE* file, GameStatistics** stats);
 void FileWriteDungeon(FILE* file, Dungeon* dungeon);
-void FileReadDungeon(FILE* file, Dungeon** dungeon);
+bool FileReadDungeon(FILE* file, Dungeon** dungeon);
 
 //--------------------
 // UTILITY FUNCTIONS
@@ -486,6 +607,14 @@ void FileReadDungeon(FILE* file, Dungeon** dungeon);
 float RandomFloat(float min, float max);
 short RandomShort(short min, short max);
 bool RandomChance(float prob);
+void RandomFillFloats(float* out, short count, float min, float max);
+void RandomFillShorts(short* out, short count, short min, short max);
+void RandomSeed(RandomState* random, unsigned long long seed);
+unsigned int RandomNextU32(RandomState* random);
+unsigned long long RandomHash(unsigned long long seed, unsigned long long counter);
+void RandomJump(RandomState* random);
+void RandomSplit(RandomState* parent, RandomState* child);
 short CountExploredRooms(const Dungeon* dungeon);
+int CountBits(unsigned long long value);
 
 #endif
\ No newline at end of file
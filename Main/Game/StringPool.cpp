@@ -0,0 +1,118 @@
+﻿#include "StringPool.h"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+
+//--------------------
+// STORAGE
+//--------------------
+
+// Handle 0 is the empty string: zero-initialised storage already holds it at offset 0
+static char stringPoolText[STRING_POOL_BYTES];
+static unsigned int stringPoolOffsets[STRING_POOL_CAPACITY];
+static unsigned int stringPoolHashes[STRING_POOL_CAPACITY];
+static std::atomic<bool> stringPoolFormats[STRING_POOL_CAPACITY];
+static std::atomic<unsigned short> stringPoolSlots[STRING_POOL_SLOTS]; // Handles, STRING_NONE when empty
+static std::atomic<unsigned int> stringPoolCount(1);
+static size_t stringPoolUsed = 1;
+static std::mutex stringPoolLock;
+
+static unsigned int StringPoolHash(const char* text, size_t* length)
+{
+    unsigned int hash = 2166136261u;
+    const char* c = text;
+    for (; *c != '\0'; c++)
+    {
+        hash ^= (unsigned char)*c;
+        hash *= 16777619u;
+    }
+    *length = (size_t)(c - text);
+    return hash;
+}
+
+// Walks the probe run for text. Returns its handle, or STRING_NONE with *slot left at the empty
+// slot that ends the run. Slots are published last, so whatever a loaded handle points at is complete.
+static StringID StringPoolFind(const char* text, unsigned int hash, unsigned int* slot)
+{
+    *slot = hash & (STRING_POOL_SLOTS - 1);
+    while (true)
+    {
+        StringID id = stringPoolSlots[*slot].load(std::memory_order_acquire);
+        if (id == STRING_NONE) return STRING_NONE;
+        if (stringPoolHashes[id] == hash && strcmp(stringPoolText + stringPoolOffsets[id], text) == 0) return id;
+        *slot = (*slot + 1) & (STRING_POOL_SLOTS - 1);
+    }
+}
+
+//--------------------
+// STRING POOL FUNCTIONS
+//--------------------
+
+StringID StringPoolIntern(const char* text)
+{
+    if (text == nullptr || text[0] == '\0') return STRING_NONE;
+
+    size_t length;
+    unsigned int hash = StringPoolHash(text, &length);
+    unsigned int slot;
+    StringID id = StringPoolFind(text, hash, &slot);
+    if (id != STRING_NONE) return id;
+
+    std::lock_guard<std::mutex> guard(stringPoolLock);
+    // Another thread may have added it while this one waited for the lock
+    id = StringPoolFind(text, hash, &slot);
+    if (id != STRING_NONE) return id;
+
+    unsigned int count = stringPoolCount.load(std::memory_order_relaxed);
+    if (count >= STRING_POOL_CAPACITY || stringPoolUsed + length + 1 > STRING_POOL_BYTES)
+    {
+        printf("ERROR - String pool is full\n");
+        return STRING_NONE;
+    }
+
+    memcpy(stringPoolText + stringPoolUsed, text, length + 1);
+    stringPoolOffsets[count] = (unsigned int)stringPoolUsed;
+    stringPoolHashes[count] = hash;
+    stringPoolUsed += length + 1;
+    stringPoolCount.store(count + 1, std::memory_order_release);
+    stringPoolSlots[slot].store((StringID)count, std::memory_order_release);
+    return (StringID)count;
+}
+
+StringID StringPoolInternFormat(const char* format)
+{
+    StringID id = StringPoolIntern(format);
+    if (id != STRING_NONE) stringPoolFormats[id].store(true, std::memory_order_release);
+    return id;
+}
+
+const char* StringPoolGet(StringID id)
+{
+    if (id >= stringPoolCount.load(std::memory_order_acquire)) return "";
+    return stringPoolText + stringPoolOffsets[id];
+}
+
+// Expands a format entry into buffer; plain entries are returned as they are
+const char* StringPoolFormat(StringID id, int argument, char* buffer, size_t bufferSize)
+{
+    if (!StringPoolIsFormat(id)) return StringPoolGet(id);
+    sprintf_s(buffer, bufferSize, StringPoolGet(id), argument);
+    return buffer;
+}
+
+bool StringPoolIsFormat(StringID id)
+{
+    return id < STRING_POOL_CAPACITY && stringPoolFormats[id].load(std::memory_order_acquire);
+}
+
+unsigned int StringPoolCount()
+{
+    return stringPoolCount.load(std::memory_order_acquire);
+}
+
+size_t StringPoolBytes()
+{
+    std::lock_guard<std::mutex> guard(stringPoolLock);
+    return stringPoolUsed;
+}
@@ -0,0 +1,37 @@
+﻿#pragma once
+
+#include <cstddef>
+
+//--------------------
+// STRING POOL CONSTANTS
+//--------------------
+
+#define STRING_POOL_CAPACITY 4096 // NOLINT(modernize-macro-to-enum)
+#define STRING_POOL_BYTES (128 * 1024)
+#define STRING_POOL_SLOTS 8192 // Hash slots; a power of two, at least twice the capacity
+#define STRING_NONE 0 // Handle of the empty string
+
+typedef unsigned short StringID;
+
+//--------------------
+// STRING POOL FUNCTIONS
+//--------------------
+
+//
+// Process-wide table of interned text. Equal strings always get the same handle, so structs store
+// a 16-bit StringID instead of a character buffer and handles can be compared instead of text.
+// Entries are never moved or removed: StringPoolGet is safe from any thread, and interning only
+// takes a lock when the string is not in the pool yet. Handles are only meaningful inside the
+// process that made them; anything written to disk stores the text.
+//
+// Game text is interned once at startup, so generation only copies handles around. Text that
+// depends on a number is interned as a format with a single %d and only expanded by
+// StringPoolFormat when it is shown or saved. Plain text is never used as a format string.
+//
+StringID StringPoolIntern(const char* text);
+StringID StringPoolInternFormat(const char* format);
+const char* StringPoolGet(StringID id);
+const char* StringPoolFormat(StringID id, int argument, char* buffer, size_t bufferSize);
+bool StringPoolIsFormat(StringID id);
+unsigned int StringPoolCount();
+size_t StringPoolBytes();
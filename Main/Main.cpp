@@ -1,13 +1,157 @@
 #include <cstdio>
-#include <windows.h>
+#include <cstdlib>
+#include <cstring>
 #include "Game/Game.h"
+#include "Game/CombatOdds.h"
+#include "Bench/Bench.h"
+#include "Sim/Sim.h"
+#include "UI/Input.h"
+#include "UI/Scheduler.h"
+#include "UI/Terminal.h"
+
+static int RunSimulation(int argc, char* argv[])
+{
+    SimConfig config = {};
+    config.gameCount = 100;
+    config.maxTurns = SIM_DEFAULT_MAX_TURNS;
+    
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--simulate") == 0 && i + 1 < argc)
+        {
+            config.gameCount = (unsigned int)strtoul(argv[++i], nullptr, 10);
+        }
+        else if (strcmp(argv[i], "--max-turns") == 0 && i + 1 < argc)
+        {
+            config.maxTurns = (unsigned int)strtoul(argv[++i], nullptr, 10);
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+        {
+            config.threadCount = (unsigned int)strtoul(argv[++i], nullptr, 10);
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            config.baseSeed = (unsigned int)strtoul(argv[++i], nullptr, 10);
+        }
+    }
+    
+    // Game output goes to the null device so only the report reaches the console
+    if (!UI::UI_RedirectOutputToNull())
+    {
+        printf("Failed to redirect output, simulation will print every screen.\n");
+    }
+    SimResult result;
+    bool ok = SimRunBatch(&config, &result);
+    UI::UI_RestoreOutput();
+    
+    if (!ok)
+    {
+        printf("Simulation failed\nExiting..\n");
+        return 1;
+    }
+    SimPrintReport(&result);
+    return 0;
+}
+
+static int RunBenchmark(int argc, char* argv[])
+{
+    const char* name = nullptr;
+    unsigned int iterations = 0;
+    
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--bench") == 0 && i + 1 < argc)
+        {
+            name = argv[++i];
+        }
+        else if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc)
+        {
+            iterations = (unsigned int)strtoul(argv[++i], nullptr, 10);
+        }
+    }
+    
+    return BenchRun(name, iterations) ? 0 : 1;
+}
+
+static int RunOdds(int argc, char* argv[])
+{
+    CombatPolicy policy = CombatPolicyGreedy;
+    const char* policyName = "greedy";
+    unsigned int verifyFights = 0;
+    
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--policy") == 0 && i + 1 < argc)
+        {
+            policyName = argv[++i];
+            if (strcmp(policyName, "attack") == 0)
+            {
+                policy = CombatPolicyAttack;
+            }
+            else if (strcmp(policyName, "cautious") == 0)
+            {
+                policy = CombatPolicyCautious;
+            }
+            else if (strcmp(policyName, "greedy") != 0)
+            {
+                printf("Unknown policy %s, expected attack, greedy or cautious\n", policyName);
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--verify") == 0 && i + 1 < argc)
+        {
+            verifyFights = (unsigned int)strtoul(argv[++i], nullptr, 10);
+        }
+    }
+    
+    GameInstance* game = GameInit();
+    if (!game)
+    {
+        printf("Failed to initialize game\nExiting..\n");
+        return 1;
+    }
+    CombatOddsReport(game, policy, policyName, verifyFights);
+    GameFree(game);
+    return 0;
+}
 
 int main(int argc, char* argv[])
 {
 
-    SetConsoleCP(65001);
-    SetConsoleOutputCP(65001);
+    TerminalInit();
+    GameInitStrings();
+    
+    const char* scriptPath = nullptr;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--simulate") == 0)
+        {
+            return RunSimulation(argc, argv);
+        }
+        if (strcmp(argv[i], "--bench") == 0)
+        {
+            return RunBenchmark(argc, argv);
+        }
+        if (strcmp(argv[i], "--odds") == 0)
+        {
+            return RunOdds(argc, argv);
+        }
+        if (strcmp(argv[i], "--script") == 0 && i + 1 < argc)
+        {
+            scriptPath = argv[++i];
+        }
+        if (strcmp(argv[i], "--time-scale") == 0 && i + 1 < argc)
+        {
+            SchedulerSetTimeScale(strtof(argv[++i], nullptr));
+        }
+    }
     
+    UI::UI_EnableFrameBuffer();
+    InputInit();
+    if (scriptPath != nullptr && !InputOpenScript(scriptPath))
+    {
+        return 1;
+    }
     GameInstance* game = GameInit();
     if (!game)
     {
@@ -18,6 +162,7 @@ int main(int argc, char* argv[])
     GameRun(game);
     
     GameFree(game);
+    InputShutdown();
     
     return 0;
 }
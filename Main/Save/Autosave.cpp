@@ -0,0 +1,278 @@
+#include "Autosave.h"
+#include "Journal.h"
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+//--------------------
+// SNAPSHOT BLOCKS
+//--------------------
+
+// Immutable copy of one part of the game, shared between snapshots while it stays unchanged.
+// Reference counts are only touched with the autosave lock held.
+typedef struct AutosaveBlock
+{
+    int refs;
+    size_t size;
+}AutosaveBlock;
+
+typedef struct AutosaveSnapshot
+{
+    AutosaveBlock* player;
+    AutosaveBlock* dungeon;
+    AutosaveBlock* questLog;
+    AutosaveBlock* stats;
+    AutosaveBlock* items;
+}AutosaveSnapshot;
+
+struct Autosave
+{
+    std::thread writer;
+    std::mutex lock;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    bool stopping;
+    bool writing;
+    bool hasPending;
+    bool failurePending;
+    AutosaveSnapshot pending;
+    AutosaveSnapshot last; // Newest snapshot taken, kept so the next one can share with it
+    AutosaveStats stats;
+
+    // Writer thread only
+    SaveJournal* journal;
+    const char* snapshotPath;
+    const char* journalPath;
+};
+
+static void* AutosaveBlockData(AutosaveBlock* block)
+{
+    return block + 1;
+}
+
+// Reuses previous if its bytes match, otherwise copies source into a new block
+static AutosaveBlock* AutosaveShareOrCopy(AutosaveBlock* previous, const void* source, size_t size, AutosaveStats* counts)
+{
+    if (previous != nullptr && previous->size == size && memcmp(AutosaveBlockData(previous), source, size) == 0)
+    {
+        counts->bytesShared += size;
+        return previous;
+    }
+
+    AutosaveBlock* block = (AutosaveBlock*)malloc(sizeof(AutosaveBlock) + size);
+    if (block == nullptr)
+    {
+        printf("ERROR - Failed to allocate autosave snapshot\n");
+        return nullptr;
+    }
+    block->refs = 0;
+    block->size = size;
+    if (size > 0) memcpy(AutosaveBlockData(block), source, size);
+    counts->bytesCopied += size;
+    return block;
+}
+
+static void AutosaveRetain(AutosaveSnapshot* snapshot)
+{
+    AutosaveBlock* blocks[] = { snapshot->player, snapshot->dungeon, snapshot->questLog, snapshot->stats, snapshot->items };
+    for (AutosaveBlock* block : blocks)
+    {
+        if (block != nullptr) block->refs++;
+    }
+}
+
+static void AutosaveRelease(AutosaveSnapshot* snapshot)
+{
+    AutosaveBlock* blocks[] = { snapshot->player, snapshot->dungeon, snapshot->questLog, snapshot->stats, snapshot->items };
+    for (AutosaveBlock* block : blocks)
+    {
+        if (block != nullptr && --block->refs == 0) free(block);
+    }
+    memset(snapshot, 0, sizeof(AutosaveSnapshot));
+}
+
+// Blocks that were freshly copied and never retained
+static void AutosaveDiscard(AutosaveSnapshot* snapshot)
+{
+    AutosaveBlock* blocks[] = { snapshot->player, snapshot->dungeon, snapshot->questLog, snapshot->stats, snapshot->items };
+    for (AutosaveBlock* block : blocks)
+    {
+        if (block != nullptr && block->refs == 0) free(block);
+    }
+}
+
+//--------------------
+// WRITER THREAD
+//--------------------
+
+static bool AutosaveWrite(Autosave* autosave, AutosaveSnapshot* snapshot)
+{
+    Player* player = (Player*)AutosaveBlockData(snapshot->player);
+    Dungeon* dungeon = (Dungeon*)AutosaveBlockData(snapshot->dungeon);
+    QuestLog* questLog = (QuestLog*)AutosaveBlockData(snapshot->questLog);
+    GameStats* stats = (GameStats*)AutosaveBlockData(snapshot->stats);
+    const ItemData* items = (const ItemData*)AutosaveBlockData(snapshot->items);
+    short itemCount = (short)(snapshot->items->size / sizeof(ItemData));
+
+    // The journal diffs against an inventory, so rebuild one here rather than on the game thread
+    Inventory* inventory = InventoryCreate();
+    if (inventory == nullptr) return false;
+    memcpy(inventory->items, items, sizeof(ItemData) * itemCount);
+    inventory->itemCount = itemCount;
+    InventoryRebuildIndex(inventory);
+
+    bool written;
+    if (autosave->journal == nullptr)
+    {
+        autosave->journal = SaveJournalOpen(autosave->snapshotPath, autosave->journalPath, player, inventory, questLog, stats, dungeon);
+        if (autosave->journal != nullptr) autosave->journal->durable = true;
+        written = autosave->journal != nullptr;
+    }
+    else
+    {
+        written = SaveJournalCommit(autosave->journal, player, inventory, questLog, stats, dungeon);
+    }
+
+    InventoryFree(inventory);
+    return written;
+}
+
+static void AutosaveWriterLoop(Autosave* autosave)
+{
+    std::unique_lock<std::mutex> guard(autosave->lock);
+    while (true)
+    {
+        autosave->wake.wait(guard, [autosave] { return autosave->hasPending || autosave->stopping; });
+        if (!autosave->hasPending) break; // Stopping with nothing left to write
+
+        AutosaveSnapshot snapshot = autosave->pending;
+        autosave->hasPending = false;
+        autosave->writing = true;
+
+        guard.unlock();
+        bool written = AutosaveWrite(autosave, &snapshot);
+        guard.lock();
+
+        AutosaveRelease(&snapshot);
+        autosave->writing = false;
+        if (written)
+        {
+            autosave->stats.written++;
+        }
+        else
+        {
+            autosave->stats.failed++;
+            autosave->failurePending = true;
+        }
+        autosave->idle.notify_all();
+    }
+}
+
+//--------------------
+// AUTOSAVE FUNCTIONS
+//--------------------
+
+Autosave* AutosaveStart(const char* snapshotPath, const char* journalPath)
+{
+    Autosave* autosave = new Autosave();
+    autosave->stopping = false;
+    autosave->writing = false;
+    autosave->hasPending = false;
+    autosave->failurePending = false;
+    memset(&autosave->pending, 0, sizeof(AutosaveSnapshot));
+    memset(&autosave->last, 0, sizeof(AutosaveSnapshot));
+    memset(&autosave->stats, 0, sizeof(AutosaveStats));
+    autosave->journal = nullptr;
+    autosave->snapshotPath = snapshotPath;
+    autosave->journalPath = journalPath;
+    autosave->writer = std::thread(AutosaveWriterLoop, autosave);
+    return autosave;
+}
+
+bool AutosaveQueue(Autosave* autosave, GameInstance* game)
+{
+    if (autosave == nullptr || game == nullptr || game->player == nullptr || game->dungeon == nullptr ||
+        game->questLog == nullptr || game->stats == nullptr || game->inventory == nullptr)
+    {
+        return false;
+    }
+
+    // Only the game thread replaces last, so it can be compared against without the lock
+    AutosaveStats counts = {};
+    AutosaveSnapshot next;
+    next.player = AutosaveShareOrCopy(autosave->last.player, game->player, sizeof(Player), &counts);
+    next.dungeon = AutosaveShareOrCopy(autosave->last.dungeon, game->dungeon, sizeof(Dungeon), &counts);
+    next.questLog = AutosaveShareOrCopy(autosave->last.questLog, game->questLog, sizeof(QuestLog), &counts);
+    next.stats = AutosaveShareOrCopy(autosave->last.stats, game->stats, sizeof(GameStats), &counts);
+    next.items = AutosaveShareOrCopy(autosave->last.items, game->inventory->items, sizeof(ItemData) * game->inventory->itemCount, &counts);
+
+    std::lock_guard<std::mutex> guard(autosave->lock);
+    if (next.player == nullptr || next.dungeon == nullptr || next.questLog == nullptr || next.stats == nullptr || next.items == nullptr)
+    {
+        AutosaveDiscard(&next);
+        return false;
+    }
+
+    autosave->stats.bytesCopied += counts.bytesCopied;
+    autosave->stats.bytesShared += counts.bytesShared;
+    AutosaveRetain(&next);
+    AutosaveRelease(&autosave->last);
+    autosave->last = next;
+
+    if (autosave->hasPending)
+    {
+        AutosaveRelease(&autosave->pending);
+        autosave->stats.coalesced++;
+    }
+    AutosaveRetain(&next);
+    autosave->pending = next;
+    autosave->hasPending = true;
+    autosave->stats.queued++;
+    autosave->wake.notify_one();
+    return true;
+}
+
+// Blocks until everything queued so far is on disk
+void AutosaveFlush(Autosave* autosave)
+{
+    if (autosave == nullptr) return;
+    std::unique_lock<std::mutex> guard(autosave->lock);
+    autosave->idle.wait(guard, [autosave] { return !autosave->hasPending && !autosave->writing; });
+}
+
+// Writes whatever is still queued, then shuts the writer down
+void AutosaveStop(Autosave* autosave)
+{
+    if (autosave == nullptr) return;
+    {
+        std::lock_guard<std::mutex> guard(autosave->lock);
+        autosave->stopping = true;
+        autosave->wake.notify_one();
+    }
+    autosave->writer.join();
+
+    AutosaveRelease(&autosave->last);
+    SaveJournalClose(autosave->journal);
+    delete autosave;
+}
+
+// Reports a failed background write once, so the game can warn on its next turn
+bool AutosaveTakeFailure(Autosave* autosave)
+{
+    if (autosave == nullptr) return false;
+    std::lock_guard<std::mutex> guard(autosave->lock);
+    bool failed = autosave->failurePending;
+    autosave->failurePending = false;
+    return failed;
+}
+
+AutosaveStats AutosaveGetStats(Autosave* autosave)
+{
+    AutosaveStats stats = {};
+    if (autosave == nullptr) return stats;
+    std::lock_guard<std::mutex> guard(autosave->lock);
+    return autosave->stats;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "../Game/Game.h"
+
+//--------------------
+// AUTOSAVE STRUCTS
+//--------------------
+
+// Opaque: owns the writer thread and its queue
+typedef struct Autosave Autosave;
+
+typedef struct AutosaveStats
+{
+    unsigned int queued;
+    unsigned int written;
+    unsigned int coalesced; // Replaced by a newer snapshot before the writer got to them
+    unsigned int failed;
+    unsigned long long bytesCopied;
+    unsigned long long bytesShared; // Parts reused from the previous snapshot instead of copied
+}AutosaveStats;
+
+//--------------------
+// AUTOSAVE FUNCTIONS
+//--------------------
+
+//
+// Background saving. AutosaveQueue runs on the game thread and only takes a snapshot: parts of
+// the game that did not change since the last snapshot are shared, the rest are copied. A
+// writer thread then commits the newest snapshot to the save journal, syncing it to disk, so
+// the game loop never waits on I/O. If the writer is busy, older queued snapshots are dropped.
+//
+Autosave* AutosaveStart(const char* snapshotPath, const char* journalPath);
+bool AutosaveQueue(Autosave* autosave, GameInstance* game);
+void AutosaveFlush(Autosave* autosave);
+void AutosaveStop(Autosave* autosave);
+bool AutosaveTakeFailure(Autosave* autosave);
+AutosaveStats AutosaveGetStats(Autosave* autosave);
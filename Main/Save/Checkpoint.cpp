@@ -0,0 +1,412 @@
+#include "Checkpoint.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <windows.h>
+
+//--------------------
+// LAYOUT
+//--------------------
+
+// FNV-1a over the sizes that decide the record layout. A pack written by a build with
+// different struct sizes or limits is rejected instead of being misread.
+static unsigned int CheckpointLayoutHash()
+{
+    const unsigned int sizes[] = {
+        (unsigned int)sizeof(CheckpointRecord), (unsigned int)sizeof(Player), (unsigned int)sizeof(QuestLog),
+        (unsigned int)sizeof(GameStats), (unsigned int)sizeof(Dungeon), (unsigned int)sizeof(Item),
+        (unsigned int)sizeof(Ability), (unsigned int)sizeof(StatusEffect), (unsigned int)sizeof(Room),
+        MAX_ROOMS, MAX_QUESTS, MAX_INVENTORY, MAX_ABILITIES, CHECKPOINT_VERSION
+    };
+
+    unsigned int hash = 2166136261u;
+    for (unsigned int size : sizes)
+    {
+        for (int shift = 0; shift < 32; shift += 8)
+        {
+            hash ^= (size >> shift) & 0xFF;
+            hash *= 16777619u;
+        }
+    }
+    return hash;
+}
+
+static void CheckpointPutU32(unsigned char* out, unsigned int value)
+{
+    out[0] = (unsigned char)(value & 0xFF);
+    out[1] = (unsigned char)((value >> 8) & 0xFF);
+    out[2] = (unsigned char)((value >> 16) & 0xFF);
+    out[3] = (unsigned char)(value >> 24);
+}
+
+static unsigned int CheckpointGetU32(const unsigned char* in)
+{
+    return (unsigned int)in[0] | (unsigned int)in[1] << 8 | (unsigned int)in[2] << 16 | (unsigned int)in[3] << 24;
+}
+
+//
+// Header (64 bytes, little-endian):
+//   u32 magic | u16 version | u16 reserved | u32 recordCount | u32 recordSize | u32 layoutHash
+//   u32 stringsOffset | u32 stringCount | zero padding
+// Records follow back to back, so record i lives at CHECKPOINT_HEADER_SIZE + i * recordSize.
+// The strings section after them holds u16 length | bytes for handles 1 to stringCount - 1;
+// the top bit of the length marks a format string.
+//
+static void CheckpointBuildHeader(unsigned char* header, unsigned int recordCount, unsigned int stringsOffset, unsigned int stringCount)
+{
+    memset(header, 0, CHECKPOINT_HEADER_SIZE);
+    CheckpointPutU32(header, CHECKPOINT_MAGIC);
+    header[4] = (unsigned char)(CHECKPOINT_VERSION & 0xFF);
+    header[5] = (unsigned char)(CHECKPOINT_VERSION >> 8);
+    CheckpointPutU32(header + 8, recordCount);
+    CheckpointPutU32(header + 12, (unsigned int)sizeof(CheckpointRecord));
+    CheckpointPutU32(header + 16, CheckpointLayoutHash());
+    CheckpointPutU32(header + 20, stringsOffset);
+    CheckpointPutU32(header + 24, stringCount);
+}
+
+//--------------------
+// WRITING
+//--------------------
+
+bool CheckpointPackCreate(CheckpointPackWriter* writer, const char* path)
+{
+    writer->file = nullptr;
+    writer->recordCount = 0;
+    writer->scratch = (CheckpointRecord*)malloc(sizeof(CheckpointRecord));
+    if (writer->scratch == nullptr)
+    {
+        printf("ERROR - Failed to allocate checkpoint record\n");
+        return false;
+    }
+
+    errno_t err = fopen_s(&writer->file, path, "wb");
+    if (err != 0 || writer->file == nullptr)
+    {
+        printf("ERROR - Failed to create checkpoint pack\n");
+        free(writer->scratch);
+        writer->scratch = nullptr;
+        writer->file = nullptr;
+        return false;
+    }
+
+    // Placeholder header; the counts are patched in by CheckpointPackFinish
+    unsigned char header[CHECKPOINT_HEADER_SIZE];
+    CheckpointBuildHeader(header, 0, 0, 0);
+    return fwrite(header, 1, sizeof(header), writer->file) == sizeof(header);
+}
+
+bool CheckpointPackAppend(CheckpointPackWriter* writer, GameInstance* game)
+{
+    if (writer->file == nullptr || game == nullptr || game->player == nullptr || game->dungeon == nullptr ||
+        game->questLog == nullptr || game->stats == nullptr || game->inventory == nullptr)
+    {
+        return false;
+    }
+
+    // Zero first so padding bytes in the file are deterministic
+    CheckpointRecord* record = writer->scratch;
+    memset(record, 0, sizeof(CheckpointRecord));
+    record->player = *game->player;
+    record->questLog = *game->questLog;
+    record->stats = *game->stats;
+    record->dungeon = *game->dungeon;
+    record->nextItemID = game->nextItemID;
+    record->random = game->random;
+
+    record->inventoryCount = game->inventory->itemCount;
+    memcpy(record->inventory, game->inventory->items, sizeof(ItemData) * record->inventoryCount);
+
+    if (fwrite(record, sizeof(CheckpointRecord), 1, writer->file) != 1)
+    {
+        printf("ERROR - Failed to write checkpoint record\n");
+        return false;
+    }
+    writer->recordCount++;
+    return true;
+}
+
+bool CheckpointPackFinish(CheckpointPackWriter* writer)
+{
+    free(writer->scratch);
+    writer->scratch = nullptr;
+    if (writer->file == nullptr) return false;
+
+    // Every handle in the records was issued before now, so the current pool covers them all
+    long stringsOffset = ftell(writer->file);
+    unsigned int stringCount = StringPoolCount();
+    bool ok = stringsOffset > 0;
+    for (unsigned int i = 1; ok && i < stringCount; i++)
+    {
+        const char* text = StringPoolGet((StringID)i);
+        size_t length = strlen(text);
+        unsigned short tagged = (unsigned short)(length | (StringPoolIsFormat((StringID)i) ? CHECKPOINT_STRING_FORMAT : 0));
+        unsigned char prefix[2] = { (unsigned char)(tagged & 0xFF), (unsigned char)(tagged >> 8) };
+        ok = fwrite(prefix, 1, sizeof(prefix), writer->file) == sizeof(prefix) && fwrite(text, 1, length, writer->file) == length;
+    }
+
+    unsigned char header[CHECKPOINT_HEADER_SIZE];
+    CheckpointBuildHeader(header, writer->recordCount, (unsigned int)stringsOffset, stringCount);
+    ok = ok && fseek(writer->file, 0, SEEK_SET) == 0 && fwrite(header, 1, sizeof(header), writer->file) == sizeof(header);
+    ok = fclose(writer->file) == 0 && ok;
+    writer->file = nullptr;
+
+    if (!ok)
+    {
+        printf("ERROR - Failed to finish checkpoint pack\n");
+    }
+    return ok;
+}
+
+//--------------------
+// MAPPING
+//--------------------
+
+// Interns the writer's strings into this process's pool, building the handle remap table
+static bool CheckpointLoadStrings(CheckpointPack* pack, unsigned int offset, unsigned int count)
+{
+    pack->strings = (StringID*)malloc(sizeof(StringID) * count);
+    if (pack->strings == nullptr) return false;
+    pack->strings[0] = STRING_NONE;
+
+    char text[MAX_STRING_LENGTH];
+    size_t pos = offset;
+    for (unsigned int i = 1; i < count; i++)
+    {
+        if (pack->size - pos < 2) return false;
+        unsigned short tagged = (unsigned short)(pack->base[pos] | pack->base[pos + 1] << 8);
+        size_t length = tagged & ~CHECKPOINT_STRING_FORMAT;
+        pos += 2;
+        if (pack->size - pos < length || length >= sizeof(text)) return false;
+        memcpy(text, pack->base + pos, length);
+        text[length] = '\0';
+        pos += length;
+        pack->strings[i] = (tagged & CHECKPOINT_STRING_FORMAT) != 0 ? StringPoolInternFormat(text) : StringPoolIntern(text);
+    }
+    pack->stringCount = count;
+    return true;
+}
+
+bool CheckpointPackOpen(CheckpointPack* pack, const char* path)
+{
+    memset(pack, 0, sizeof(CheckpointPack));
+
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        printf("ERROR - Failed to open checkpoint pack\n");
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < CHECKPOINT_HEADER_SIZE)
+    {
+        printf("ERROR - Checkpoint pack is truncated\n");
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const unsigned char* base = mapping != nullptr ? (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (base == nullptr)
+    {
+        printf("ERROR - Failed to map checkpoint pack\n");
+        if (mapping != nullptr) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    pack->file = file;
+    pack->mapping = mapping;
+    pack->base = base;
+    pack->size = (size_t)fileSize.QuadPart;
+
+    // Only the header and string pages are touched here; record pages fault in when a view reads them
+    unsigned int magic = CheckpointGetU32(base);
+    unsigned short version = (unsigned short)(base[4] | base[5] << 8);
+    unsigned int recordCount = CheckpointGetU32(base + 8);
+    unsigned int recordSize = CheckpointGetU32(base + 12);
+    unsigned int layoutHash = CheckpointGetU32(base + 16);
+    unsigned int stringsOffset = CheckpointGetU32(base + 20);
+    unsigned int stringCount = CheckpointGetU32(base + 24);
+
+    const char* error = nullptr;
+    if (magic != CHECKPOINT_MAGIC) error = "Not a checkpoint pack";
+    else if (version != CHECKPOINT_VERSION) error = "Unsupported checkpoint pack version";
+    else if (recordSize != sizeof(CheckpointRecord) || layoutHash != CheckpointLayoutHash()) error = "Checkpoint pack was written by a different build";
+    else if ((pack->size - CHECKPOINT_HEADER_SIZE) / sizeof(CheckpointRecord) < recordCount) error = "Checkpoint pack is truncated";
+    else if (stringsOffset < CHECKPOINT_HEADER_SIZE + (size_t)recordCount * sizeof(CheckpointRecord) || stringsOffset > pack->size ||
+        stringCount == 0 || stringCount > STRING_POOL_CAPACITY) error = "Checkpoint pack has a malformed string section";
+    else if (!CheckpointLoadStrings(pack, stringsOffset, stringCount)) error = "Checkpoint pack has a malformed string section";
+
+    if (error != nullptr)
+    {
+        printf("ERROR - %s\n", error);
+        CheckpointPackClose(pack);
+        return false;
+    }
+
+    pack->recordCount = recordCount;
+    return true;
+}
+
+void CheckpointPackClose(CheckpointPack* pack)
+{
+    if (pack == nullptr) return;
+    if (pack->base != nullptr) UnmapViewOfFile(pack->base);
+    if (pack->mapping != nullptr) CloseHandle((HANDLE)pack->mapping);
+    if (pack->file != nullptr) CloseHandle((HANDLE)pack->file);
+    free(pack->strings);
+    memset(pack, 0, sizeof(CheckpointPack));
+}
+
+//--------------------
+// VIEWS
+//--------------------
+
+bool CheckpointViewInit(CheckpointView* view, const CheckpointPack* pack, unsigned int index)
+{
+    memset(view, 0, sizeof(CheckpointView));
+    if (pack == nullptr || pack->base == nullptr || index >= pack->recordCount) return false;
+
+    view->record = (const CheckpointRecord*)(pack->base + CHECKPOINT_HEADER_SIZE + (size_t)index * sizeof(CheckpointRecord));
+    view->strings = pack->strings;
+    view->stringCount = pack->stringCount;
+    return true;
+}
+
+void CheckpointViewFree(CheckpointView* view)
+{
+    if (view == nullptr) return;
+    free(view->player);
+    free(view->dungeon);
+    free(view->questLog);
+    free(view->stats);
+    memset(view, 0, sizeof(CheckpointView));
+}
+
+const Player* CheckpointGetPlayer(const CheckpointView* view)
+{
+    return view->player != nullptr ? view->player : &view->record->player;
+}
+
+const Dungeon* CheckpointGetDungeon(const CheckpointView* view)
+{
+    return view->dungeon != nullptr ? view->dungeon : &view->record->dungeon;
+}
+
+const QuestLog* CheckpointGetQuestLog(const CheckpointView* view)
+{
+    return view->questLog != nullptr ? view->questLog : &view->record->questLog;
+}
+
+const GameStats* CheckpointGetStats(const CheckpointView* view)
+{
+    return view->stats != nullptr ? view->stats : &view->record->stats;
+}
+
+// Copies one part of the mapped record to the heap the first time it is written
+static void* CheckpointCopyOnWrite(void** copy, const void* source, size_t size)
+{
+    if (*copy == nullptr)
+    {
+        *copy = malloc(size);
+        if (*copy == nullptr)
+        {
+            printf("ERROR - Failed to allocate checkpoint copy\n");
+            return nullptr;
+        }
+        memcpy(*copy, source, size);
+    }
+    return *copy;
+}
+
+Player* CheckpointEditPlayer(CheckpointView* view)
+{
+    return (Player*)CheckpointCopyOnWrite((void**)&view->player, &view->record->player, sizeof(Player));
+}
+
+Dungeon* CheckpointEditDungeon(CheckpointView* view)
+{
+    return (Dungeon*)CheckpointCopyOnWrite((void**)&view->dungeon, &view->record->dungeon, sizeof(Dungeon));
+}
+
+QuestLog* CheckpointEditQuestLog(CheckpointView* view)
+{
+    return (QuestLog*)CheckpointCopyOnWrite((void**)&view->questLog, &view->record->questLog, sizeof(QuestLog));
+}
+
+GameStats* CheckpointEditStats(CheckpointView* view)
+{
+    return (GameStats*)CheckpointCopyOnWrite((void**)&view->stats, &view->record->stats, sizeof(GameStats));
+}
+
+// Turns a handle stored in the pack into one for this process's string pool
+StringID CheckpointMapString(const CheckpointView* view, StringID id)
+{
+    return id < view->stringCount ? view->strings[id] : STRING_NONE;
+}
+
+//--------------------
+// RESUME
+//--------------------
+
+// Hands the checkpoint to a game so play can continue from it. The game owns heap copies
+// of every part afterwards, so the view can be freed and the pack closed.
+bool CheckpointResumeGame(CheckpointView* view, GameInstance* game)
+{
+    if (view == nullptr || view->record == nullptr || game == nullptr) return false;
+
+    Player* player = CheckpointEditPlayer(view);
+    Dungeon* dungeon = CheckpointEditDungeon(view);
+    QuestLog* questLog = CheckpointEditQuestLog(view);
+    GameStats* stats = CheckpointEditStats(view);
+    Inventory* inventory = InventoryCreate();
+    if (player == nullptr || dungeon == nullptr || questLog == nullptr || stats == nullptr || inventory == nullptr)
+    {
+        InventoryFree(inventory);
+        return false;
+    }
+
+    for (unsigned short i = 0; i < player->abilityCount && i < MAX_ABILITIES; i++)
+    {
+        player->unlockedAbilities[i].name = CheckpointMapString(view, player->unlockedAbilities[i].name);
+        player->unlockedAbilities[i].description = CheckpointMapString(view, player->unlockedAbilities[i].description);
+    }
+    for (short i = 0; i < dungeon->totalRooms && i < MAX_ROOMS; i++)
+    {
+        dungeon->rooms[i].description = CheckpointMapString(view, dungeon->rooms[i].description);
+    }
+    DungeonBumpGeneration(dungeon); // The stored value came from whichever process wrote the pack
+
+    short inventoryCount = view->record->inventoryCount;
+    if (inventoryCount > MAX_INVENTORY) inventoryCount = MAX_INVENTORY;
+    for (short i = 0; i < inventoryCount; i++)
+    {
+        ItemData item = view->record->inventory[i];
+        item.name = CheckpointMapString(view, item.name);
+        item.description = CheckpointMapString(view, item.description);
+        InventoryAddItem(inventory, item);
+    }
+
+    free(game->player);
+    free(game->dungeon);
+    InventoryFree(game->inventory);
+    free(game->questLog);
+    free(game->stats);
+
+    game->player = player;
+    game->dungeon = dungeon;
+    game->inventory = inventory;
+    game->questLog = questLog;
+    game->stats = stats;
+    game->nextItemID = view->record->nextItemID;
+    game->random = view->record->random;
+
+    // Ownership moved to the game
+    view->player = nullptr;
+    view->dungeon = nullptr;
+    view->questLog = nullptr;
+    view->stats = nullptr;
+    return true;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "../Game/Game.h"
+
+//--------------------
+// CHECKPOINT PACK CONSTANTS
+//--------------------
+
+#define CHECKPOINT_MAGIC 0x4B434344u // "DCCK" read as a little-endian u32
+#define CHECKPOINT_VERSION 3 // NOLINT(modernize-macro-to-enum)
+#define CHECKPOINT_HEADER_SIZE 64 // NOLINT(modernize-macro-to-enum)
+#define CHECKPOINT_STRING_FORMAT 0x8000u // Length flag in the strings section
+
+//--------------------
+// CHECKPOINT PACK STRUCTS
+//--------------------
+
+//
+// One fixed-layout record per checkpoint. Every member is plain data, so a record can be used
+// in place straight out of the mapped file. Packs are a cache for the simulation pipeline, not a
+// portable save: the header stores a layout hash and packs from a different build are rejected.
+// Item, ability and room text is stored as string pool handles of the writing process; the pack
+// ends with that process's strings so a reader can map the handles onto its own pool.
+//
+typedef struct CheckpointRecord // NOLINT(clang-diagnostic-padded)
+{
+    Player player;
+    QuestLog questLog;
+    GameStats stats;
+    Dungeon dungeon;
+    Item inventory[MAX_INVENTORY];
+    short inventoryCount;
+    short nextItemID;
+    RandomState random;
+}CheckpointRecord;
+
+typedef struct CheckpointPackWriter
+{
+    FILE* file;
+    unsigned int recordCount;
+    CheckpointRecord* scratch;
+}CheckpointPackWriter;
+
+// Read-only mapping of a whole pack file
+typedef struct CheckpointPack
+{
+    void* file;
+    void* mapping;
+    const unsigned char* base;
+    size_t size;
+    unsigned int recordCount;
+    StringID* strings; // Pack handle -> handle in this process's string pool
+    unsigned int stringCount;
+}CheckpointPack;
+
+//
+// Zero-copy view of one record. The Get functions return pointers into the mapping until the
+// matching Edit function is called, which copies that part to the heap once and returns the copy.
+// Text handles in either are the writer's; pass them through CheckpointMapString before use.
+// CheckpointResumeGame maps them for the game it hands the record to.
+//
+typedef struct CheckpointView
+{
+    const CheckpointRecord* record;
+    const StringID* strings;
+    unsigned int stringCount;
+    Player* player;
+    Dungeon* dungeon;
+    QuestLog* questLog;
+    GameStats* stats;
+}CheckpointView;
+
+//--------------------
+// CHECKPOINT FUNCTIONS
+//--------------------
+
+bool CheckpointPackCreate(CheckpointPackWriter* writer, const char* path);
+bool CheckpointPackAppend(CheckpointPackWriter* writer, GameInstance* game);
+bool CheckpointPackFinish(CheckpointPackWriter* writer);
+
+bool CheckpointPackOpen(CheckpointPack* pack, const char* path);
+void CheckpointPackClose(CheckpointPack* pack);
+
+bool CheckpointViewInit(CheckpointView* view, const CheckpointPack* pack, unsigned int index);
+void CheckpointViewFree(CheckpointView* view);
+
+const Player* CheckpointGetPlayer(const CheckpointView* view);
+const Dungeon* CheckpointGetDungeon(const CheckpointView* view);
+const QuestLog* CheckpointGetQuestLog(const CheckpointView* view);
+const GameStats* CheckpointGetStats(const CheckpointView* view);
+
+Player* CheckpointEditPlayer(CheckpointView* view);
+Dungeon* CheckpointEditDungeon(CheckpointView* view);
+QuestLog* CheckpointEditQuestLog(CheckpointView* view);
+GameStats* CheckpointEditStats(CheckpointView* view);
+StringID CheckpointMapString(const CheckpointView* view, StringID id);
+
+bool CheckpointResumeGame(CheckpointView* view, GameInstance* game);
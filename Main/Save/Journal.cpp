@@ -0,0 +1,597 @@
+#include "Journal.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <io.h>
+
+//--------------------
+// SHADOW STATE
+//--------------------
+
+static void SaveJournalCaptureShadow(SaveJournal* journal, Player* player, Inventory* inventory, QuestLog* questLog, GameStats* stats, Dungeon* dungeon)
+{
+    memcpy(&journal->player, player, sizeof(Player));
+    memcpy(&journal->dungeon, dungeon, sizeof(Dungeon));
+    memcpy(&journal->questLog, questLog, sizeof(QuestLog));
+    memcpy(&journal->stats, stats, sizeof(GameStats));
+
+    journal->itemCount = inventory->itemCount;
+    memcpy(journal->items, inventory->items, sizeof(ItemData) * inventory->itemCount);
+}
+
+//--------------------
+// DIFFING
+//--------------------
+
+static void SaveJournalPutField(SaveBuffer* frame, JournalPlayerField field, unsigned int value)
+{
+    SaveBufferWriteU8(frame, JOURNAL_PLAYER_FIELD);
+    SaveBufferWriteU8(frame, (unsigned char)field);
+    SaveBufferWriteU32(frame, value);
+}
+
+static unsigned int SaveJournalFloatBits(float value)
+{
+    unsigned int bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static void SaveJournalDiffPlayer(SaveBuffer* frame, const Player* old, Player* player)
+{
+    // Names, effects and abilities change rarely and are variable-sized: log the whole player then
+    bool structural = strcmp(old->name, player->name) != 0 ||
+        old->statusEffectCount != player->statusEffectCount ||
+        memcmp(old->statusEffect, player->statusEffect, sizeof(StatusEffect) * player->statusEffectCount) != 0 ||
+        old->abilityCount != player->abilityCount ||
+        memcmp(old->unlockedAbilities, player->unlockedAbilities, sizeof(Ability) * player->abilityCount) != 0;
+    if (structural)
+    {
+        SaveBufferWriteU8(frame, JOURNAL_PLAYER_FULL);
+        SaveEncodePlayer(frame, player);
+        return;
+    }
+
+    if (old->health != player->health) SaveJournalPutField(frame, PLAYER_FIELD_HEALTH, player->health);
+    if (old->maxHealth != player->maxHealth) SaveJournalPutField(frame, PLAYER_FIELD_MAX_HEALTH, player->maxHealth);
+    if (old->attack != player->attack) SaveJournalPutField(frame, PLAYER_FIELD_ATTACK, player->attack);
+    if (old->defense != player->defense) SaveJournalPutField(frame, PLAYER_FIELD_DEFENSE, player->defense);
+    if (old->exp != player->exp) SaveJournalPutField(frame, PLAYER_FIELD_EXP, player->exp);
+    if (old->level != player->level) SaveJournalPutField(frame, PLAYER_FIELD_LEVEL, player->level);
+    if (old->gold != player->gold) SaveJournalPutField(frame, PLAYER_FIELD_GOLD, (unsigned int)player->gold);
+    if (old->currentRoom != player->currentRoom) SaveJournalPutField(frame, PLAYER_FIELD_CURRENT_ROOM, player->currentRoom);
+    if (old->trait != player->trait) SaveJournalPutField(frame, PLAYER_FIELD_TRAIT, (unsigned int)player->trait);
+    if (old->difficulty != player->difficulty) SaveJournalPutField(frame, PLAYER_FIELD_DIFFICULTY, (unsigned int)player->difficulty);
+    if (old->canCharmEnemies != player->canCharmEnemies) SaveJournalPutField(frame, PLAYER_FIELD_CAN_CHARM, player->canCharmEnemies ? 1 : 0);
+    if (old->goldMultiplier != player->goldMultiplier) SaveJournalPutField(frame, PLAYER_FIELD_GOLD_MULTIPLIER, SaveJournalFloatBits(player->goldMultiplier));
+    if (old->expMultiplier != player->expMultiplier) SaveJournalPutField(frame, PLAYER_FIELD_EXP_MULTIPLIER, SaveJournalFloatBits(player->expMultiplier));
+}
+
+static void SaveJournalDiffDungeon(SaveBuffer* frame, const Dungeon* old, Dungeon* dungeon)
+{
+    bool structural = old->totalRooms != dungeon->totalRooms || old->seed != dungeon->seed ||
+        memcmp(&old->params, &dungeon->params, sizeof(DungeonGenParams)) != 0 ||
+        memcmp(&old->topology, &dungeon->topology, sizeof(DungeonTopology)) != 0;
+    for (short i = 0; !structural && i < dungeon->totalRooms; i++)
+    {
+        // A room being generated changes its description too; replaying its flags redoes that
+        const Room* before = &old->rooms[i];
+        const Room* after = &dungeon->rooms[i];
+        structural = RoomIsGenerated(before) && before->description != after->description;
+    }
+    if (structural)
+    {
+        SaveBufferWriteU8(frame, JOURNAL_DUNGEON_FULL);
+        SaveEncodeDungeon(frame, dungeon);
+        return;
+    }
+
+    for (short i = 0; i < dungeon->totalRooms; i++)
+    {
+        unsigned char flags = SaveRoomFlags(dungeon, i);
+        if (old->rooms[i].state != dungeon->rooms[i].state || SaveRoomFlags(old, i) != flags)
+        {
+            SaveBufferWriteU8(frame, JOURNAL_ROOM);
+            SaveBufferWriteU16(frame, (unsigned short)i);
+            SaveBufferWriteU8(frame, (unsigned char)RoomGetEncounter(&dungeon->rooms[i]));
+            SaveBufferWriteU8(frame, flags);
+        }
+    }
+}
+
+static bool SaveJournalSameItem(const ItemData* a, const ItemData* b)
+{
+    return a->rarity == b->rarity && a->type == b->type && a->value == b->value && a->cost == b->cost &&
+        a->name == b->name && a->description == b->description;
+}
+
+static const ItemData* SaveJournalFindItem(const ItemData* items, short count, short itemID)
+{
+    for (short i = 0; i < count; i++)
+    {
+        if (items[i].itemID == itemID) return &items[i];
+    }
+    return nullptr;
+}
+
+static void SaveJournalDiffInventory(SaveBuffer* frame, const ItemData* oldItems, short oldCount, Inventory* inventory)
+{
+    // The item order replay will produce, following InventoryRemoveItem and InventoryAddItem
+    short order[MAX_INVENTORY];
+    short orderCount = oldCount;
+    for (short i = 0; i < oldCount; i++)
+    {
+        order[i] = oldItems[i].itemID;
+    }
+
+    // Removals first, so an item that changed in place can be re-added under the same ID
+    for (short i = 0; i < oldCount; i++)
+    {
+        const ItemData* before = &oldItems[i];
+        const ItemData* after = InventoryFindItem(inventory, before->itemID);
+        if (after == nullptr || !SaveJournalSameItem(before, after))
+        {
+            SaveBufferWriteU8(frame, JOURNAL_ITEM_REMOVE);
+            SaveBufferWriteU16(frame, (unsigned short)before->itemID);
+            for (short j = 0; j < orderCount; j++)
+            {
+                if (order[j] != before->itemID) continue;
+                order[j] = order[--orderCount];
+                break;
+            }
+        }
+        else if (before->quantity != after->quantity)
+        {
+            SaveBufferWriteU8(frame, JOURNAL_ITEM_QUANTITY);
+            SaveBufferWriteU16(frame, (unsigned short)after->itemID);
+            SaveBufferWriteU16(frame, (unsigned short)after->quantity);
+        }
+    }
+
+    for (short i = 0; i < inventory->itemCount; i++)
+    {
+        const ItemData* after = &inventory->items[i];
+        const ItemData* before = SaveJournalFindItem(oldItems, oldCount, after->itemID);
+        if (before == nullptr || !SaveJournalSameItem(before, after))
+        {
+            SaveBufferWriteU8(frame, JOURNAL_ITEM_ADD);
+            SaveEncodeItem(frame, after);
+            if (orderCount < MAX_INVENTORY) order[orderCount++] = after->itemID;
+        }
+    }
+
+    // The game may have removed items in another order than replay will, leaving them shuffled
+    // differently; only then is the full order worth logging
+    bool reordered = orderCount != inventory->itemCount;
+    for (short i = 0; i < orderCount && !reordered; i++)
+    {
+        reordered = order[i] != inventory->items[i].itemID;
+    }
+    if (reordered)
+    {
+        SaveBufferWriteU8(frame, JOURNAL_ITEM_ORDER);
+        SaveBufferWriteU16(frame, (unsigned short)inventory->itemCount);
+        for (short i = 0; i < inventory->itemCount; i++)
+        {
+            SaveBufferWriteU16(frame, (unsigned short)inventory->items[i].itemID);
+        }
+    }
+}
+
+static void SaveJournalDiffQuests(SaveBuffer* frame, const QuestLog* old, QuestLog* questLog)
+{
+    bool structural = old->questCount != questLog->questCount;
+    for (short i = 0; !structural && i < questLog->questCount; i++)
+    {
+        const Quest* before = &old->quests[i];
+        const Quest* after = &questLog->quests[i];
+        structural = before->questID != after->questID || before->objectiveType != after->objectiveType ||
+            before->targetValue != after->targetValue || before->rewardGold != after->rewardGold ||
+            strcmp(before->title, after->title) != 0 || strcmp(before->description, after->description) != 0;
+    }
+    if (structural)
+    {
+        SaveBufferWriteU8(frame, JOURNAL_QUESTS_FULL);
+        SaveEncodeQuests(frame, questLog);
+        return;
+    }
+
+    for (short i = 0; i < questLog->questCount; i++)
+    {
+        const Quest* before = &old->quests[i];
+        const Quest* after = &questLog->quests[i];
+        if (before->currentProgress != after->currentProgress || before->completed != after->completed)
+        {
+            SaveBufferWriteU8(frame, JOURNAL_QUEST_PROGRESS);
+            SaveBufferWriteU16(frame, (unsigned short)i);
+            SaveBufferWriteU16(frame, (unsigned short)after->currentProgress);
+            SaveBufferWriteU8(frame, after->completed ? 1 : 0);
+        }
+    }
+}
+
+//--------------------
+// WRITING
+//--------------------
+
+static bool SaveJournalWriteHeader(SaveJournal* journal)
+{
+    if (journal->file != nullptr) fclose(journal->file);
+    journal->file = nullptr;
+
+    errno_t err = fopen_s(&journal->file, journal->journalPath, "wb");
+    if (err != 0 || journal->file == nullptr)
+    {
+        printf("ERROR - Failed to open save journal\n");
+        journal->file = nullptr;
+        return false;
+    }
+
+    SaveBuffer header;
+    SaveBufferInit(&header);
+    SaveBufferWriteU32(&header, SAVE_JOURNAL_MAGIC);
+    SaveBufferWriteU16(&header, SAVE_JOURNAL_VERSION);
+    SaveBufferWriteU16(&header, 0);
+    SaveBufferWriteU32(&header, journal->baseChecksum);
+    SaveBufferWriteU32(&header, 0);
+
+    bool written = !header.failed && fwrite(header.data, 1, header.size, journal->file) == header.size &&
+        fflush(journal->file) == 0 && _commit(_fileno(journal->file)) == 0;
+    SaveBufferFree(&header);
+
+    journal->journalBytes = SAVE_JOURNAL_HEADER_SIZE;
+    journal->bytesWritten += SAVE_JOURNAL_HEADER_SIZE;
+    return written;
+}
+
+bool SaveJournalCompact(SaveJournal* journal, Player* player, Inventory* inventory, QuestLog* questLog, GameStats* stats, Dungeon* dungeon)
+{
+    SaveBuffer snapshot;
+    SaveBufferInit(&snapshot);
+    if (!SaveEncodeSnapshot(&snapshot, player, inventory, questLog, stats, dungeon) ||
+        !SaveWriteFileAtomic(journal->snapshotPath, snapshot.data, snapshot.size))
+    {
+        SaveBufferFree(&snapshot);
+        journal->needsCompaction = true;
+        return false;
+    }
+
+    // Until the new header lands, the old journal still names the old snapshot and is ignored on load
+    SaveReader reader = { snapshot.data, snapshot.size, 12, true };
+    journal->baseChecksum = SaveReadU32(&reader);
+    journal->bytesWritten += snapshot.size;
+    SaveBufferFree(&snapshot);
+
+    journal->sequence = 0;
+    journal->needsCompaction = !SaveJournalWriteHeader(journal);
+    if (journal->needsCompaction) return false;
+
+    SaveJournalCaptureShadow(journal, player, inventory, questLog, stats, dungeon);
+    journal->compactions++;
+    return true;
+}
+
+SaveJournal* SaveJournalOpen(const char* snapshotPath, const char* journalPath, Player* player, Inventory* inventory, QuestLog* questLog, GameStats* stats, Dungeon* dungeon)
+{
+    if (player == nullptr || inventory == nullptr || questLog == nullptr || stats == nullptr || dungeon == nullptr)
+    {
+        printf("ERROR - SaveJournalOpen: missing game state\n");
+        return nullptr;
+    }
+
+    SaveJournal* journal = (SaveJournal*)calloc(1, sizeof(SaveJournal));
+    if (journal == nullptr)
+    {
+        printf("ERROR - Failed to allocate memory for save journal\n");
+        return nullptr;
+    }
+    journal->snapshotPath = snapshotPath;
+    journal->journalPath = journalPath;
+    SaveBufferInit(&journal->frame);
+
+    // Every session starts from a fresh snapshot, which also folds in anything replayed on load
+    if (!SaveJournalCompact(journal, player, inventory, questLog, stats, dungeon))
+    {
+        SaveJournalClose(journal);
+        return nullptr;
+    }
+    return journal;
+}
+
+bool SaveJournalCommit(SaveJournal* journal, Player* player, Inventory* inventory, QuestLog* questLog, GameStats* stats, Dungeon* dungeon)
+{
+    if (journal == nullptr || player == nullptr || inventory == nullptr || questLog == nullptr || stats == nullptr || dungeon == nullptr)
+    {
+        return false;
+    }
+    if (journal->needsCompaction || journal->file == nullptr)
+    {
+        return SaveJournalCompact(journal, player, inventory, questLog, stats, dungeon);
+    }
+
+    SaveBuffer* frame = &journal->frame;
+    frame->size = 0;
+    frame->failed = false;
+    SaveBufferWriteU32(frame, 0);
+    SaveBufferWriteU32(frame, 0);
+    SaveBufferWriteU32(frame, 0);
+
+    SaveJournalDiffPlayer(frame, &journal->player, player);
+    SaveJournalDiffDungeon(frame, &journal->dungeon, dungeon);
+    SaveJournalDiffInventory(frame, journal->items, journal->itemCount, inventory);
+    SaveJournalDiffQuests(frame, &journal->questLog, questLog);
+    if (memcmp(&journal->stats, stats, sizeof(GameStats)) != 0)
+    {
+        SaveBufferWriteU8(frame, JOURNAL_STATS);
+        SaveEncodeStats(frame, stats);
+    }
+
+    if (frame->failed) return false;
+    if (frame->size == SAVE_JOURNAL_FRAME_HEADER_SIZE) return true; // Nothing changed
+
+    size_t payloadSize = frame->size - SAVE_JOURNAL_FRAME_HEADER_SIZE;
+    SaveBufferPatchU32(frame, 0, (unsigned int)payloadSize);
+    SaveBufferPatchU32(frame, 4, journal->sequence + 1);
+    SaveBufferPatchU32(frame, 8, SaveChecksum(frame->data + SAVE_JOURNAL_FRAME_HEADER_SIZE, payloadSize));
+
+    // A flush hands the frame to the OS; a torn frame from a crash fails its checksum on replay
+    if (fwrite(frame->data, 1, frame->size, journal->file) != frame->size || fflush(journal->file) != 0 ||
+        (journal->durable && _commit(_fileno(journal->file)) != 0))
+    {
+        printf("ERROR - Failed to append to save journal\n");
+        journal->needsCompaction = true; // A partial frame would hide every later one
+        return false;
+    }
+
+    journal->sequence++;
+    journal->journalBytes += frame->size;
+    journal->bytesWritten += frame->size;
+    SaveJournalCaptureShadow(journal, player, inventory, questLog, stats, dungeon);
+
+    if (journal->journalBytes >= SAVE_JOURNAL_COMPACT_BYTES)
+    {
+        return SaveJournalCompact(journal, player, inventory, questLog, stats, dungeon);
+    }
+    return true;
+}
+
+void SaveJournalClose(SaveJournal* journal)
+{
+    if (journal == nullptr) return;
+    if (journal->file != nullptr) fclose(journal->file);
+    SaveBufferFree(&journal->frame);
+    free(journal);
+}
+
+//--------------------
+// REPLAY
+//--------------------
+
+// Where a frame is applied before it is kept, so a record that fails leaves the game untouched
+typedef struct SaveJournalScratch //NOLINT
+{
+    Player player;
+    Inventory inventory;
+    QuestLog questLog;
+    GameStats stats;
+    Dungeon dungeon;
+}SaveJournalScratch;
+
+static bool SaveJournalApplyPlayerField(SaveReader* reader, Player* player)
+{
+    JournalPlayerField field = (JournalPlayerField)SaveReadU8(reader);
+    unsigned int value = SaveReadU32(reader);
+    if (!reader->ok) return false;
+
+    switch (field)
+    {
+    case PLAYER_FIELD_HEALTH: player->health = (unsigned short)value; break;
+    case PLAYER_FIELD_MAX_HEALTH: player->maxHealth = (unsigned short)value; break;
+    case PLAYER_FIELD_ATTACK: player->attack = (unsigned short)value; break;
+    case PLAYER_FIELD_DEFENSE: player->defense = (unsigned short)value; break;
+    case PLAYER_FIELD_EXP: player->exp = (unsigned short)value; break;
+    case PLAYER_FIELD_LEVEL: player->level = (unsigned short)value; break;
+    case PLAYER_FIELD_GOLD: player->gold = (int)value; break;
+    case PLAYER_FIELD_CURRENT_ROOM: player->currentRoom = (unsigned short)value; break;
+    case PLAYER_FIELD_TRAIT: player->trait = (PlayerTrait)value; break;
+    case PLAYER_FIELD_DIFFICULTY: player->difficulty = (DifficultyLevel)value; break;
+    case PLAYER_FIELD_CAN_CHARM: player->canCharmEnemies = value != 0; break;
+    case PLAYER_FIELD_GOLD_MULTIPLIER: memcpy(&player->goldMultiplier, &value, sizeof(float)); break;
+    case PLAYER_FIELD_EXP_MULTIPLIER: memcpy(&player->expMultiplier, &value, sizeof(float)); break;
+    default: return false;
+    }
+    return true;
+}
+
+static bool SaveJournalApplyRecord(SaveReader* reader, Player* player, Inventory* inventory, QuestLog* questLog, GameStats* stats, Dungeon* dungeon)
+{
+    JournalRecordType type = (JournalRecordType)SaveReadU8(reader);
+    if (!reader->ok) return false;
+
+    switch (type)
+    {
+    case JOURNAL_PLAYER_FIELD:
+        return SaveJournalApplyPlayerField(reader, player);
+    case JOURNAL_PLAYER_FULL:
+        {
+            Player* loaded = SaveDecodePlayer(reader);
+            if (loaded == nullptr) return false;
+            *player = *loaded;
+            free(loaded);
+            return true;
+        }
+    case JOURNAL_ROOM:
+        {
+            unsigned short index = SaveReadU16(reader);
+            unsigned char encounter = SaveReadU8(reader);
+            unsigned char flags = SaveReadU8(reader);
+            if (!reader->ok || index >= MAX_ROOMS) return false;
+            if ((flags & 8) != 0 && !RoomIsGenerated(&dungeon->rooms[index]))
+            {
+                dungeon->rooms[index].description = DungeonGetRoomDescription(index);
+            }
+            SaveApplyRoomFlags(dungeon, (short)index, (EncounterType)encounter, flags);
+            return true;
+        }
+    case JOURNAL_DUNGEON_FULL:
+        {
+            Dungeon* loaded = SaveDecodeDungeon(reader, SAVE_VERSION); // Frames are always written by this build
+            if (loaded == nullptr) return false;
+            *dungeon = *loaded;
+            free(loaded);
+            return true;
+        }
+    case JOURNAL_ITEM_ADD:
+        {
+            ItemData item;
+            SaveDecodeItem(reader, &item);
+            return reader->ok && InventoryAddItem(inventory, item);
+        }
+    case JOURNAL_ITEM_REMOVE:
+        {
+            short itemID = (short)SaveReadU16(reader);
+            ItemData* item = reader->ok ? InventoryFindItem(inventory, itemID) : nullptr;
+            if (item == nullptr) return false;
+            item->quantity = 1; // InventoryRemoveItem takes one away and drops the item at zero
+            return InventoryRemoveItem(inventory, itemID);
+        }
+    case JOURNAL_ITEM_QUANTITY:
+        {
+            short itemID = (short)SaveReadU16(reader);
+            short quantity = (short)SaveReadU16(reader);
+            ItemData* item = reader->ok ? InventoryFindItem(inventory, itemID) : nullptr;
+            if (item == nullptr) return false;
+            item->quantity = quantity;
+            return true;
+        }
+    case JOURNAL_ITEM_ORDER:
+        {
+            unsigned short count = SaveReadU16(reader);
+            if (!reader->ok || count != (unsigned short)inventory->itemCount) return false;
+            ItemData ordered[MAX_INVENTORY];
+            for (unsigned short i = 0; i < count; i++)
+            {
+                ItemData* item = InventoryFindItem(inventory, (short)SaveReadU16(reader));
+                if (!reader->ok || item == nullptr) return false;
+                ordered[i] = *item;
+            }
+            memcpy(inventory->items, ordered, sizeof(ItemData) * count);
+            InventoryRebuildIndex(inventory);
+            return true;
+        }
+    case JOURNAL_QUEST_PROGRESS:
+        {
+            unsigned short index = SaveReadU16(reader);
+            short progress = (short)SaveReadU16(reader);
+            bool completed = SaveReadU8(reader) != 0;
+            if (!reader->ok || index >= MAX_QUESTS) return false;
+            questLog->quests[index].currentProgress = progress;
+            questLog->quests[index].completed = completed;
+            return true;
+        }
+    case JOURNAL_QUESTS_FULL:
+        {
+            QuestLog* loaded = SaveDecodeQuests(reader);
+            if (loaded == nullptr) return false;
+            *questLog = *loaded;
+            free(loaded);
+            return true;
+        }
+    case JOURNAL_STATS:
+        {
+            GameStats* loaded = SaveDecodeStats(reader);
+            if (loaded == nullptr) return false;
+            *stats = *loaded;
+            free(loaded);
+            return true;
+        }
+    }
+    return false;
+}
+
+int SaveJournalReplay(const char* journalPath, unsigned int baseChecksum, Player* player, Inventory* inventory, QuestLog* questLog, GameStats* stats, Dungeon* dungeon)
+{
+    FILE* file;
+    if (fopen_s(&file, journalPath, "rb") != 0 || file == nullptr) return 0; // No journal is fine
+
+    fseek(file, 0, SEEK_END);
+    long fileSize = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    unsigned char* data = fileSize >= SAVE_JOURNAL_HEADER_SIZE ? (unsigned char*)malloc((size_t)fileSize) : nullptr;
+    bool read = data != nullptr && fread(data, 1, (size_t)fileSize, file) == (size_t)fileSize;
+    fclose(file);
+    if (!read)
+    {
+        free(data);
+        return 0;
+    }
+
+    SaveReader header = { data, (size_t)fileSize, 0, true };
+    unsigned int magic = SaveReadU32(&header);
+    unsigned short version = SaveReadU16(&header);
+    SaveReadU16(&header);
+    unsigned int journalBase = SaveReadU32(&header);
+    SaveReadU32(&header);
+
+    // A journal left behind by an older snapshot is already folded into the current one
+    if (magic != SAVE_JOURNAL_MAGIC || version != SAVE_JOURNAL_VERSION || journalBase != baseChecksum)
+    {
+        free(data);
+        return 0;
+    }
+
+    SaveJournalScratch* scratch = (SaveJournalScratch*)malloc(sizeof(SaveJournalScratch));
+    if (scratch == nullptr)
+    {
+        printf("ERROR - Failed to allocate memory for save journal replay\n");
+        free(data);
+        return 0;
+    }
+    scratch->player = *player;
+    scratch->inventory = *inventory;
+    scratch->questLog = *questLog;
+    scratch->stats = *stats;
+    scratch->dungeon = *dungeon;
+
+    int applied = 0;
+    size_t pos = SAVE_JOURNAL_HEADER_SIZE;
+    while ((size_t)fileSize - pos >= SAVE_JOURNAL_FRAME_HEADER_SIZE)
+    {
+        SaveReader frame = { data + pos, SAVE_JOURNAL_FRAME_HEADER_SIZE, 0, true };
+        unsigned int payloadSize = SaveReadU32(&frame);
+        unsigned int sequence = SaveReadU32(&frame);
+        unsigned int checksum = SaveReadU32(&frame);
+        const unsigned char* payload = data + pos + SAVE_JOURNAL_FRAME_HEADER_SIZE;
+
+        if (payloadSize > (size_t)fileSize - pos - SAVE_JOURNAL_FRAME_HEADER_SIZE ||
+            sequence != (unsigned int)applied + 1 || SaveChecksum(payload, payloadSize) != checksum)
+        {
+            break; // Torn or corrupt tail
+        }
+
+        SaveReader records = { payload, payloadSize, 0, true };
+        bool ok = true;
+        while (ok && records.pos < records.size)
+        {
+            ok = SaveJournalApplyRecord(&records, &scratch->player, &scratch->inventory, &scratch->questLog, &scratch->stats, &scratch->dungeon);
+        }
+        if (!ok)
+        {
+            // The game keeps the state from the end of the previous frame, never half of this one
+            printf("ERROR - Save journal frame %u is malformed\n", sequence);
+            break;
+        }
+        *player = scratch->player;
+        *inventory = scratch->inventory;
+        *questLog = scratch->questLog;
+        *stats = scratch->stats;
+        *dungeon = scratch->dungeon;
+
+        applied++;
+        pos += SAVE_JOURNAL_FRAME_HEADER_SIZE + payloadSize;
+    }
+
+    free(scratch);
+    free(data);
+    return applied;
+}
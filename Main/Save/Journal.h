@@ -0,0 +1,100 @@
+#pragma once
+
+#include "Save.h"
+
+//--------------------
+// JOURNAL CONSTANTS
+//--------------------
+
+#define SAVE_JOURNAL_MAGIC 0x4C4A4344u // "DCJL" read as a little-endian u32
+#define SAVE_JOURNAL_VERSION 4 // NOLINT(modernize-macro-to-enum)
+#define SAVE_JOURNAL_HEADER_SIZE 16 // NOLINT(modernize-macro-to-enum)
+#define SAVE_JOURNAL_FRAME_HEADER_SIZE 12 // NOLINT(modernize-macro-to-enum)
+#define SAVE_JOURNAL_COMPACT_BYTES (64 * 1024) // Fold the journal into a new snapshot past this size
+
+//--------------------
+// JOURNAL ENUMS
+//--------------------
+
+typedef enum
+{
+    JOURNAL_PLAYER_FIELD = 1,
+    JOURNAL_PLAYER_FULL = 2,
+    JOURNAL_ROOM = 3,
+    JOURNAL_DUNGEON_FULL = 4,
+    JOURNAL_ITEM_ADD = 5,
+    JOURNAL_ITEM_REMOVE = 6,
+    JOURNAL_ITEM_QUANTITY = 7,
+    JOURNAL_QUEST_PROGRESS = 8,
+    JOURNAL_QUESTS_FULL = 9,
+    JOURNAL_STATS = 10,
+    JOURNAL_ITEM_ORDER = 11,
+
+}JournalRecordType;
+
+typedef enum
+{
+    PLAYER_FIELD_HEALTH,
+    PLAYER_FIELD_MAX_HEALTH,
+    PLAYER_FIELD_ATTACK,
+    PLAYER_FIELD_DEFENSE,
+    PLAYER_FIELD_EXP,
+    PLAYER_FIELD_LEVEL,
+    PLAYER_FIELD_GOLD,
+    PLAYER_FIELD_CURRENT_ROOM,
+    PLAYER_FIELD_TRAIT,
+    PLAYER_FIELD_DIFFICULTY,
+    PLAYER_FIELD_CAN_CHARM,
+    PLAYER_FIELD_GOLD_MULTIPLIER,
+    PLAYER_FIELD_EXP_MULTIPLIER,
+
+}JournalPlayerField;
+
+//--------------------
+// JOURNAL STRUCTS
+//--------------------
+
+//
+// An open journal keeps a copy of the state last written to disk. Each commit compares the
+// live game against that copy and appends only the differences as one checksummed frame.
+//
+typedef struct SaveJournal
+{
+    FILE* file;
+    const char* snapshotPath;
+    const char* journalPath;
+    unsigned int baseChecksum; // CRC of the snapshot this journal applies to
+    unsigned int sequence;
+    size_t journalBytes;
+    bool needsCompaction;
+    bool durable; // Sync every frame to disk; meant for writers off the game thread
+    SaveBuffer frame;
+
+    Player player;
+    Dungeon dungeon;
+    QuestLog questLog;
+    GameStats stats;
+    Item items[MAX_INVENTORY];
+    short itemCount;
+
+    size_t bytesWritten; // Snapshot and journal bytes since open
+    unsigned int compactions;
+}SaveJournal;
+
+//--------------------
+// JOURNAL FUNCTIONS
+//--------------------
+
+//
+// Journal layout (little-endian):
+//   header  u32 magic | u16 version | u16 reserved | u32 baseChecksum | u32 reserved
+//   frames  u32 payloadSize | u32 sequence | u32 crc32(payload) | records
+// A record is a u8 JournalRecordType followed by its fields. Replay stops at the first frame that is
+// torn or fails its checksum, so a crash mid-append loses at most the frame being written. A frame
+// is applied as a whole: if any of its records fails, replay stops before that frame.
+//
+SaveJournal* SaveJournalOpen(const char* snapshotPath, const char* journalPath, Player* player, Inventory* inventory, QuestLog* questLog, GameStats* stats, Dungeon* dungeon);
+bool SaveJournalCommit(SaveJournal* journal, Player* player, Inventory* inventory, QuestLog* questLog, GameStats* stats, Dungeon* dungeon);
+bool SaveJournalCompact(SaveJournal* journal, Player* player, Inventory* inventory, QuestLog* questLog, GameStats* stats, Dungeon* dungeon);
+void SaveJournalClose(SaveJournal* journal);
+int SaveJournalReplay(const char* journalPath, unsigned int baseChecksum, Player* player, Inventory* inventory, QuestLog* questLog, GameStats* stats, Dungeon* dungeon);
@@ -0,0 +1,869 @@
+#include "Save.h"
+#include "../Game/DungeonGen.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <io.h>
+#include <windows.h>
+
+//--------------------
+// BUFFER FUNCTIONS
+//--------------------
+
+void SaveBufferInit(SaveBuffer* buffer)
+{
+    buffer->data = nullptr;
+    buffer->size = 0;
+    buffer->capacity = 0;
+    buffer->failed = false;
+}
+
+void SaveBufferFree(SaveBuffer* buffer)
+{
+    if (buffer == nullptr) return;
+    free(buffer->data);
+    SaveBufferInit(buffer);
+}
+
+static bool SaveBufferReserve(SaveBuffer* buffer, size_t extra)
+{
+    if (buffer->failed) return false;
+    if (buffer->size + extra <= buffer->capacity) return true;
+
+    size_t capacity = buffer->capacity > 0 ? buffer->capacity : 4096;
+    while (capacity < buffer->size + extra) capacity *= 2;
+
+    unsigned char* data = (unsigned char*)realloc(buffer->data, capacity);
+    if (data == nullptr)
+    {
+        printf("ERROR - Failed to grow save buffer\n");
+        buffer->failed = true;
+        return false;
+    }
+    buffer->data = data;
+    buffer->capacity = capacity;
+    return true;
+}
+
+void SaveBufferWriteU8(SaveBuffer* buffer, unsigned char value)
+{
+    if (!SaveBufferReserve(buffer, 1)) return;
+    buffer->data[buffer->size++] = value;
+}
+
+void SaveBufferWriteU16(SaveBuffer* buffer, unsigned short value)
+{
+    if (!SaveBufferReserve(buffer, 2)) return;
+    buffer->data[buffer->size++] = (unsigned char)(value & 0xFF);
+    buffer->data[buffer->size++] = (unsigned char)(value >> 8);
+}
+
+void SaveBufferWriteU32(SaveBuffer* buffer, unsigned int value)
+{
+    if (!SaveBufferReserve(buffer, 4)) return;
+    for (short i = 0; i < 4; i++)
+    {
+        buffer->data[buffer->size++] = (unsigned char)((value >> (8 * i)) & 0xFF);
+    }
+}
+
+void SaveBufferWriteF32(SaveBuffer* buffer, float value)
+{
+    unsigned int bits;
+    memcpy(&bits, &value, sizeof(bits));
+    SaveBufferWriteU32(buffer, bits);
+}
+
+void SaveBufferWriteString(SaveBuffer* buffer, const char* text)
+{
+    size_t length = text != nullptr ? strlen(text) : 0;
+    if (length > 0xFFFF) length = 0xFFFF;
+    SaveBufferWriteU16(buffer, (unsigned short)length);
+    if (length == 0 || !SaveBufferReserve(buffer, length)) return;
+    memcpy(buffer->data + buffer->size, text, length);
+    buffer->size += length;
+}
+
+void SaveBufferPatchU32(SaveBuffer* buffer, size_t offset, unsigned int value)
+{
+    if (buffer->failed || offset + 4 > buffer->size) return;
+    for (short i = 0; i < 4; i++)
+    {
+        buffer->data[offset + i] = (unsigned char)((value >> (8 * i)) & 0xFF);
+    }
+}
+
+//--------------------
+// READER FUNCTIONS
+//--------------------
+
+static bool SaveReaderHas(SaveReader* reader, size_t count)
+{
+    if (!reader->ok || reader->pos + count > reader->size)
+    {
+        reader->ok = false;
+        return false;
+    }
+    return true;
+}
+
+unsigned char SaveReadU8(SaveReader* reader)
+{
+    if (!SaveReaderHas(reader, 1)) return 0;
+    return reader->data[reader->pos++];
+}
+
+unsigned short SaveReadU16(SaveReader* reader)
+{
+    if (!SaveReaderHas(reader, 2)) return 0;
+    unsigned short value = (unsigned short)(reader->data[reader->pos] | (reader->data[reader->pos + 1] << 8));
+    reader->pos += 2;
+    return value;
+}
+
+unsigned int SaveReadU32(SaveReader* reader)
+{
+    if (!SaveReaderHas(reader, 4)) return 0;
+    unsigned int value = 0;
+    for (short i = 0; i < 4; i++)
+    {
+        value |= (unsigned int)reader->data[reader->pos + i] << (8 * i);
+    }
+    reader->pos += 4;
+    return value;
+}
+
+float SaveReadF32(SaveReader* reader)
+{
+    unsigned int bits = SaveReadU32(reader);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+void SaveReadString(SaveReader* reader, char* out, size_t outSize)
+{
+    unsigned short length = SaveReadU16(reader);
+    if (!SaveReaderHas(reader, length))
+    {
+        if (outSize > 0) out[0] = '\0';
+        return;
+    }
+    size_t copied = length < outSize - 1 ? length : outSize - 1;
+    memcpy(out, reader->data + reader->pos, copied);
+    out[copied] = '\0';
+    reader->pos += length;
+}
+
+// Saves hold text; in memory it lives in the string pool
+StringID SaveReadInterned(SaveReader* reader)
+{
+    char text[MAX_STRING_LENGTH];
+    SaveReadString(reader, text, sizeof(text));
+    return reader->ok ? StringPoolIntern(text) : STRING_NONE;
+}
+
+//--------------------
+// CHECKSUM
+//--------------------
+
+typedef struct SaveCrcTable
+{
+    unsigned int entries[256];
+}SaveCrcTable;
+
+static SaveCrcTable SaveBuildCrcTable()
+{
+    SaveCrcTable table;
+    for (unsigned int i = 0; i < 256; i++)
+    {
+        unsigned int crc = i;
+        for (short bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+        }
+        table.entries[i] = crc;
+    }
+    return table;
+}
+
+// Standard CRC-32 (IEEE 802.3)
+unsigned int SaveChecksum(const unsigned char* data, size_t size)
+{
+    static const SaveCrcTable table = SaveBuildCrcTable();
+    unsigned int crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; i++)
+    {
+        crc = table.entries[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+//--------------------
+// SECTION ENCODERS
+//--------------------
+
+void SaveEncodePlayer(SaveBuffer* buffer, Player* player)
+{
+    SaveBufferWriteString(buffer, player->name);
+    SaveBufferWriteU16(buffer, player->health);
+    SaveBufferWriteU16(buffer, player->maxHealth);
+    SaveBufferWriteU16(buffer, player->attack);
+    SaveBufferWriteU16(buffer, player->defense);
+    SaveBufferWriteU16(buffer, player->exp);
+    SaveBufferWriteU16(buffer, player->level);
+    SaveBufferWriteU32(buffer, (unsigned int)player->gold);
+    SaveBufferWriteU16(buffer, player->currentRoom);
+    SaveBufferWriteU8(buffer, (unsigned char)player->trait);
+    SaveBufferWriteU8(buffer, (unsigned char)player->difficulty);
+    SaveBufferWriteU8(buffer, player->canCharmEnemies ? 1 : 0);
+    SaveBufferWriteF32(buffer, player->goldMultiplier);
+    SaveBufferWriteF32(buffer, player->expMultiplier);
+
+    SaveBufferWriteU16(buffer, player->statusEffectCount);
+    for (unsigned short i = 0; i < player->statusEffectCount; i++)
+    {
+        StatusEffect* effect = &player->statusEffect[i];
+        SaveBufferWriteU8(buffer, (unsigned char)effect->type);
+        SaveBufferWriteU16(buffer, effect->duration);
+        SaveBufferWriteU16(buffer, effect->damagePerTurn);
+        SaveBufferWriteU16(buffer, (unsigned short)effect->statModifier);
+    }
+
+    SaveBufferWriteU16(buffer, player->abilityCount);
+    for (unsigned short i = 0; i < player->abilityCount; i++)
+    {
+        Ability* ability = &player->unlockedAbilities[i];
+        SaveBufferWriteU16(buffer, ability->abilityId);
+        SaveBufferWriteString(buffer, StringPoolGet(ability->name));
+        SaveBufferWriteString(buffer, StringPoolGet(ability->description));
+        SaveBufferWriteU16(buffer, ability->unlockedAtLevel);
+        SaveBufferWriteF32(buffer, ability->damageMultiplier);
+        SaveBufferWriteU32(buffer, (unsigned int)ability->cooldown);
+        SaveBufferWriteU32(buffer, (unsigned int)ability->cooldownRemaining);
+    }
+}
+
+void SaveEncodeItem(SaveBuffer* buffer, const ItemData* item)
+{
+    SaveBufferWriteU16(buffer, (unsigned short)item->itemID);
+    char description[MAX_DESCRIPTION_LENGTH];
+    SaveBufferWriteString(buffer, StringPoolGet(item->name));
+    SaveBufferWriteString(buffer, ItemGetDescription(item, description, sizeof(description)));
+    SaveBufferWriteU8(buffer, (unsigned char)item->rarity);
+    SaveBufferWriteU8(buffer, (unsigned char)item->type);
+    SaveBufferWriteU16(buffer, (unsigned short)item->value);
+    SaveBufferWriteU16(buffer, (unsigned short)item->cost);
+    SaveBufferWriteU16(buffer, (unsigned short)item->quantity);
+}
+
+void SaveEncodeInventory(SaveBuffer* buffer, Inventory* inventory)
+{
+    SaveBufferWriteU16(buffer, (unsigned short)inventory->itemCount);
+    for (short i = 0; i < inventory->itemCount; i++)
+    {
+        SaveEncodeItem(buffer, &inventory->items[i]);
+    }
+}
+
+void SaveEncodeQuests(SaveBuffer* buffer, QuestLog* questLog)
+{
+    SaveBufferWriteU16(buffer, (unsigned short)questLog->questCount);
+    for (short i = 0; i < questLog->questCount; i++)
+    {
+        Quest* quest = &questLog->quests[i];
+        SaveBufferWriteU16(buffer, (unsigned short)quest->questID);
+        SaveBufferWriteString(buffer, quest->title);
+        SaveBufferWriteString(buffer, quest->description);
+        SaveBufferWriteU8(buffer, (unsigned char)quest->objectiveType);
+        SaveBufferWriteU16(buffer, (unsigned short)quest->targetValue);
+        SaveBufferWriteU16(buffer, (unsigned short)quest->currentProgress);
+        SaveBufferWriteU16(buffer, (unsigned short)quest->rewardGold);
+        SaveBufferWriteU8(buffer, quest->completed ? 1 : 0);
+    }
+}
+
+void SaveEncodeStats(SaveBuffer* buffer, GameStats* stats)
+{
+    SaveBufferWriteU16(buffer, stats->totalEnemiesDefeated);
+    SaveBufferWriteU16(buffer, stats->totalGoldEarned);
+    SaveBufferWriteU16(buffer, stats->totalDamageDealt);
+    SaveBufferWriteU16(buffer, stats->totalDamageTaken);
+    SaveBufferWriteU16(buffer, stats->itemsCollected);
+    SaveBufferWriteU16(buffer, stats->questsCompleted);
+    SaveBufferWriteU16(buffer, stats->totalPlaytime);
+    SaveBufferWriteU16(buffer, stats->deathCount);
+}
+
+// Shop, boss, explored and generated as bits 0-3, the layout saves and journal records use
+unsigned char SaveRoomFlags(const Dungeon* dungeon, short roomIndex)
+{
+    const Room* room = &dungeon->rooms[roomIndex];
+    return (unsigned char)((RoomHasShop(room) ? 1 : 0) | (RoomHasBoss(room) ? 2 : 0) |
+        (DungeonIsExplored(dungeon, roomIndex) ? 4 : 0) | (RoomIsGenerated(room) ? 8 : 0));
+}
+
+void SaveApplyRoomFlags(Dungeon* dungeon, short roomIndex, EncounterType encounter, unsigned char flags)
+{
+    Room* room = &dungeon->rooms[roomIndex];
+    room->state = (unsigned char)((encounter & ROOM_ENCOUNTER_MASK) | ((flags & 1) != 0 ? ROOM_FLAG_SHOP : 0) |
+        ((flags & 2) != 0 ? ROOM_FLAG_BOSS : 0) | ((flags & 8) != 0 ? ROOM_FLAG_GENERATED : 0));
+    unsigned long long bit = 1ull << (roomIndex & 63);
+    if ((flags & 4) != 0)
+    {
+        dungeon->explored[roomIndex >> 6] |= bit;
+    }
+    else
+    {
+        dungeon->explored[roomIndex >> 6] &= ~bit;
+    }
+    DungeonBumpGeneration(dungeon);
+}
+
+// u32 seed | u16 totalRooms | u16 count | count x { u16 index | u8 encounter | u8 flags }
+// Since version 2: | u8 topology kind | u16 rows | u16 cols [| rows * cols x u8 exit mask, links only]
+// | u8 fill | u8 loop | u8 enemy | u8 treasure | u8 quest | u8 shop | u8 tiers | u8 min boss distance.
+// Rooms that were never entered are planned again on load by running the generator with the same
+// seed and params; the stored topology checks that it came out the same.
+void SaveEncodeDungeon(SaveBuffer* buffer, Dungeon* dungeon)
+{
+    unsigned short generatedCount = 0;
+    for (short i = 0; i < dungeon->totalRooms; i++)
+    {
+        if (RoomIsGenerated(&dungeon->rooms[i])) generatedCount++;
+    }
+
+    SaveBufferWriteU32(buffer, dungeon->seed);
+    SaveBufferWriteU16(buffer, (unsigned short)dungeon->totalRooms);
+    SaveBufferWriteU16(buffer, generatedCount);
+    for (short i = 0; i < dungeon->totalRooms; i++)
+    {
+        Room* room = &dungeon->rooms[i];
+        if (!RoomIsGenerated(room)) continue;
+        SaveBufferWriteU16(buffer, (unsigned short)i);
+        SaveBufferWriteU8(buffer, (unsigned char)RoomGetEncounter(room));
+        SaveBufferWriteU8(buffer, SaveRoomFlags(dungeon, i));
+    }
+
+    const DungeonTopology* topology = &dungeon->topology;
+    SaveBufferWriteU8(buffer, (unsigned char)topology->kind);
+    SaveBufferWriteU16(buffer, (unsigned short)topology->rows);
+    SaveBufferWriteU16(buffer, (unsigned short)topology->cols);
+    if (topology->kind == TOPOLOGY_LINKS)
+    {
+        for (short i = 0; i < topology->rows * topology->cols; i++)
+        {
+            SaveBufferWriteU8(buffer, DungeonTopologyGetExits(topology, i));
+        }
+    }
+
+    const DungeonGenParams* params = &dungeon->params;
+    SaveBufferWriteU8(buffer, params->fillPercent);
+    SaveBufferWriteU8(buffer, params->loopPercent);
+    SaveBufferWriteU8(buffer, params->enemyPercent);
+    SaveBufferWriteU8(buffer, params->treasurePercent);
+    SaveBufferWriteU8(buffer, params->questPercent);
+    SaveBufferWriteU8(buffer, params->shopPercent);
+    SaveBufferWriteU8(buffer, params->difficultyTiers);
+    SaveBufferWriteU8(buffer, params->minBossDistance);
+}
+
+//--------------------
+// SECTION DECODERS
+//--------------------
+
+Player* SaveDecodePlayer(SaveReader* reader)
+{
+    Player* player = PlayerCreate();
+    if (player == nullptr) return nullptr;
+
+    SaveReadString(reader, player->name, sizeof(player->name));
+    player->health = SaveReadU16(reader);
+    player->maxHealth = SaveReadU16(reader);
+    player->attack = SaveReadU16(reader);
+    player->defense = SaveReadU16(reader);
+    player->exp = SaveReadU16(reader);
+    player->level = SaveReadU16(reader);
+    player->gold = (int)SaveReadU32(reader);
+    player->currentRoom = SaveReadU16(reader);
+    player->trait = (PlayerTrait)SaveReadU8(reader);
+    player->difficulty = (DifficultyLevel)SaveReadU8(reader);
+    player->canCharmEnemies = SaveReadU8(reader) != 0;
+    player->goldMultiplier = SaveReadF32(reader);
+    player->expMultiplier = SaveReadF32(reader);
+
+    player->statusEffectCount = SaveReadU16(reader);
+    if (player->statusEffectCount > 10) reader->ok = false;
+    for (unsigned short i = 0; reader->ok && i < player->statusEffectCount; i++)
+    {
+        StatusEffect* effect = &player->statusEffect[i];
+        effect->type = (StatusEffectType)SaveReadU8(reader);
+        effect->duration = SaveReadU16(reader);
+        effect->damagePerTurn = SaveReadU16(reader);
+        effect->statModifier = (short)SaveReadU16(reader);
+    }
+
+    player->abilityCount = SaveReadU16(reader);
+    if (player->abilityCount > MAX_ABILITIES) reader->ok = false;
+    for (unsigned short i = 0; reader->ok && i < player->abilityCount; i++)
+    {
+        Ability* ability = &player->unlockedAbilities[i];
+        ability->abilityId = SaveReadU16(reader);
+        ability->name = SaveReadInterned(reader);
+        ability->description = SaveReadInterned(reader);
+        ability->unlockedAtLevel = SaveReadU16(reader);
+        ability->damageMultiplier = SaveReadF32(reader);
+        ability->cooldown = (int)SaveReadU32(reader);
+        ability->cooldownRemaining = (int)SaveReadU32(reader);
+    }
+
+    if (!reader->ok)
+    {
+        free(player);
+        return nullptr;
+    }
+    return player;
+}
+
+void SaveDecodeItem(SaveReader* reader, ItemData* item)
+{
+    item->itemID = (short)SaveReadU16(reader);
+    item->name = SaveReadInterned(reader);
+    item->description = SaveReadInterned(reader);
+    item->rarity = (ItemRarity)SaveReadU8(reader);
+    item->type = (ItemType)SaveReadU8(reader);
+    item->value = (short)SaveReadU16(reader);
+    item->cost = (short)SaveReadU16(reader);
+    item->quantity = (short)SaveReadU16(reader);
+}
+
+Inventory* SaveDecodeInventory(SaveReader* reader)
+{
+    unsigned short itemCount = SaveReadU16(reader);
+    if (itemCount > MAX_INVENTORY)
+    {
+        reader->ok = false;
+        return nullptr;
+    }
+
+    ItemData items[MAX_INVENTORY];
+    for (unsigned short i = 0; reader->ok && i < itemCount; i++)
+    {
+        SaveDecodeItem(reader, &items[i]);
+    }
+    if (!reader->ok) return nullptr;
+
+    Inventory* inventory = InventoryCreate();
+    if (inventory == nullptr) return nullptr;
+
+    for (unsigned short i = 0; i < itemCount; i++)
+    {
+        InventoryAddItem(inventory, items[i]);
+    }
+    return inventory;
+}
+
+QuestLog* SaveDecodeQuests(SaveReader* reader)
+{
+    QuestLog* questLog = QuestInit();
+    if (questLog == nullptr) return nullptr;
+
+    questLog->questCount = (short)SaveReadU16(reader);
+    if (questLog->questCount < 0 || questLog->questCount > MAX_QUESTS) reader->ok = false;
+    for (short i = 0; reader->ok && i < questLog->questCount; i++)
+    {
+        Quest* quest = &questLog->quests[i];
+        quest->questID = (short)SaveReadU16(reader);
+        SaveReadString(reader, quest->title, sizeof(quest->title));
+        SaveReadString(reader, quest->description, sizeof(quest->description));
+        quest->objectiveType = (QuestObjectiveType)SaveReadU8(reader);
+        quest->targetValue = (short)SaveReadU16(reader);
+        quest->currentProgress = (short)SaveReadU16(reader);
+        quest->rewardGold = (short)SaveReadU16(reader);
+        quest->completed = SaveReadU8(reader) != 0;
+    }
+
+    if (!reader->ok)
+    {
+        free(questLog);
+        return nullptr;
+    }
+    return questLog;
+}
+
+GameStats* SaveDecodeStats(SaveReader* reader)
+{
+    GameStats* stats = (GameStats*)malloc(sizeof(GameStats));
+    if (stats == nullptr) return nullptr;
+
+    stats->totalEnemiesDefeated = SaveReadU16(reader);
+    stats->totalGoldEarned = SaveReadU16(reader);
+    stats->totalDamageDealt = SaveReadU16(reader);
+    stats->totalDamageTaken = SaveReadU16(reader);
+    stats->itemsCollected = SaveReadU16(reader);
+    stats->questsCompleted = SaveReadU16(reader);
+    stats->totalPlaytime = SaveReadU16(reader);
+    stats->deathCount = SaveReadU16(reader);
+
+    if (!reader->ok)
+    {
+        free(stats);
+        return nullptr;
+    }
+    return stats;
+}
+
+Dungeon* SaveDecodeDungeon(SaveReader* reader, unsigned short version)
+{
+    Dungeon* dungeon = DungeonInit();
+    if (dungeon == nullptr) return nullptr;
+
+    dungeon->seed = SaveReadU32(reader);
+    dungeon->totalRooms = (short)SaveReadU16(reader);
+    unsigned short generatedCount = SaveReadU16(reader);
+    if (dungeon->totalRooms < 0 || dungeon->totalRooms > MAX_ROOMS || generatedCount > dungeon->totalRooms) reader->ok = false;
+    for (unsigned short i = 0; reader->ok && i < generatedCount; i++)
+    {
+        unsigned short index = SaveReadU16(reader);
+        if (index >= dungeon->totalRooms)
+        {
+            reader->ok = false;
+            break;
+        }
+        EncounterType encounter = (EncounterType)SaveReadU8(reader);
+        unsigned char flags = SaveReadU8(reader);
+        dungeon->rooms[index].description = DungeonGetRoomDescription(index);
+        SaveApplyRoomFlags(dungeon, index, encounter, (unsigned char)(flags | 8));
+    }
+
+    // Version 1 sections stop here; they keep the default grid and were made with the legacy params
+    DungeonGenParams params;
+    DungeonGenLegacyParams(&params);
+    if (reader->ok && version >= 2)
+    {
+        unsigned char kind = SaveReadU8(reader);
+        short rows = (short)SaveReadU16(reader);
+        short cols = (short)SaveReadU16(reader);
+        if (rows <= 0 || cols <= 0 || rows * cols > MAX_ROOMS) reader->ok = false;
+        if (reader->ok && kind == TOPOLOGY_GRID)
+        {
+            DungeonTopologyInitGrid(&dungeon->topology, rows, cols);
+        }
+        else if (reader->ok && kind == TOPOLOGY_LINKS)
+        {
+            unsigned char exits[MAX_ROOMS] = {};
+            for (short i = 0; i < rows * cols; i++)
+            {
+                exits[i] = SaveReadU8(reader);
+            }
+            if (reader->ok) DungeonTopologyInitLinks(&dungeon->topology, rows, cols, exits);
+        }
+        else
+        {
+            reader->ok = false;
+        }
+        params.rows = dungeon->topology.rows;
+        params.cols = dungeon->topology.cols;
+        params.fillPercent = SaveReadU8(reader);
+        params.loopPercent = SaveReadU8(reader);
+        params.enemyPercent = SaveReadU8(reader);
+        params.treasurePercent = SaveReadU8(reader);
+        params.questPercent = SaveReadU8(reader);
+        params.shopPercent = SaveReadU8(reader);
+        params.difficultyTiers = SaveReadU8(reader);
+        params.minBossDistance = SaveReadU8(reader);
+    }
+    if (reader->ok)
+    {
+        DungeonTopology saved = dungeon->topology;
+        short totalRooms = dungeon->totalRooms;
+        reader->ok = DungeonGenerate(dungeon, dungeon->seed, &params) && dungeon->totalRooms == totalRooms &&
+            memcmp(&saved, &dungeon->topology, sizeof(DungeonTopology)) == 0;
+    }
+
+    if (!reader->ok)
+    {
+        free(dungeon);
+        return nullptr;
+    }
+    return dungeon;
+}
+
+// Exits were stored as room indices; they always named grid neighbours, so keep just the masks
+static Dungeon* SaveDecodeDungeonFull(SaveReader* reader)
+{
+    Dungeon* dungeon = DungeonInit();
+    if (dungeon == nullptr) return nullptr;
+
+    dungeon->totalRooms = (short)SaveReadU16(reader);
+    if (dungeon->totalRooms < 0 || dungeon->totalRooms > MAX_ROOMS) reader->ok = false;
+    unsigned char exits[MAX_ROOMS] = {};
+    for (short i = 0; reader->ok && i < dungeon->totalRooms; i++)
+    {
+        Room* room = &dungeon->rooms[i];
+        SaveReadU16(reader); // roomID, always 1000 + index
+        room->description = SaveReadInterned(reader);
+        EncounterType encounter = (EncounterType)SaveReadU8(reader);
+        for (short j = 0; j < 4; j++)
+        {
+            short connection = (short)SaveReadU16(reader);
+            if (connection == -1) continue;
+            if (connection != DungeonGetConnection(dungeon, i, (Direction)j)) reader->ok = false;
+            exits[i] |= (unsigned char)(1 << j);
+        }
+        SaveApplyRoomFlags(dungeon, i, encounter, (unsigned char)(SaveReadU8(reader) | 8));
+    }
+    if (reader->ok) DungeonTopologyInitLinks(&dungeon->topology, DUNGEON_ROWS, DUNGEON_COLS, exits);
+
+    if (!reader->ok)
+    {
+        free(dungeon);
+        return nullptr;
+    }
+    return dungeon;
+}
+
+//--------------------
+// SNAPSHOT FUNCTIONS
+//--------------------
+
+bool SaveEncodeSnapshot(SaveBuffer* buffer, Player* player, Inventory* inventory, QuestLog* questLog, GameStats* stats, Dungeon* dungeon)
+{
+    if (buffer == nullptr || player == nullptr || inventory == nullptr || questLog == nullptr || stats == nullptr || dungeon == nullptr)
+    {
+        printf("ERROR - SaveEncodeSnapshot: missing game state\n");
+        return false;
+    }
+
+    static const SaveSectionId sections[] = { SECTION_PLAYER, SECTION_INVENTORY, SECTION_QUESTS, SECTION_STATS, SECTION_DUNGEON_SEEDED };
+    const unsigned short sectionCount = (unsigned short)(sizeof(sections) / sizeof(sections[0]));
+    buffer->size = 0;
+    buffer->failed = false;
+
+    SaveBufferWriteU32(buffer, SAVE_MAGIC);
+    SaveBufferWriteU16(buffer, SAVE_VERSION);
+    SaveBufferWriteU16(buffer, sectionCount);
+    SaveBufferWriteU32(buffer, 0); // payload size, patched below
+    SaveBufferWriteU32(buffer, 0); // checksum, patched below
+
+    size_t tableOffset = buffer->size;
+    for (unsigned short i = 0; i < sectionCount; i++)
+    {
+        SaveBufferWriteU16(buffer, 0);
+        SaveBufferWriteU16(buffer, 0);
+        SaveBufferWriteU32(buffer, 0);
+        SaveBufferWriteU32(buffer, 0);
+    }
+
+    for (unsigned short i = 0; i < sectionCount; i++)
+    {
+        SaveSectionId id = sections[i];
+        size_t start = buffer->size;
+        switch (id)
+        {
+        case SECTION_PLAYER: SaveEncodePlayer(buffer, player); break;
+        case SECTION_INVENTORY: SaveEncodeInventory(buffer, inventory); break;
+        case SECTION_QUESTS: SaveEncodeQuests(buffer, questLog); break;
+        case SECTION_STATS: SaveEncodeStats(buffer, stats); break;
+        case SECTION_DUNGEON: break;
+        case SECTION_DUNGEON_SEEDED: SaveEncodeDungeon(buffer, dungeon); break;
+        }
+        size_t entry = tableOffset + (size_t)i * SAVE_SECTION_ENTRY_SIZE;
+        SaveBufferPatchU32(buffer, entry, (unsigned int)id);
+        SaveBufferPatchU32(buffer, entry + 4, (unsigned int)start);
+        SaveBufferPatchU32(buffer, entry + 8, (unsigned int)(buffer->size - start));
+    }
+
+    if (buffer->failed) return false;
+
+    SaveBufferPatchU32(buffer, 8, (unsigned int)(buffer->size - SAVE_HEADER_SIZE));
+    SaveBufferPatchU32(buffer, 12, SaveChecksum(buffer->data + SAVE_HEADER_SIZE, buffer->size - SAVE_HEADER_SIZE));
+    return true;
+}
+
+bool SaveDecodeSnapshot(const unsigned char* data, size_t size, Player** player, Inventory** inventory, QuestLog** questLog, GameStats** stats, Dungeon** dungeon)
+{
+    if (data == nullptr || size < SAVE_HEADER_SIZE)
+    {
+        printf("ERROR - Save file is truncated\n");
+        return false;
+    }
+
+    SaveReader header = { data, size, 0, true };
+    unsigned int magic = SaveReadU32(&header);
+    unsigned short version = SaveReadU16(&header);
+    unsigned short sectionCount = SaveReadU16(&header);
+    unsigned int payloadSize = SaveReadU32(&header);
+    unsigned int checksum = SaveReadU32(&header);
+
+    if (magic != SAVE_MAGIC)
+    {
+        printf("ERROR - Not a dungeon crawler save file\n");
+        return false;
+    }
+    if (version == 0 || version > SAVE_VERSION)
+    {
+        printf("ERROR - Unsupported save version %hu (expected at most %d)\n", version, SAVE_VERSION);
+        return false;
+    }
+    if (payloadSize != size - SAVE_HEADER_SIZE || SaveChecksum(data + SAVE_HEADER_SIZE, payloadSize) != checksum)
+    {
+        printf("ERROR - Save file is corrupted (checksum mismatch)\n");
+        return false;
+    }
+
+    Player* loadedPlayer = nullptr;
+    Inventory* loadedInventory = nullptr;
+    QuestLog* loadedQuests = nullptr;
+    GameStats* loadedStats = nullptr;
+    Dungeon* loadedDungeon = nullptr;
+    unsigned int sectionsSeen = 0;
+    bool ok = true;
+
+    for (unsigned short i = 0; ok && i < sectionCount; i++)
+    {
+        unsigned short id = SaveReadU16(&header);
+        SaveReadU16(&header);
+        unsigned int offset = SaveReadU32(&header);
+        unsigned int length = SaveReadU32(&header);
+        if (!header.ok || offset > size || length > size - offset)
+        {
+            ok = false;
+            break;
+        }
+        if (id < 32)
+        {
+            if (sectionsSeen & (1u << id))
+            {
+                ok = false;
+                break;
+            }
+            sectionsSeen |= 1u << id;
+        }
+
+        SaveReader section = { data + offset, length, 0, true };
+        switch (id)
+        {
+        case SECTION_PLAYER: loadedPlayer = SaveDecodePlayer(&section); break;
+        case SECTION_INVENTORY: loadedInventory = SaveDecodeInventory(&section); break;
+        case SECTION_QUESTS: loadedQuests = SaveDecodeQuests(&section); break;
+        case SECTION_STATS: loadedStats = SaveDecodeStats(&section); break;
+        case SECTION_DUNGEON:
+        case SECTION_DUNGEON_SEEDED:
+            if (loadedDungeon != nullptr)
+            {
+                section.ok = false;
+                break;
+            }
+            loadedDungeon = id == SECTION_DUNGEON ? SaveDecodeDungeonFull(&section) : SaveDecodeDungeon(&section, version);
+            break;
+        default: break; // Unknown sections from newer writers are skipped
+        }
+        ok = section.ok;
+    }
+
+    if (!ok || loadedPlayer == nullptr || loadedInventory == nullptr || loadedQuests == nullptr || loadedStats == nullptr || loadedDungeon == nullptr)
+    {
+        printf("ERROR - Save file has missing or malformed sections\n");
+        free(loadedPlayer);
+        InventoryFree(loadedInventory);
+        free(loadedQuests);
+        free(loadedStats);
+        free(loadedDungeon);
+        return false;
+    }
+
+    *player = loadedPlayer;
+    *inventory = loadedInventory;
+    *questLog = loadedQuests;
+    *stats = loadedStats;
+    *dungeon = loadedDungeon;
+    return true;
+}
+
+bool SaveWriteFileAtomic(const char* path, const unsigned char* data, size_t size)
+{
+    char tempPath[MAX_STRING_LENGTH];
+    sprintf_s(tempPath, sizeof(tempPath), "%s.tmp", path);
+
+    FILE* file;
+    errno_t err = fopen_s(&file, tempPath, "wb");
+    if (err != 0 || file == nullptr)
+    {
+        printf("ERROR - Failed to open save file\n");
+        return false;
+    }
+
+    // Flush to disk before the rename so a crash leaves either the old file or the new one
+    bool written = fwrite(data, 1, size, file) == size && fflush(file) == 0 && _commit(_fileno(file)) == 0;
+    written = fclose(file) == 0 && written;
+    written = written && MoveFileExA(tempPath, path, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+
+    if (!written)
+    {
+        printf("ERROR - Failed to write save file\n");
+        remove(tempPath);
+    }
+    return written;
+}
+
+bool SaveWriteSnapshot(const char* path, Player* player, Inventory* inventory, QuestLog* questLog, GameStats* stats, Dungeon* dungeon)
+{
+    SaveBuffer buffer;
+    SaveBufferInit(&buffer);
+    bool written = SaveEncodeSnapshot(&buffer, player, inventory, questLog, stats, dungeon) &&
+        SaveWriteFileAtomic(path, buffer.data, buffer.size);
+    SaveBufferFree(&buffer);
+    return written;
+}
+
+bool SaveReadSnapshotChecksum(const char* path, unsigned int* checksum)
+{
+    FILE* file;
+    if (fopen_s(&file, path, "rb") != 0 || file == nullptr) return false;
+
+    unsigned char header[SAVE_HEADER_SIZE];
+    bool read = fread(header, 1, sizeof(header), file) == sizeof(header);
+    fclose(file);
+    if (!read) return false;
+
+    SaveReader reader = { header, sizeof(header), 12, true };
+    *checksum = SaveReadU32(&reader);
+    return reader.ok;
+}
+
+bool SaveReadSnapshot(const char* path, Player** player, Inventory** inventory, QuestLog** questLog, GameStats** stats, Dungeon** dungeon)
+{
+    FILE* file;
+    errno_t err = fopen_s(&file, path, "rb");
+    if (err != 0 || file == nullptr)
+    {
+        printf("ERROR - Failed to open save file\n");
+        return false;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long fileSize = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (fileSize <= 0)
+    {
+        fclose(file);
+        printf("ERROR - Save file is empty\n");
+        return false;
+    }
+
+    unsigned char* data = (unsigned char*)malloc((size_t)fileSize);
+    if (data == nullptr)
+    {
+        fclose(file);
+        printf("ERROR - Failed to allocate memory for save file\n");
+        return false;
+    }
+
+    bool read = fread(data, 1, (size_t)fileSize, file) == (size_t)fileSize;
+    fclose(file);
+
+    bool loaded = read && SaveDecodeSnapshot(data, (size_t)fileSize, player, inventory, questLog, stats, dungeon);
+    free(data);
+    return loaded;
+}
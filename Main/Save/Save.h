@@ -0,0 +1,111 @@
+#pragma once
+
+#include "../Game/Game.h"
+
+//--------------------
+// SAVE FORMAT CONSTANTS
+//--------------------
+
+#define SAVE_FILE_NAME "savegame.dat"
+#define LEGACY_SAVE_FILE_NAME "savegame.txt"
+#define SAVE_JOURNAL_FILE_NAME "savegame.journal"
+#define SAVE_MAGIC 0x56534344u // "DCSV" read as a little-endian u32
+#define SAVE_VERSION 2 // Version 1 dungeons were always the legacy grid and stored no topology or generator params
+#define SAVE_HEADER_SIZE 16 // NOLINT(modernize-macro-to-enum)
+#define SAVE_SECTION_ENTRY_SIZE 12 // NOLINT(modernize-macro-to-enum)
+
+//--------------------
+// SAVE FORMAT ENUMS
+//--------------------
+
+typedef enum
+{
+    SECTION_PLAYER = 1,
+    SECTION_INVENTORY = 2,
+    SECTION_QUESTS = 3,
+    SECTION_STATS = 4,
+    SECTION_DUNGEON = 5, // Every room in full; only read, for saves made before rooms were generated lazily
+    SECTION_DUNGEON_SEEDED = 6, // Dungeon seed, the rooms generated so far and the topology
+
+}SaveSectionId;
+
+//--------------------
+// SAVE FORMAT STRUCTS
+//--------------------
+
+// Growable little-endian output buffer. The whole snapshot is built here and written once.
+typedef struct SaveBuffer
+{
+    unsigned char* data;
+    size_t size;
+    size_t capacity;
+    bool failed;
+}SaveBuffer;
+
+// Bounds-checked cursor over a loaded snapshot. Any overrun clears ok.
+typedef struct SaveReader
+{
+    const unsigned char* data;
+    size_t size;
+    size_t pos;
+    bool ok;
+}SaveReader;
+
+//--------------------
+// SNAPSHOT FUNCTIONS
+//--------------------
+
+//
+// File layout (all integers little-endian):
+//   header   u32 magic | u16 version | u16 sectionCount | u32 payloadSize | u32 crc32(payload)
+//   payload  sectionCount x { u16 id | u16 reserved | u32 offset | u32 size }, then section bodies
+// Offsets are relative to the start of the file.
+//
+bool SaveWriteSnapshot(const char* path, Player* player, Inventory* inventory, QuestLog* questLog, GameStats* stats, Dungeon* dungeon);
+bool SaveReadSnapshot(const char* path, Player** player, Inventory** inventory, QuestLog** questLog, GameStats** stats, Dungeon** dungeon);
+bool SaveEncodeSnapshot(SaveBuffer* buffer, Player* player, Inventory* inventory, QuestLog* questLog, GameStats* stats, Dungeon* dungeon);
+bool SaveDecodeSnapshot(const unsigned char* data, size_t size, Player** player, Inventory** inventory, QuestLog** questLog, GameStats** stats, Dungeon** dungeon);
+unsigned int SaveChecksum(const unsigned char* data, size_t size);
+bool SaveReadSnapshotChecksum(const char* path, unsigned int* checksum);
+bool SaveWriteFileAtomic(const char* path, const unsigned char* data, size_t size);
+
+//--------------------
+// SECTION FUNCTIONS
+//--------------------
+
+// Shared with the save journal, which logs whole sections when a delta would not be smaller
+void SaveEncodePlayer(SaveBuffer* buffer, Player* player);
+void SaveEncodeItem(SaveBuffer* buffer, const ItemData* item);
+void SaveEncodeInventory(SaveBuffer* buffer, Inventory* inventory);
+void SaveEncodeQuests(SaveBuffer* buffer, QuestLog* questLog);
+void SaveEncodeStats(SaveBuffer* buffer, GameStats* stats);
+void SaveEncodeDungeon(SaveBuffer* buffer, Dungeon* dungeon);
+
+Player* SaveDecodePlayer(SaveReader* reader);
+void SaveDecodeItem(SaveReader* reader, ItemData* item);
+Inventory* SaveDecodeInventory(SaveReader* reader);
+QuestLog* SaveDecodeQuests(SaveReader* reader);
+GameStats* SaveDecodeStats(SaveReader* reader);
+Dungeon* SaveDecodeDungeon(SaveReader* reader, unsigned short version);
+unsigned char SaveRoomFlags(const Dungeon* dungeon, short roomIndex);
+void SaveApplyRoomFlags(Dungeon* dungeon, short roomIndex, EncounterType encounter, unsigned char flags);
+
+//--------------------
+// BUFFER FUNCTIONS
+//--------------------
+
+void SaveBufferInit(SaveBuffer* buffer);
+void SaveBufferFree(SaveBuffer* buffer);
+void SaveBufferWriteU8(SaveBuffer* buffer, unsigned char value);
+void SaveBufferWriteU16(SaveBuffer* buffer, unsigned short value);
+void SaveBufferWriteU32(SaveBuffer* buffer, unsigned int value);
+void SaveBufferWriteF32(SaveBuffer* buffer, float value);
+void SaveBufferWriteString(SaveBuffer* buffer, const char* text);
+void SaveBufferPatchU32(SaveBuffer* buffer, size_t offset, unsigned int value);
+
+unsigned char SaveReadU8(SaveReader* reader);
+unsigned short SaveReadU16(SaveReader* reader);
+unsigned int SaveReadU32(SaveReader* reader);
+float SaveReadF32(SaveReader* reader);
+void SaveReadString(SaveReader* reader, char* out, size_t outSize);
+StringID SaveReadInterned(SaveReader* reader);
@@ -0,0 +1,403 @@
+#include "Sim.h"
+#include "../Game/DungeonPath.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+// Slice of game indices owned by one worker. Owners and thieves both claim
+// indices with fetch_add, so an idle worker can drain a busy worker's slice.
+struct SimWorkRange
+{
+    std::atomic<unsigned int> next;
+    unsigned int end;
+};
+
+//--------------------
+// BOT HELPERS
+//--------------------
+
+static short SimBotFindPotion(SimBot* bot)
+{
+    ItemData* potion = InventoryFindFirstOfType(bot->game->inventory, POTION);
+    return potion != nullptr ? potion->itemID : 0;
+}
+
+static bool SimBotIsHurt(SimBot* bot, float threshold)
+{
+    Player* player = bot->game->player;
+    return player->health < (unsigned short)(player->maxHealth * threshold);
+}
+
+static short SimBotChooseAbility(SimBot* bot)
+{
+    Player* player = bot->game->player;
+    for (unsigned short i = 0; i < player->abilityCount; i++)
+    {
+        if (AbilityCanUse(&player->unlockedAbilities[i]))
+        {
+            return (short)(i + 1);
+        }
+    }
+    return 0;
+}
+
+static short SimBotChooseDirection(SimBot* bot)
+{
+    Player* player = bot->game->player;
+    Dungeon* dungeon = bot->game->dungeon;
+    short current = (short)player->currentRoom;
+
+    // Explore next door first, then head for the boss once strong enough, else the nearest
+    // unexplored room. Each is a lookup in the game's cached distance fields.
+    short step = -1;
+    if (DungeonPathDistance(&bot->game->paths, dungeon, PATH_TARGET_UNEXPLORED, current) == 1)
+    {
+        step = DungeonPathNextStep(&bot->game->paths, dungeon, PATH_TARGET_UNEXPLORED, current);
+    }
+    else if (player->level >= MAX_LEVEL - 2)
+    {
+        step = DungeonPathNextStep(&bot->game->paths, dungeon, PATH_TARGET_BOSS, current);
+    }
+    if (step == -1)
+    {
+        step = DungeonPathNextStep(&bot->game->paths, dungeon, PATH_TARGET_UNEXPLORED, current);
+    }
+    if (step != -1) return (short)(step + 1);
+
+    short valid[4];
+    short validCount = 0;
+    for (short i = 0; i < 4; i++)
+    {
+        if (DungeonGetConnection(dungeon, current, (Direction)i) != -1)
+        {
+            valid[validCount] = (short)(i + 1);
+            validCount++;
+        }
+    }
+    if (validCount == 0) return 1;
+    return valid[RandomShort(0, (short)(validCount - 1))];
+}
+
+static void SimBotTrackLevel(SimBot* bot)
+{
+    unsigned short level = bot->game->player->level;
+    while (bot->lastLevel < level)
+    {
+        bot->lastLevel++;
+        unsigned short bucket = bot->lastLevel < MAX_LEVEL ? bot->lastLevel : MAX_LEVEL;
+        if (bot->levelReachedTurn[bucket] == 0)
+        {
+            bot->levelReachedTurn[bucket] = bot->turns;
+        }
+    }
+}
+
+static short SimBotChooseAction(SimBot* bot)
+{
+    if (bot->openingInventory)
+    {
+        bot->openingInventory = false;
+        return 'U';
+    }
+
+    bot->turns++;
+    SimBotTrackLevel(bot);
+    if (bot->turns >= bot->maxTurns)
+    {
+        bot->quitting = true;
+    }
+    if (bot->quitting)
+    {
+        bot->inPauseMenu = true;
+        return '8';
+    }
+
+    if (SimBotIsHurt(bot, 0.5f))
+    {
+        short potionID = SimBotFindPotion(bot);
+        if (potionID != 0)
+        {
+            bot->openingInventory = true;
+            bot->pendingItemID = potionID;
+            return '3';
+        }
+    }
+    return '1';
+}
+
+static short SimBotChooseCombatAction(SimBot* bot)
+{
+    if (bot->quitting) return 4;
+
+    if (SimBotIsHurt(bot, 0.35f))
+    {
+        short potionID = SimBotFindPotion(bot);
+        if (potionID != 0)
+        {
+            bot->pendingItemID = potionID;
+            return 3;
+        }
+    }
+    if (SimBotChooseAbility(bot) != 0) return 2;
+    return 1;
+}
+
+//--------------------
+// SIMULATION FUNCTIONS
+//--------------------
+
+short SimBotPolicy(void* context, InputKind kind, short minChoice, short maxChoice)
+{
+    SimBot* bot = (SimBot*)context;
+    GameInstance* game = bot->game;
+
+    switch (kind)
+    {
+    case INPUT_CONFIRM:
+        {
+            return 1;
+        }
+    case INPUT_DIRECTION:
+        {
+            return SimBotChooseDirection(bot);
+        }
+    case INPUT_NUMBER:
+        {
+            short itemID = bot->pendingItemID;
+            bot->pendingItemID = 0;
+            return itemID;
+        }
+    case INPUT_CHAR:
+        {
+            if (game->currentState == GAME_LOOP) return SimBotChooseAction(bot);
+            return 'N';
+        }
+    case INPUT_MENU:
+        {
+            switch (game->currentState)
+            {
+            case MAIN_MENU:
+                return 1; // New Game
+            case CHARACTER_CREATION:
+                return RandomShort(minChoice, maxChoice); // Trait
+            case DIFFICULTY_SELECT:
+                return 2; // Normal
+            case PAUSE_MENU:
+                return bot->quitting ? 0 : 1;
+            case GAME_LOOP:
+                {
+                    if (bot->inPauseMenu) return 0;
+                    if (minChoice == 0) return SimBotChooseAbility(bot);
+                    if (maxChoice == 4) return SimBotChooseCombatAction(bot);
+                    return maxChoice == 3 ? 3 : 1; // Leave shop / leave treasure behind
+                }
+            default:
+                return minChoice;
+            }
+        }
+    }
+    return minChoice;
+}
+
+bool SimPlayGame(const RandomState* random, unsigned int maxTurns, SimResult* result)
+{
+    GameInstance* game = GameInit();
+    if (game == nullptr)
+    {
+        return false;
+    }
+    game->random = *random;
+
+    SimBot bot = {};
+    bot.game = game;
+    bot.maxTurns = maxTurns;
+    bot.lastLevel = 1;
+
+    UI::UI_EnableHeadless(SimBotPolicy, &bot);
+    GameRun(game);
+    UI::UI_DisableHeadless();
+    if (game->player != nullptr)
+    {
+        SimBotTrackLevel(&bot);
+    }
+
+    // An unvisited boss room has not been generated yet, so hasBoss alone would read as a win
+    const Room* bossRoom = game->dungeon != nullptr ? &game->dungeon->rooms[game->dungeon->bossRoom] : nullptr;
+    bool bossDefeated = bossRoom != nullptr && RoomIsGenerated(bossRoom) && !RoomHasBoss(bossRoom);
+    if (bossDefeated)
+    {
+        result->gamesWon++;
+    }
+    else if (game->player != nullptr && game->player->health == 0)
+    {
+        result->gamesLost++;
+    }
+    else
+    {
+        result->gamesAbandoned++;
+    }
+    result->gamesPlayed++;
+    result->totalDeaths += game->stats->deathCount;
+    result->totalTurns += bot.turns;
+    result->totalEnemiesDefeated += game->stats->totalEnemiesDefeated;
+    result->totalItemsCollected += game->stats->itemsCollected;
+
+    if (game->player != nullptr)
+    {
+        unsigned short level = game->player->level;
+        result->finalLevelHistogram[level < MAX_LEVEL ? level : MAX_LEVEL]++;
+    }
+    for (short i = 2; i <= MAX_LEVEL; i++)
+    {
+        if (bot.levelReachedTurn[i] != 0)
+        {
+            result->levelReachedCount[i]++;
+            result->levelReachedTurnSum[i] += bot.levelReachedTurn[i];
+        }
+    }
+
+    GameFree(game);
+    return true;
+}
+
+void SimMergeResults(SimResult* into, const SimResult* from)
+{
+    if (into == nullptr || from == nullptr) return;
+
+    into->gamesPlayed += from->gamesPlayed;
+    into->gamesWon += from->gamesWon;
+    into->gamesLost += from->gamesLost;
+    into->gamesAbandoned += from->gamesAbandoned;
+    into->totalDeaths += from->totalDeaths;
+    into->totalTurns += from->totalTurns;
+    into->totalEnemiesDefeated += from->totalEnemiesDefeated;
+    into->totalItemsCollected += from->totalItemsCollected;
+    for (short i = 0; i <= MAX_LEVEL; i++)
+    {
+        into->finalLevelHistogram[i] += from->finalLevelHistogram[i];
+        into->levelReachedCount[i] += from->levelReachedCount[i];
+        into->levelReachedTurnSum[i] += from->levelReachedTurnSum[i];
+    }
+}
+
+static void SimWorkerRun(SimWorkRange* ranges, unsigned int workerCount, unsigned int self,
+                         const RandomState* streams, unsigned int maxTurns, SimResult* result, std::atomic<bool>* failed)
+{
+    // Own slice first, then steal from the other workers in turn
+    for (unsigned int k = 0; k < workerCount; k++)
+    {
+        SimWorkRange* range = &ranges[(self + k) % workerCount];
+        while (true)
+        {
+            unsigned int index = range->next.fetch_add(1);
+            if (index >= range->end) break;
+            if (!SimPlayGame(&streams[index], maxTurns, result))
+            {
+                failed->store(true);
+            }
+        }
+    }
+}
+
+bool SimRunBatch(const SimConfig* config, SimResult* result)
+{
+    if (config == nullptr || result == nullptr)
+    {
+        printf("ERROR - SimRunBatch: config or result is null\n");
+        return false;
+    }
+
+    *result = {};
+    unsigned int maxTurns = config->maxTurns > 0 ? config->maxTurns : SIM_DEFAULT_MAX_TURNS;
+    unsigned int workerCount = config->threadCount;
+    if (workerCount == 0) workerCount = std::thread::hardware_concurrency();
+    if (workerCount == 0) workerCount = 1;
+    if (config->gameCount > 0 && workerCount > config->gameCount) workerCount = config->gameCount;
+
+    std::vector<SimWorkRange> ranges(workerCount);
+    std::vector<SimResult> workerResults(workerCount);
+    for (unsigned int w = 0; w < workerCount; w++)
+    {
+        ranges[w].next.store((unsigned int)((unsigned long long)config->gameCount * w / workerCount));
+        ranges[w].end = (unsigned int)((unsigned long long)config->gameCount * (w + 1) / workerCount);
+        workerResults[w] = {};
+    }
+    std::atomic<bool> failed(false);
+
+    // Game i always plays on the i-th stream of the base seed, whichever worker runs it
+    std::vector<RandomState> streams(config->gameCount > 0 ? config->gameCount : 1);
+    RandomState master;
+    RandomSeed(&master, config->baseSeed);
+    for (unsigned int i = 0; i < config->gameCount; i++)
+    {
+        RandomSplit(&master, &streams[i]);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (unsigned int w = 1; w < workerCount; w++)
+    {
+        threads.emplace_back(SimWorkerRun, ranges.data(), workerCount, w, streams.data(), maxTurns, &workerResults[w], &failed);
+    }
+    SimWorkerRun(ranges.data(), workerCount, 0, streams.data(), maxTurns, &workerResults[0], &failed);
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    for (unsigned int w = 0; w < workerCount; w++)
+    {
+        SimMergeResults(result, &workerResults[w]);
+    }
+    result->threadCount = workerCount;
+    result->elapsedSeconds = std::chrono::duration<double>(end - start).count();
+
+    if (failed.load())
+    {
+        printf("ERROR - SimRunBatch: one or more games failed to start\n");
+        return false;
+    }
+    return true;
+}
+
+void SimPrintReport(const SimResult* result)
+{
+    if (result == nullptr) return;
+
+    UI::UI_PrintHeader("SIMULATION REPORT");
+    printf("Games Played: %u\n", result->gamesPlayed);
+    printf("Won: %u | Lost: %u | Abandoned: %u\n", result->gamesWon, result->gamesLost, result->gamesAbandoned);
+    printf("Deaths: %u\n", result->totalDeaths);
+    if (result->gamesPlayed > 0)
+    {
+        printf("Win Rate: %.1f%%\n", 100.0 * result->gamesWon / result->gamesPlayed);
+        printf("Average Turns: %.1f\n", (double)result->totalTurns / result->gamesPlayed);
+        printf("Enemies Defeated: %llu | Items Collected: %llu\n", result->totalEnemiesDefeated, result->totalItemsCollected);
+    }
+
+    UI::UI_PrintSection("FINAL LEVEL");
+    for (short i = 1; i <= MAX_LEVEL; i++)
+    {
+        printf("Level %2hd%s: %u\n", i, i == MAX_LEVEL ? "+" : " ", result->finalLevelHistogram[i]);
+    }
+
+    UI::UI_PrintSection("LEVEL CURVE (avg turn reached)");
+    for (short i = 2; i <= MAX_LEVEL; i++)
+    {
+        if (result->levelReachedCount[i] == 0) continue;
+        printf("Level %2hd: %.1f (%u games)\n", i,
+               (double)result->levelReachedTurnSum[i] / result->levelReachedCount[i], result->levelReachedCount[i]);
+    }
+    printf("\n");
+    printf("Threads: %u\n", result->threadCount);
+    printf("Elapsed: %.3f s\n", result->elapsedSeconds);
+    if (result->elapsedSeconds > 0.0)
+    {
+        printf("Throughput: %.1f games/second\n", result->gamesPlayed / result->elapsedSeconds);
+    }
+    UI::UI_PrintDivider();
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "../Game/Game.h"
+#include "../UI/UI.h"
+
+//--------------------
+// SIMULATION CONSTANTS
+//--------------------
+
+#define SIM_DEFAULT_MAX_TURNS 2000 // NOLINT(modernize-macro-to-enum)
+
+//--------------------
+// SIMULATION STRUCTS
+//--------------------
+
+typedef struct SimConfig
+{
+    unsigned int gameCount;
+    unsigned int maxTurns; // Turns before the bot gives up and quits the run
+    unsigned int threadCount; // 0 = one worker per hardware thread
+    unsigned int baseSeed; // Game i plays on the i-th RandomSplit stream of this seed
+}SimConfig;
+
+typedef struct SimResult
+{
+    unsigned int gamesPlayed;
+    unsigned int gamesWon;
+    unsigned int gamesLost;
+    unsigned int gamesAbandoned;
+    unsigned int totalDeaths;
+    unsigned long long totalTurns;
+    unsigned long long totalEnemiesDefeated;
+    unsigned long long totalItemsCollected;
+    unsigned int finalLevelHistogram[MAX_LEVEL + 1]; // Last bucket holds MAX_LEVEL and above
+    unsigned int levelReachedCount[MAX_LEVEL + 1];
+    unsigned long long levelReachedTurnSum[MAX_LEVEL + 1];
+    unsigned int threadCount;
+    double elapsedSeconds;
+}SimResult;
+
+// Scripted player that answers every prompt GameRun raises.
+typedef struct SimBot  // NOLINT(clang-diagnostic-padded)
+{
+    GameInstance* game;
+    unsigned int turns;
+    unsigned int maxTurns;
+    unsigned short lastLevel;
+    unsigned int levelReachedTurn[MAX_LEVEL + 1];
+    short pendingItemID;
+    bool quitting;
+    bool inPauseMenu;
+    bool openingInventory;
+}SimBot;
+
+//--------------------
+// SIMULATION FUNCTIONS
+//--------------------
+
+bool SimRunBatch(const SimConfig* config, SimResult* result);
+bool SimPlayGame(const RandomState* random, unsigned int maxTurns, SimResult* result);
+void SimMergeResults(SimResult* into, const SimResult* from);
+short SimBotPolicy(void* context, InputKind kind, short minChoice, short maxChoice);
+void SimPrintReport(const SimResult* result);
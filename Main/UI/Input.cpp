@@ -0,0 +1,280 @@
+﻿#include "Input.h"
+#include "Terminal.h"
+#include <cstdio>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+typedef struct InputState
+{
+    bool initialized;
+    bool keyboard; // stdin is a terminal, kept in raw mode
+    bool closed;
+    FILE* script; // Lines played back before the keyboard, or stdin when it is not a terminal
+    int keys[INPUT_MAX_KEYS]; // Ring buffer
+    short keyHead;
+    short keyCount;
+    char line[INPUT_LINE_BYTES]; // The line being typed
+    size_t lineLength;
+    InputIdleHandler idleHandler;
+    void* idleContext;
+}InputState;
+
+static InputState input;
+
+//--------------------
+// INPUT HELPERS
+//--------------------
+
+static void InputPushKey(int key)
+{
+    if (key == TERMINAL_KEY_EOF)
+    {
+        input.closed = true;
+        return;
+    }
+    if (key == TERMINAL_KEY_NONE || input.keyCount == INPUT_MAX_KEYS) return;
+    input.keys[(input.keyHead + input.keyCount) % INPUT_MAX_KEYS] = key;
+    input.keyCount++;
+}
+
+static int InputPopKey()
+{
+    if (input.keyCount == 0) return TERMINAL_KEY_NONE;
+    int key = input.keys[input.keyHead];
+    input.keyHead = static_cast<short>((input.keyHead + 1) % INPUT_MAX_KEYS);
+    input.keyCount--;
+    return key;
+}
+
+static size_t InputEncodeUtf8(int codePoint, char* out)
+{
+    if (codePoint < 0x80)
+    {
+        out[0] = static_cast<char>(codePoint);
+        return 1;
+    }
+    if (codePoint < 0x800)
+    {
+        out[0] = static_cast<char>(0xC0 | (codePoint >> 6));
+        out[1] = static_cast<char>(0x80 | (codePoint & 0x3F));
+        return 2;
+    }
+    if (codePoint < 0x10000)
+    {
+        out[0] = static_cast<char>(0xE0 | (codePoint >> 12));
+        out[1] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out[2] = static_cast<char>(0x80 | (codePoint & 0x3F));
+        return 3;
+    }
+    out[0] = static_cast<char>(0xF0 | (codePoint >> 18));
+    out[1] = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+    out[2] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+    out[3] = static_cast<char>(0x80 | (codePoint & 0x3F));
+    return 4;
+}
+
+static void InputCopyLine(char* buffer, size_t size, const char* line, size_t length)
+{
+    if (length >= size) length = size - 1;
+    memcpy(buffer, line, length);
+    buffer[length] = '\0';
+}
+
+// Next line of the script, echoed as if typed. At the end of a script file stdin takes over when it
+// is not a terminal, else the keyboard does; the input closes when neither is left.
+static bool InputTakeScriptLine(char* buffer, size_t size)
+{
+    char line[INPUT_LINE_BYTES];
+    if (fgets(line, sizeof(line), input.script) == nullptr)
+    {
+        bool wasStdin = input.script == stdin;
+        if (!wasStdin) fclose(input.script);
+        input.script = input.keyboard || wasStdin ? nullptr : stdin;
+        input.closed = input.script == nullptr && !input.keyboard;
+        return false;
+    }
+    
+    size_t length = strcspn(line, "\r\n");
+    if (line[length] == '\0' && !feof(input.script))
+    {
+        int c;
+        while ((c = fgetc(input.script)) != EOF && c != '\n') {}
+    }
+    line[length] = '\0';
+    fwrite(line, 1, length, stdout);
+    fputs("\n", stdout);
+    fflush(stdout);
+    InputCopyLine(buffer, size, line, length);
+    return true;
+}
+
+//--------------------
+// INPUT FUNCTIONS
+//--------------------
+
+// Safe to call more than once. True when the keyboard is read in raw mode.
+bool InputInit()
+{
+    if (input.initialized) return input.keyboard;
+    input.initialized = true;
+    input.closed = false;
+    input.keyboard = TerminalSetRawMode(true);
+    if (!input.keyboard) input.script = stdin;
+    return input.keyboard;
+}
+
+void InputShutdown()
+{
+    if (input.script != nullptr && input.script != stdin) fclose(input.script);
+    if (input.keyboard) TerminalSetRawMode(false);
+    memset(&input, 0, sizeof(input));
+}
+
+bool InputOpenScript(const char* path)
+{
+    if (path == nullptr)
+    {
+        printf("ERROR - InputOpenScript: path is null\n");
+        return false;
+    }
+    InputInit();
+    FILE* file = nullptr;
+    if (fopen_s(&file, path, "r") != 0 || file == nullptr)
+    {
+        printf("ERROR - Failed to open input script %s\n", path);
+        return false;
+    }
+    if (input.script != nullptr && input.script != stdin) fclose(input.script);
+    input.script = file;
+    input.closed = false;
+    return true;
+}
+
+// A null handler stops the idle calls
+void InputSetIdleHandler(InputIdleHandler handler, void* context)
+{
+    input.idleHandler = handler;
+    input.idleContext = handler != nullptr ? context : nullptr;
+}
+
+// Queues every key that has arrived, without waiting
+void InputPoll()
+{
+    InputInit();
+    while (input.keyboard && !input.closed && input.keyCount < INPUT_MAX_KEYS)
+    {
+        int key = TerminalPollKey(0);
+        if (key == TERMINAL_KEY_NONE) return;
+        InputPushKey(key);
+    }
+}
+
+// Oldest unread key, or TERMINAL_KEY_NONE
+int InputTakeKey()
+{
+    InputPoll();
+    return InputPopKey();
+}
+
+// As InputTakeKey, leaving the key in the queue
+int InputPeekKey()
+{
+    InputPoll();
+    return input.keyCount > 0 ? input.keys[input.keyHead] : TERMINAL_KEY_NONE;
+}
+
+// Copies out a finished line and returns true, else returns false at once. Keys typed so far go
+// into the line being edited, with Backspace and echo; Ctrl+D (Ctrl+Z on Windows) on an empty
+// line closes the input.
+bool InputTakeLine(char* buffer, size_t size)
+{
+    if (buffer == nullptr || size == 0)
+    {
+        printf("ERROR - InputTakeLine: buffer is null\n");
+        return false;
+    }
+    InputInit();
+    if (input.script != nullptr) return InputTakeScriptLine(buffer, size);
+    
+    InputPoll();
+    bool isDone = false;
+    while (!isDone && input.keyCount > 0)
+    {
+        int key = InputPopKey();
+        if (key == TERMINAL_KEY_ENTER)
+        {
+            fputs("\n", stdout);
+            isDone = true;
+        }
+        else if (key == TERMINAL_KEY_BACKSPACE)
+        {
+            if (input.lineLength == 0) continue;
+            // Back over the whole UTF-8 character
+            do
+            {
+                input.lineLength--;
+            } while (input.lineLength > 0 && (static_cast<unsigned char>(input.line[input.lineLength]) & 0xC0) == 0x80);
+            fputs("\b \b", stdout);
+        }
+        else if ((key == 0x04 || key == 0x1A) && input.lineLength == 0)
+        {
+            input.closed = true;
+            break;
+        }
+        else if (key >= 0x20 && key != 0x7F && key < TERMINAL_KEY_UP)
+        {
+            char utf8[4];
+            size_t length = InputEncodeUtf8(key, utf8);
+            if (input.lineLength + length >= INPUT_LINE_BYTES) continue;
+            memcpy(input.line + input.lineLength, utf8, length);
+            input.lineLength += length;
+            fwrite(utf8, 1, length, stdout);
+        }
+    }
+    fflush(stdout);
+    if (!isDone) return false;
+    
+    InputCopyLine(buffer, size, input.line, input.lineLength);
+    input.lineLength = 0;
+    return true;
+}
+
+// Waits for a line, running the idle handler every INPUT_IDLE_MS. False once the input is closed.
+bool InputReadLine(char* buffer, size_t size)
+{
+    if (buffer == nullptr || size == 0)
+    {
+        printf("ERROR - InputReadLine: buffer is null\n");
+        return false;
+    }
+    while (!InputIsClosed())
+    {
+        if (InputTakeLine(buffer, size)) return true;
+        if (input.closed || input.script != nullptr) continue;
+        InputWait(INPUT_IDLE_MS);
+    }
+    return false;
+}
+
+// Runs the idle handler, then waits up to waitMs for a key and queues it. Without a keyboard
+// there is nothing to wake it early.
+void InputWait(int waitMs)
+{
+    InputInit();
+    if (input.idleHandler != nullptr) input.idleHandler(input.idleContext);
+    if (waitMs <= 0) return;
+    if (input.keyboard && !input.closed)
+    {
+        InputPushKey(TerminalPollKey(waitMs));
+    }
+    else
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(waitMs));
+    }
+}
+
+bool InputIsClosed()
+{
+    return input.closed;
+}
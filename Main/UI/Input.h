@@ -0,0 +1,44 @@
+﻿#pragma once
+
+#include <cstddef>
+
+//--------------------
+// INPUT CONSTANTS
+//--------------------
+
+#define INPUT_MAX_KEYS 64 // Keys held between polls; more are dropped until the queue is read
+#define INPUT_LINE_BYTES 256 // Longest line, terminator included; the rest of a longer one is dropped
+#define INPUT_IDLE_MS 16 // A wait for input runs the idle handler at least this often
+
+// Runs on the game thread whenever a wait for input has nothing to read
+typedef void (*InputIdleHandler)(void* context);
+
+//--------------------
+// INPUT FUNCTIONS
+//--------------------
+
+//
+// Keyboard input for the interactive game, read without blocking. InputInit keeps the terminal in
+// raw mode, and InputPoll moves whatever keys have arrived into a queue. InputTakeKey and
+// InputTakeLine hand them out and return at once. InputTakeLine edits and echoes the line being
+// typed itself, as raw mode leaves that to the program.
+//
+// InputReadLine is the blocking read the prompts use. It waits in INPUT_IDLE_MS steps and runs the
+// idle handler between them, so the game can get on with other work while the player thinks.
+// InputWait is one such step, for other waits (the scheduler's frames).
+//
+// Lines can come from a script instead, for replays: InputOpenScript plays a file back line by
+// line, echoing each one as if typed, then hands over to the keyboard. When stdin is not a
+// terminal, stdin itself is the script. Once the input runs out, reads return false.
+//
+bool InputInit();
+void InputShutdown();
+bool InputOpenScript(const char* path);
+void InputSetIdleHandler(InputIdleHandler handler, void* context);
+void InputPoll();
+int InputTakeKey();
+int InputPeekKey();
+bool InputTakeLine(char* buffer, size_t size);
+bool InputReadLine(char* buffer, size_t size);
+void InputWait(int waitMs);
+bool InputIsClosed();
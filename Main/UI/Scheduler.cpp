@@ -0,0 +1,167 @@
+﻿#include "Scheduler.h"
+#include "Input.h"
+#include "Terminal.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+#define SCHEDULER_SLOT_BITS 8 // Low bits of an event ID; the rest is the slot's generation
+#define SCHEDULER_GENERATION_MASK 0x7FFFFFu // Keeps IDs positive
+
+typedef struct SchedulerEvent // NOLINT(clang-diagnostic-padded)
+{
+    SchedulerCallback callback; // Null for a plain pause
+    void* context;
+    double due; // Next tick, in seconds on the steady clock
+    double period;
+    unsigned int tick; // Ticks run so far
+    unsigned int ticks;
+    unsigned int flags;
+    unsigned int generation; // Bumped by every add, so an ID from an earlier use of the slot stops matching
+    bool isActive;
+}SchedulerEvent;
+
+typedef struct SchedulerState
+{
+    SchedulerEvent events[SCHEDULER_MAX_EVENTS];
+    float timeScale;
+}SchedulerState;
+
+static SchedulerState scheduler = {{}, 1.0f};
+
+//--------------------
+// SCHEDULER HELPERS
+//--------------------
+
+static double SchedulerNow()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// The event is marked done before its last callback, so the callback can add events of its own
+static void SchedulerRunTick(SchedulerEvent* event)
+{
+    unsigned int tick = event->tick++;
+    if (event->tick >= event->ticks) event->isActive = false;
+    if (event->callback != nullptr) event->callback(event->context, tick);
+}
+
+// Milliseconds to the next tick of any event, at most a frame
+static int SchedulerNextWaitMs()
+{
+    double now = SchedulerNow();
+    double wait = SCHEDULER_FRAME_MS / 1000.0;
+    for (int i = 0; i < SCHEDULER_MAX_EVENTS; i++)
+    {
+        const SchedulerEvent* event = &scheduler.events[i];
+        if (event->isActive && event->due - now < wait) wait = event->due - now;
+    }
+    return wait > 0.0 ? static_cast<int>(ceil(wait * 1000.0)) : 0;
+}
+
+// The event an ID names, or null once it finished or its slot went to another event
+static SchedulerEvent* SchedulerFind(int id)
+{
+    if (id < 0) return nullptr;
+    int slot = id & ((1 << SCHEDULER_SLOT_BITS) - 1);
+    if (slot >= SCHEDULER_MAX_EVENTS) return nullptr;
+    SchedulerEvent* event = &scheduler.events[slot];
+    if (!event->isActive || event->generation != (unsigned int)id >> SCHEDULER_SLOT_BITS) return nullptr;
+    return event;
+}
+
+static bool SchedulerTakeSkipKey()
+{
+    int key = InputPeekKey();
+    if (key == TERMINAL_KEY_NONE) return false;
+    if (key == TERMINAL_KEY_ENTER || key == ' ' || key == TERMINAL_KEY_ESCAPE) InputTakeKey();
+    return true;
+}
+
+//--------------------
+// SCHEDULER FUNCTIONS
+//--------------------
+
+// Runs the callback every delayMs, ticks times (at least once). Returns the event's ID, or -1 when
+// every slot is in use. Once the event finishes its ID is never pending again, even after the slot
+// is reused.
+int SchedulerAdd(unsigned int delayMs, unsigned int ticks, SchedulerCallback callback, void* context, unsigned int flags)
+{
+    for (int i = 0; i < SCHEDULER_MAX_EVENTS; i++)
+    {
+        SchedulerEvent* event = &scheduler.events[i];
+        if (event->isActive) continue;
+        
+        event->callback = callback;
+        event->context = context;
+        event->period = delayMs * static_cast<double>(scheduler.timeScale) / 1000.0;
+        event->due = SchedulerNow() + event->period;
+        event->tick = 0;
+        event->ticks = ticks > 0 ? ticks : 1;
+        event->flags = flags;
+        event->generation = (event->generation + 1) & SCHEDULER_GENERATION_MASK;
+        event->isActive = true;
+        return (int)(event->generation << SCHEDULER_SLOT_BITS) | i;
+    }
+    printf("ERROR - SchedulerAdd: all %d events are in use\n", SCHEDULER_MAX_EVENTS);
+    return -1;
+}
+
+bool SchedulerIsPending(int id)
+{
+    return SchedulerFind(id) != nullptr;
+}
+
+// Runs the event's remaining ticks now
+void SchedulerFinish(int id)
+{
+    SchedulerEvent* event;
+    while ((event = SchedulerFind(id)) != nullptr)
+    {
+        SchedulerRunTick(event);
+    }
+}
+
+// Runs every tick that has come due, without waiting
+void SchedulerUpdate()
+{
+    double now = SchedulerNow();
+    for (int i = 0; i < SCHEDULER_MAX_EVENTS; i++)
+    {
+        SchedulerEvent* event = &scheduler.events[i];
+        while (event->isActive && event->due <= now)
+        {
+            event->due += event->period;
+            SchedulerRunTick(event);
+        }
+    }
+}
+
+// Runs frames until the event finishes. True when a key press cut it short.
+bool SchedulerWait(int id)
+{
+    while (SchedulerIsPending(id))
+    {
+        SchedulerUpdate();
+        const SchedulerEvent* event = SchedulerFind(id);
+        if (event == nullptr) break;
+        if ((event->flags & SCHEDULER_SKIPPABLE) != 0 && SchedulerTakeSkipKey())
+        {
+            SchedulerFinish(id);
+            return true;
+        }
+        InputWait(SchedulerNextWaitMs());
+    }
+    return false;
+}
+
+// Negative scales count as 0
+void SchedulerSetTimeScale(float scale)
+{
+    scheduler.timeScale = scale > 0.0f ? scale : 0.0f;
+}
+
+float SchedulerGetTimeScale()
+{
+    return scheduler.timeScale;
+}
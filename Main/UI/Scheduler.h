@@ -0,0 +1,34 @@
+﻿#pragma once
+
+//--------------------
+// SCHEDULER CONSTANTS
+//--------------------
+
+#define SCHEDULER_MAX_EVENTS 16 // NOLINT(modernize-macro-to-enum)
+#define SCHEDULER_FRAME_MS 16 // Longest a wait goes between frames, about 60 a second
+#define SCHEDULER_SKIPPABLE 0x01 // Flag: a key press finishes the event at once
+
+// Runs when an event comes due; tick counts up from 0 over the event's ticks
+typedef void (*SchedulerCallback)(void* context, unsigned int tick);
+
+//--------------------
+// SCHEDULER FUNCTIONS
+//--------------------
+
+//
+// Timed events for the interactive game, run cooperatively on the game thread. Events only run in
+// SchedulerUpdate. SchedulerWait calls it once a frame while it waits for one event to finish,
+// polling input and running the input idle handler in between, so a pause never freezes the game.
+// A skippable event is finished, its remaining ticks run at once, as soon as a key is waiting.
+// Enter, Space and Escape are used up by the skip; other keys stay queued for the next prompt.
+//
+// Delays are multiplied by the time scale when an event is added: 1 is real time, 0 runs every
+// event on the spot, for scripted runs and speedruns.
+//
+int SchedulerAdd(unsigned int delayMs, unsigned int ticks, SchedulerCallback callback, void* context, unsigned int flags);
+bool SchedulerIsPending(int id);
+void SchedulerFinish(int id);
+void SchedulerUpdate();
+bool SchedulerWait(int id);
+void SchedulerSetTimeScale(float scale);
+float SchedulerGetTimeScale();
@@ -0,0 +1,408 @@
+﻿#include "Terminal.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <csignal>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+typedef struct TerminalState
+{
+    bool initialized;
+    bool isTerminal; // stdout is a console or tty
+    bool hasEscapes;
+    bool hasColor;
+    bool rawMode;
+#ifdef _WIN32
+    HANDLE input;
+    HANDLE output;
+    DWORD inputMode; // Console modes from before TerminalSetRawMode and TerminalInit changed them
+    DWORD outputMode;
+    bool inputModeSaved;
+    bool outputModeSaved;
+#else
+    struct termios cooked; // stdin settings from before the first raw read
+    bool cookedSaved;
+#endif
+}TerminalState;
+
+static TerminalState terminal;
+
+//--------------------
+// WIN32 CONSOLE
+//--------------------
+
+#ifdef _WIN32
+
+// Set and not empty, as NO_COLOR asks
+static bool TerminalEnvSet(const char* name)
+{
+    return GetEnvironmentVariableA(name, nullptr, 0) > 1;
+}
+
+static bool TerminalPlatformInit()
+{
+    SetConsoleCP(CP_UTF8);
+    SetConsoleOutputCP(CP_UTF8);
+    terminal.input = GetStdHandle(STD_INPUT_HANDLE);
+    terminal.output = GetStdHandle(STD_OUTPUT_HANDLE);
+    
+    DWORD mode = 0;
+    if (terminal.output == INVALID_HANDLE_VALUE || !GetConsoleMode(terminal.output, &mode)) return false;
+    terminal.outputMode = mode;
+    terminal.outputModeSaved = true;
+    // Consoles older than Windows 10 refuse escape sequences; clearing then goes through the console API
+    terminal.hasEscapes = (mode & ENABLE_VIRTUAL_TERMINAL_PROCESSING) != 0
+        || SetConsoleMode(terminal.output, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+    terminal.hasColor = terminal.hasEscapes;
+    return true;
+}
+
+static void TerminalPlatformRestore()
+{
+    if (terminal.outputModeSaved) SetConsoleMode(terminal.output, terminal.outputMode);
+}
+
+static bool TerminalPlatformGetSize(short* rows, short* cols)
+{
+    CONSOLE_SCREEN_BUFFER_INFO info;
+    if (!GetConsoleScreenBufferInfo(terminal.output, &info)) return false;
+    *rows = static_cast<short>(info.srWindow.Bottom - info.srWindow.Top + 1);
+    *cols = static_cast<short>(info.srWindow.Right - info.srWindow.Left + 1);
+    return true;
+}
+
+static void TerminalPlatformClear()
+{
+    fflush(stdout);
+    CONSOLE_SCREEN_BUFFER_INFO info;
+    if (!GetConsoleScreenBufferInfo(terminal.output, &info)) return;
+    DWORD cells = static_cast<DWORD>(info.dwSize.X) * static_cast<DWORD>(info.dwSize.Y);
+    DWORD written = 0;
+    COORD home = {0, 0};
+    FillConsoleOutputCharacterA(terminal.output, ' ', cells, home, &written);
+    FillConsoleOutputAttribute(terminal.output, info.wAttributes, cells, home, &written);
+    SetConsoleCursorPosition(terminal.output, home);
+}
+
+// Raw mode keeps processed input, so Ctrl+C still stops the game
+static bool TerminalPlatformSetRawMode(bool enabled)
+{
+    if (!enabled)
+    {
+        return !terminal.inputModeSaved || SetConsoleMode(terminal.input, terminal.inputMode);
+    }
+    DWORD mode = 0;
+    if (terminal.input == INVALID_HANDLE_VALUE || !GetConsoleMode(terminal.input, &mode)) return false;
+    terminal.inputMode = mode;
+    terminal.inputModeSaved = true;
+    return SetConsoleMode(terminal.input, mode & ~(ENABLE_LINE_INPUT | ENABLE_ECHO_INPUT)) != 0;
+}
+
+// The key a console input record carries, or TERMINAL_KEY_NONE for key releases, keys with no
+// character (Shift, Ctrl and the like), mouse and focus events, and the first half of a surrogate pair
+static int TerminalKeyFromRecord(const INPUT_RECORD* record, unsigned int* highSurrogate)
+{
+    if (record->EventType != KEY_EVENT || !record->Event.KeyEvent.bKeyDown) return TERMINAL_KEY_NONE;
+    
+    WORD virtualKey = record->Event.KeyEvent.wVirtualKeyCode;
+    if (virtualKey == VK_UP) return TERMINAL_KEY_UP;
+    if (virtualKey == VK_DOWN) return TERMINAL_KEY_DOWN;
+    if (virtualKey == VK_RIGHT) return TERMINAL_KEY_RIGHT;
+    if (virtualKey == VK_LEFT) return TERMINAL_KEY_LEFT;
+    if (virtualKey == VK_RETURN) return TERMINAL_KEY_ENTER;
+    if (virtualKey == VK_BACK) return TERMINAL_KEY_BACKSPACE;
+    if (virtualKey == VK_ESCAPE) return TERMINAL_KEY_ESCAPE;
+    
+    unsigned int unit = record->Event.KeyEvent.uChar.UnicodeChar;
+    if (unit == 0) return TERMINAL_KEY_NONE;
+    if (unit >= 0xD800 && unit <= 0xDBFF)
+    {
+        *highSurrogate = unit;
+        return TERMINAL_KEY_NONE;
+    }
+    if (unit >= 0xDC00 && unit <= 0xDFFF && *highSurrogate != 0)
+    {
+        return static_cast<int>(0x10000 + ((*highSurrogate - 0xD800) << 10) + (unit - 0xDC00));
+    }
+    return static_cast<int>(unit);
+}
+
+static int TerminalPlatformReadKey()
+{
+    unsigned int highSurrogate = 0;
+    INPUT_RECORD record;
+    DWORD count = 0;
+    while (ReadConsoleInputW(terminal.input, &record, 1, &count) && count == 1)
+    {
+        int key = TerminalKeyFromRecord(&record, &highSurrogate);
+        if (key != TERMINAL_KEY_NONE) return key;
+    }
+    return TERMINAL_KEY_EOF;
+}
+
+static int TerminalPlatformPollKey(int waitMs)
+{
+    unsigned int highSurrogate = 0;
+    ULONGLONG deadline = GetTickCount64() + static_cast<ULONGLONG>(waitMs);
+    while (true)
+    {
+        ULONGLONG now = GetTickCount64();
+        DWORD wait = now < deadline ? static_cast<DWORD>(deadline - now) : 0;
+        if (WaitForSingleObject(terminal.input, wait) != WAIT_OBJECT_0) return TERMINAL_KEY_NONE;
+        
+        INPUT_RECORD record;
+        DWORD count = 0;
+        if (!ReadConsoleInputW(terminal.input, &record, 1, &count) || count != 1) return TERMINAL_KEY_EOF;
+        int key = TerminalKeyFromRecord(&record, &highSurrogate);
+        if (key != TERMINAL_KEY_NONE) return key;
+    }
+}
+
+#else
+
+//--------------------
+// POSIX TERMINAL
+//--------------------
+
+// Set and not empty, as NO_COLOR asks
+static bool TerminalEnvSet(const char* name)
+{
+    const char* value = getenv(name);
+    return value != nullptr && value[0] != '\0';
+}
+
+static bool TerminalPlatformInit()
+{
+    if (!isatty(STDOUT_FILENO)) return false;
+    const char* term = getenv("TERM");
+    terminal.hasEscapes = term == nullptr || strcmp(term, "dumb") != 0;
+    terminal.hasColor = terminal.hasEscapes && term != nullptr;
+    return true;
+}
+
+static void TerminalPlatformRestore()
+{
+}
+
+static bool TerminalPlatformGetSize(short* rows, short* cols)
+{
+    struct winsize size;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) != 0 || size.ws_row == 0) return false;
+    *rows = static_cast<short>(size.ws_row);
+    *cols = static_cast<short>(size.ws_col);
+    return true;
+}
+
+// A terminal that cannot clear gets a blank line between screens
+static void TerminalPlatformClear()
+{
+    fputs("\n", stdout);
+}
+
+// Ctrl+C and the like end the process without running atexit, so raw mode is undone here first
+static void TerminalOnSignal(int signalNumber)
+{
+    tcsetattr(STDIN_FILENO, TCSANOW, &terminal.cooked);
+    signal(signalNumber, SIG_DFL);
+    raise(signalNumber);
+}
+
+// Signals stay on, so Ctrl+C still stops the game
+static bool TerminalPlatformSetRawMode(bool enabled)
+{
+    if (!enabled)
+    {
+        return !terminal.cookedSaved || tcsetattr(STDIN_FILENO, TCSANOW, &terminal.cooked) == 0;
+    }
+    if (!isatty(STDIN_FILENO)) return false;
+    if (!terminal.cookedSaved)
+    {
+        if (tcgetattr(STDIN_FILENO, &terminal.cooked) != 0) return false;
+        terminal.cookedSaved = true;
+        signal(SIGINT, TerminalOnSignal);
+        signal(SIGTERM, TerminalOnSignal);
+        signal(SIGHUP, TerminalOnSignal);
+    }
+    struct termios raw = terminal.cooked;
+    raw.c_lflag &= ~(ICANON | ECHO | IEXTEN);
+    raw.c_cc[VMIN] = 1;
+    raw.c_cc[VTIME] = 0;
+    return tcsetattr(STDIN_FILENO, TCSANOW, &raw) == 0;
+}
+
+// One byte of input, or -1 at end of input or once waitMs passes; a negative wait blocks
+static int TerminalReadByte(int waitMs)
+{
+    if (waitMs >= 0)
+    {
+        struct pollfd input = {STDIN_FILENO, POLLIN, 0};
+        if (poll(&input, 1, waitMs) <= 0) return -1;
+    }
+    unsigned char byte = 0;
+    ssize_t count;
+    do
+    {
+        count = read(STDIN_FILENO, &byte, 1);
+    } while (count < 0 && errno == EINTR);
+    return count == 1 ? byte : -1;
+}
+
+static int TerminalPlatformReadKey()
+{
+    int byte = TerminalReadByte(-1);
+    if (byte < 0) return TERMINAL_KEY_EOF;
+    if (byte == '\r' || byte == '\n') return TERMINAL_KEY_ENTER;
+    if (byte == 0x7F || byte == 0x08) return TERMINAL_KEY_BACKSPACE;
+    
+    // Arrow keys arrive as ESC [ A or ESC O A. Other sequences (Delete is ESC [ 3 ~) are read to
+    // their end and come back as a plain ESC, as does anything typed within the wait after one.
+    if (byte == 0x1B)
+    {
+        int next = TerminalReadByte(TERMINAL_ESCAPE_WAIT_MS);
+        if (next != '[' && next != 'O') return TERMINAL_KEY_ESCAPE;
+        int final = TerminalReadByte(TERMINAL_ESCAPE_WAIT_MS);
+        while (final >= 0x20 && final < 0x40) final = TerminalReadByte(TERMINAL_ESCAPE_WAIT_MS);
+        if (final == 'A') return TERMINAL_KEY_UP;
+        if (final == 'B') return TERMINAL_KEY_DOWN;
+        if (final == 'C') return TERMINAL_KEY_RIGHT;
+        if (final == 'D') return TERMINAL_KEY_LEFT;
+        return TERMINAL_KEY_ESCAPE;
+    }
+    
+    // The rest of a UTF-8 character is already waiting once its first byte has arrived
+    if (byte >= 0xC0)
+    {
+        int extra = byte >= 0xF0 ? 3 : byte >= 0xE0 ? 2 : 1;
+        int codePoint = byte & (0x3F >> extra);
+        for (int i = 0; i < extra; i++)
+        {
+            int continuation = TerminalReadByte(TERMINAL_ESCAPE_WAIT_MS);
+            if (continuation < 0 || (continuation & 0xC0) != 0x80) break;
+            codePoint = (codePoint << 6) | (continuation & 0x3F);
+        }
+        return codePoint;
+    }
+    return byte;
+}
+
+static int TerminalPlatformPollKey(int waitMs)
+{
+    struct pollfd input = {STDIN_FILENO, POLLIN, 0};
+    if (poll(&input, 1, waitMs) <= 0) return TERMINAL_KEY_NONE;
+    return TerminalPlatformReadKey();
+}
+
+#endif
+
+//--------------------
+// TERMINAL FUNCTIONS
+//--------------------
+
+// Safe to call more than once, and the queries below call it if nothing has. True when stdout is a terminal.
+bool TerminalInit()
+{
+    if (!terminal.initialized)
+    {
+        terminal.initialized = true;
+        terminal.hasEscapes = true; // Redirected output keeps its escape sequences, as it always has
+        terminal.hasColor = false;
+        terminal.isTerminal = TerminalPlatformInit();
+        if (TerminalEnvSet("NO_COLOR")) terminal.hasColor = false;
+        atexit(TerminalRestore);
+    }
+    return terminal.isTerminal;
+}
+
+void TerminalRestore()
+{
+    TerminalSetRawMode(false);
+    TerminalPlatformRestore();
+}
+
+// Clearing and cursor movement work with escape sequences
+bool TerminalHasEscapes()
+{
+    if (!terminal.initialized) TerminalInit();
+    return terminal.hasEscapes;
+}
+
+// False for redirected output, a dumb terminal or NO_COLOR
+bool TerminalHasColor()
+{
+    if (!terminal.initialized) TerminalInit();
+    return terminal.hasColor;
+}
+
+// Visible rows and columns; false when stdout is not a terminal
+bool TerminalGetSize(short* rows, short* cols)
+{
+    if (rows == nullptr || cols == nullptr)
+    {
+        printf("ERROR - TerminalGetSize: output is null\n");
+        return false;
+    }
+    return TerminalPlatformGetSize(rows, cols);
+}
+
+void TerminalClear()
+{
+    if (TerminalHasEscapes())
+    {
+        fputs(TERMINAL_CLEAR_SEQUENCE, stdout);
+        return;
+    }
+    TerminalPlatformClear();
+}
+
+// Writes the sequence moving the cursor to a zero-based row and column, or along the current row
+// when row is negative, and returns its length
+int TerminalFormatCursor(char* buffer, size_t size, short row, short col)
+{
+    int length = row < 0
+        ? snprintf(buffer, size, "\x1b[%dG", col + 1)
+        : snprintf(buffer, size, "\x1b[%d;%dH", row + 1, col + 1);
+    return length > 0 && static_cast<size_t>(length) < size ? length : 0;
+}
+
+// False when stdin is not a terminal
+bool TerminalSetRawMode(bool enabled)
+{
+    if (enabled == terminal.rawMode) return true;
+    if (!TerminalPlatformSetRawMode(enabled)) return false;
+    terminal.rawMode = enabled;
+    return true;
+}
+
+// Waits at most waitMs for a key; TERMINAL_KEY_NONE when none came. Needs raw mode, as a key
+// only arrives with its line otherwise.
+int TerminalPollKey(int waitMs)
+{
+    if (!terminal.rawMode)
+    {
+        printf("ERROR - TerminalPollKey: not in raw mode\n");
+        return TERMINAL_KEY_NONE;
+    }
+    return TerminalPlatformPollKey(waitMs < 0 ? 0 : waitMs);
+}
+
+int TerminalReadKey()
+{
+    bool wasRaw = terminal.rawMode;
+    if (!TerminalSetRawMode(true))
+    {
+        int byte = getchar();
+        if (byte == EOF) return TERMINAL_KEY_EOF;
+        return byte == '\r' ? TERMINAL_KEY_ENTER : byte;
+    }
+    int key = TerminalPlatformReadKey();
+    if (!wasRaw) TerminalSetRawMode(false);
+    return key;
+}
@@ -0,0 +1,51 @@
+﻿#pragma once
+
+#include <cstddef>
+
+//--------------------
+// TERMINAL CONSTANTS
+//--------------------
+
+#define TERMINAL_CLEAR_SEQUENCE "\x1b[r\x1b[2J\x1b[3J\x1b[H" // Scroll margins, screen, scrollback, cursor home
+#define TERMINAL_ESCAPE_WAIT_MS 30 // How long a lone ESC waits for the rest of an arrow key sequence
+
+// TerminalReadKey results: a character as its code point, or one of these. The special keys sit
+// past the last code point so no character can be mistaken for one.
+#define TERMINAL_KEY_EOF (-1) // Input closed
+#define TERMINAL_KEY_NONE (-2) // Nothing pressed within a poll's wait
+#define TERMINAL_KEY_BACKSPACE 8 // NOLINT(modernize-macro-to-enum)
+#define TERMINAL_KEY_ENTER 10 // Enter and Return both read as a newline
+#define TERMINAL_KEY_ESCAPE 27 // NOLINT(modernize-macro-to-enum)
+#define TERMINAL_KEY_UP 0x110000 // NOLINT(modernize-macro-to-enum)
+#define TERMINAL_KEY_DOWN 0x110001 // NOLINT(modernize-macro-to-enum)
+#define TERMINAL_KEY_RIGHT 0x110002 // NOLINT(modernize-macro-to-enum)
+#define TERMINAL_KEY_LEFT 0x110003 // NOLINT(modernize-macro-to-enum)
+
+//--------------------
+// TERMINAL FUNCTIONS
+//--------------------
+
+//
+// The console, in-process, on the Win32 console and on POSIX termios. TerminalInit switches the
+// Windows console to UTF-8 and escape sequences and works out what the terminal can show; call it
+// before printing anything. TerminalRestore puts back the modes it changed and runs at exit.
+//
+// TerminalClear and TerminalFormatCursor go through stdout, so they land in the frame being
+// composed. On a Windows console without escape sequences TerminalClear flushes and clears
+// through the console API instead.
+//
+// TerminalReadKey waits for one key press without echo or line editing, switching to raw mode
+// for the read unless TerminalSetRawMode has already done so. When stdin is not a terminal it
+// reads a byte at a time through stdio. TerminalPollKey is the same read with a time limit, for
+// callers that keep raw mode on and have other work to do between keys.
+//
+bool TerminalInit();
+void TerminalRestore();
+bool TerminalHasEscapes();
+bool TerminalHasColor();
+bool TerminalGetSize(short* rows, short* cols);
+void TerminalClear();
+int TerminalFormatCursor(char* buffer, size_t size, short row, short col);
+bool TerminalSetRawMode(bool enabled);
+int TerminalPollKey(int waitMs);
+int TerminalReadKey();
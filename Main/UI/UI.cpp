@@ -1,11 +1,250 @@
 ﻿#include "UI.h"
+#include "Input.h"
+#include "Scheduler.h"
+#include "Terminal.h"
+#include <cstdarg>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
-#include <windows.h>
+#include <io.h>
+
+thread_local bool UI::headless = false;
+thread_local UI_InputPolicy UI::inputPolicy = nullptr;
+thread_local void* UI::inputContext = nullptr;
+int UI::savedStdout = -1;
+char UI::frameBuffer[UI_FRAME_BYTES];
+
+static const char barFill[] = "====================";
+static const char barEmpty[] = "--------------------";
+static const char sectionRule[] = "-----------------------------------";
+
+// The retained screen: the one the terminal shows, the one being composed, and the output of a present
+typedef struct UIScreenState
+{
+    UIScreen screens[2];
+    short front; // Index of the screen on the terminal
+    bool composing;
+    bool isShown; // The front screen is on the terminal with the scroll region below it
+    short shownTerminalRows; // Terminal height when the scroll region was set
+    short terminalRows; // From UI_ScreenSetTerminalRows, 0 to ask the console
+    short row; // Where composing text goes next
+    short col;
+    unsigned char attr;
+    short cursorRow; // Where the terminal cursor is while presenting, -1 unknown
+    short cursorCol;
+    unsigned char cursorAttr;
+    size_t outputUsed;
+    char output[UI_FRAME_BYTES];
+}UIScreenState;
+
+static UIScreenState uiScreen;
+
+//--------------------
+// RETAINED SCREEN HELPERS
+//--------------------
+
+static short UI_ScreenTerminalRows()
+{
+    if (uiScreen.terminalRows > 0) return uiScreen.terminalRows;
+    short rows = 0, cols = 0;
+    if (!TerminalHasEscapes() || !TerminalGetSize(&rows, &cols)) return 0;
+    return rows;
+}
+
+static void UI_ScreenOut(const char* data, size_t size)
+{
+    if (uiScreen.outputUsed + size > sizeof(uiScreen.output))
+    {
+        fwrite(uiScreen.output, 1, uiScreen.outputUsed, stdout);
+        uiScreen.outputUsed = 0;
+    }
+    memcpy(uiScreen.output + uiScreen.outputUsed, data, size);
+    uiScreen.outputUsed += size;
+}
+
+static void UI_ScreenOutText(const char* text)
+{
+    UI_ScreenOut(text, strlen(text));
+}
+
+static void UI_ScreenMoveTo(short row, short col)
+{
+    char sequence[32];
+    int length = TerminalFormatCursor(sequence, sizeof(sequence), row == uiScreen.cursorRow ? -1 : row, col);
+    UI_ScreenOut(sequence, static_cast<size_t>(length));
+    uiScreen.cursorRow = row;
+    uiScreen.cursorCol = col;
+}
+
+static void UI_ScreenSetAttr(unsigned char attr)
+{
+    if (attr == uiScreen.cursorAttr || !TerminalHasColor()) return;
+    char sequence[16];
+    int length = sprintf_s(sequence, sizeof(sequence), "\x1b[0%s", (attr & UI_CELL_BOLD) != 0 ? ";1" : "");
+    if ((attr & 0x0F) != 0)
+    {
+        length += sprintf_s(sequence + length, sizeof(sequence) - length, ";%d", 29 + (attr & 0x0F));
+    }
+    sequence[length++] = 'm';
+    UI_ScreenOut(sequence, static_cast<size_t>(length));
+    uiScreen.cursorAttr = attr;
+}
+
+// Blank cells go out as spaces in whatever color is current
+static void UI_ScreenPutCell(const UICell* cell)
+{
+    if (cell->length == 0)
+    {
+        UI_ScreenOut(" ", 1);
+    }
+    else
+    {
+        UI_ScreenSetAttr(cell->attr);
+        UI_ScreenOut(cell->glyph, cell->length);
+    }
+    uiScreen.cursorCol++;
+}
+
+// SGR parameters: reset, bold and the eight foreground colors are kept, the rest ignored
+static void UI_ScreenApplySgr(const char* params, const char* end)
+{
+    int value = 0;
+    for (const char* p = params; ; p++)
+    {
+        if (p < end && *p >= '0' && *p <= '9')
+        {
+            value = value * 10 + (*p - '0');
+            continue;
+        }
+        if (value == 0) uiScreen.attr = 0;
+        else if (value == 1) uiScreen.attr |= UI_CELL_BOLD;
+        else if (value == 22) uiScreen.attr &= ~UI_CELL_BOLD;
+        else if (value >= 30 && value <= 37) uiScreen.attr = static_cast<unsigned char>((uiScreen.attr & ~0x0F) | (value - 29));
+        else if (value == 39) uiScreen.attr &= ~0x0F;
+        value = 0;
+        if (p >= end) break;
+    }
+}
+
+static void UI_ScreenWrite(const char* text)
+{
+    UIScreen* screen = &uiScreen.screens[uiScreen.front ^ 1];
+    const char* p = text;
+    while (*p != '\0')
+    {
+        unsigned char c = static_cast<unsigned char>(*p);
+        if (c == 0x1b && p[1] == '[')
+        {
+            const char* end = p + 2;
+            while (*end != '\0' && (*end < 0x40 || *end > 0x7E)) end++;
+            if (*end == 'm') UI_ScreenApplySgr(p + 2, end);
+            p = *end != '\0' ? end + 1 : end;
+            continue;
+        }
+        if (c == '\n')
+        {
+            uiScreen.row++;
+            uiScreen.col = 0;
+            if (uiScreen.row <= UI_SCREEN_ROWS && screen->rows < uiScreen.row) screen->rows = uiScreen.row;
+            p++;
+            continue;
+        }
+        if (c < 0x20)
+        {
+            if (c == '\r') uiScreen.col = 0;
+            p++;
+            continue;
+        }
+        
+        short length = 1;
+        if (c >= 0xC0)
+        {
+            while (length < 4 && (static_cast<unsigned char>(p[length]) & 0xC0) == 0x80) length++;
+        }
+        if (uiScreen.row < UI_SCREEN_ROWS && uiScreen.col < UI_SCREEN_COLS)
+        {
+            UICell* cell = &screen->cells[uiScreen.row][uiScreen.col];
+            memset(cell, 0, sizeof(UICell));
+            if (c != ' ')
+            {
+                memcpy(cell->glyph, p, length);
+                cell->length = static_cast<unsigned char>(length);
+                cell->attr = uiScreen.attr;
+            }
+            if (screen->widths[uiScreen.row] <= uiScreen.col) screen->widths[uiScreen.row] = static_cast<short>(uiScreen.col + 1);
+            if (screen->rows <= uiScreen.row) screen->rows = static_cast<short>(uiScreen.row + 1);
+        }
+        uiScreen.col++;
+        p += length;
+    }
+}
+
+// Clears the terminal and writes the whole screen. The clear goes out first, before any of the output.
+static void UI_ScreenRedraw(const UIScreen* screen)
+{
+    TerminalClear();
+    uiScreen.cursorAttr = 0;
+    for (short row = 0; row < screen->rows; row++)
+    {
+        for (short col = 0; col < screen->widths[row]; col++)
+        {
+            UI_ScreenPutCell(&screen->cells[row][col]);
+        }
+        UI_ScreenOut("\n", 1);
+    }
+}
+
+// Rewrites only the cells that differ from the screen on the terminal
+static void UI_ScreenDiff(const UIScreen* shown, const UIScreen* screen)
+{
+    uiScreen.cursorRow = -1;
+    for (short row = 0; row < screen->rows; row++)
+    {
+        const UICell* cells = screen->cells[row];
+        for (short col = 0; col < screen->widths[row]; col++)
+        {
+            if (memcmp(&cells[col], &shown->cells[row][col], sizeof(UICell)) == 0) continue;
+            
+            bool isNear = uiScreen.cursorRow == row && col >= uiScreen.cursorCol && col - uiScreen.cursorCol <= UI_SCREEN_MAX_SKIP;
+            if (isNear)
+            {
+                while (uiScreen.cursorCol < col) UI_ScreenPutCell(&cells[uiScreen.cursorCol]);
+            }
+            else
+            {
+                UI_ScreenMoveTo(row, col);
+            }
+            UI_ScreenPutCell(&cells[col]);
+        }
+        if (shown->widths[row] > screen->widths[row])
+        {
+            UI_ScreenMoveTo(row, screen->widths[row]);
+            UI_ScreenOutText("\x1b[K");
+        }
+    }
+}
 
 //--------------------
 // PRINT FUNCTIONS
 //--------------------
+
+// printf that lands in the retained screen while one is being composed
+void UI::UI_Printf(const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    if (uiScreen.composing)
+    {
+        char text[UI_PRINTF_BYTES];
+        vsnprintf(text, sizeof(text), format, args);
+        UI_ScreenWrite(text);
+    }
+    else
+    {
+        vprintf(format, args);
+    }
+    va_end(args);
+}
 void UI::UI_PrintHeader(const char* title)
 {
     unsigned short len = static_cast<unsigned short>(strlen(title));
@@ -13,50 +252,46 @@ void UI::UI_PrintHeader(const char* title)
     unsigned short leftPadding = (totalSpace - len) / 2;
     unsigned short rightPadding = (totalSpace - len) - leftPadding;
     
-    printf("+======================================+\n");
-    printf("|");
-    for (unsigned short i = 0; i < leftPadding; i++) printf(" ");
-    printf("%s", title);
-    for (unsigned short i = 0; i < rightPadding; i++) printf(" ");
-    printf("|\n");
-    printf("+======================================+\n");
-    
+    UI_Printf("+======================================+\n"
+           "|%*s%s%*s|\n"
+           "+======================================+\n", leftPadding, "", title, rightPadding, "");
 }
 
 void UI::UI_PrintDivider()
 {
-    printf("+======================================+\n");
+    UI_Printf("+======================================+\n");
 }
 
 void UI::UI_PrintSection(const char* name)
 {
-    printf("\n--- %s ", name);
+    UI_Printf("\n--- %s ", name);
     
     unsigned short nameLen = static_cast<unsigned short>(strlen(name));
     unsigned short totalWidth = 35;
     
     if (nameLen >= totalWidth - 4)
     {
-        printf("---\n");
+        UI_Printf("---\n");
         return;
     }
     
-    unsigned short remaining = totalWidth - nameLen - 4;
-    
-    for (unsigned short i = 0; i < remaining; i++) 
-        printf("-");
-    
-    printf("\n");
+    int remaining = totalWidth - nameLen - 4;
+    UI_Printf("%.*s\n", remaining, sectionRule);
 }
 
 void UI::UI_PrintColored(const char* text, const char* color, bool newLine)
 {
+    if (!TerminalHasColor())
+    {
+        UI_Printf(newLine ? "%s\n" : "%s", text);
+        return;
+    }
     if (newLine)
     {
-        printf("%s%s%s\n", color, text, RESET);
+        UI_Printf("%s%s%s\n", color, text, RESET);
     }else
     {
-        printf("%s%s%s", color, text, RESET);
+        UI_Printf("%s%s%s", color, text, RESET);
     }
 }
 
@@ -69,12 +304,54 @@ void UI::UI_PrintCentered(const char* text)
     
     if (textLen >= totalWidth)
     {
-        printf("%s\n", text);
+        UI_Printf("%s\n", text);
         return;
     }
     
     unsigned short padding = (totalWidth - textLen) / 2;
-    printf("%*s%s\n", padding, "", text);
+    UI_Printf("%*s%s\n", padding, "", text);
+}
+
+// Starts the next frame; nothing reaches the console until it is presented
+void UI::UI_ClearScreen()
+{
+    if (headless) return;
+    uiScreen.isShown = false;
+    TerminalClear();
+}
+
+//--------------------
+// INPUT HELPERS
+//--------------------
+
+// The player's next line. With the input gone there is no one left to answer, so the game ends.
+static void UI_ReadLine(char* buffer, size_t size)
+{
+    UI::UI_PresentFrame();
+    if (!InputReadLine(buffer, size))
+    {
+        printf("\nInput closed\nExiting..\n");
+        UI::UI_PresentFrame();
+        exit(0);
+    }
+}
+
+// Blank lines are passed over, as scanf did
+static void UI_ReadAnswer(char* buffer, size_t size)
+{
+    do
+    {
+        UI_ReadLine(buffer, size);
+    } while (buffer[strspn(buffer, " \t")] == '\0');
+}
+
+static bool UI_ParseShort(const char* text, short* value)
+{
+    char* end = nullptr;
+    long parsed = strtol(text, &end, 10);
+    if (end == text || parsed < -32768 || parsed > 32767) return false;
+    *value = static_cast<short>(parsed);
+    return true;
 }
 
 //--------------------
@@ -83,20 +360,28 @@ void UI::UI_PrintCentered(const char* text)
 
 unsigned short UI::UI_GetMenuInput(short int minChoice, short int maxChoice)
 {
-    unsigned short choice = 0;
+    if (headless)
+    {
+        short choice = inputPolicy(inputContext, INPUT_MENU, minChoice, maxChoice);
+        if (choice < minChoice) choice = minChoice;
+        if (choice > maxChoice) choice = maxChoice;
+        return static_cast<unsigned short>(choice);
+    }
+    
+    char line[INPUT_LINE_BYTES];
+    short choice = 0;
     while (true)
     {
         printf("> ");
-        if (scanf_s("%hd", &choice) != 1)
+        UI_ReadAnswer(line, sizeof(line));
+        if (!UI_ParseShort(line, &choice))
         {
-            while (getchar() != '\n') {}
             printf("Invalid Input. Try Again: ");
             continue;
         }
         if (choice >= minChoice && choice <= maxChoice)
         {
-            while (getchar() != '\n') {}
-            return choice;
+            return static_cast<unsigned short>(choice);
         }
         printf("Invalid Choice! Enter in range %d - %d: ", minChoice, maxChoice);
     }
@@ -104,28 +389,73 @@ unsigned short UI::UI_GetMenuInput(short int minChoice, short int maxChoice)
 
 char UI::UI_GetCharInput()
 {
-    char input;
-    scanf_s("%c", &input, 1); // NOLINT(cert-err33-c)
-    while (getchar() != '\n') {}
-    return input;
+    if (headless)
+    {
+        return static_cast<char>(inputPolicy(inputContext, INPUT_CHAR, 0, 127));
+    }
+    
+    char line[INPUT_LINE_BYTES];
+    UI_ReadLine(line, sizeof(line));
+    return line[0] != '\0' ? line[0] : '\n';
 }
 
 void UI::UI_GetStringInput(const char* prompt, char* buffer, int maxLength)
 {
     printf("%s", prompt);
-    scanf_s("%49s", buffer, maxLength);  // NOLINT(cert-err33-c)
-    while (getchar() != '\n') {}
+    if (headless)
+    {
+        strcpy_s(buffer, maxLength, "Simulant");  // NOLINT(cert-err33-c)
+        return;
+    }
+    // The first word, as scanf's %s took
+    char line[INPUT_LINE_BYTES];
+    UI_ReadAnswer(line, sizeof(line));
+    const char* word = line + strspn(line, " \t");
+    size_t length = strcspn(word, " \t");
+    if (length >= static_cast<size_t>(maxLength)) length = maxLength - 1;
+    memcpy(buffer, word, length);
+    buffer[length] = '\0';
+}
+
+short UI::UI_GetNumberInput()
+{
+    if (headless)
+    {
+        return inputPolicy(inputContext, INPUT_NUMBER, -32768, 32767);
+    }
+    
+    char line[INPUT_LINE_BYTES];
+    short number = 0;
+    UI_ReadAnswer(line, sizeof(line));
+    while (!UI_ParseShort(line, &number))
+    {
+        printf("Invalid Input. Try Again: ");
+        UI_ReadAnswer(line, sizeof(line));
+    }
+    return number;
 }
 
 Direction UI::UI_GetDirectionInput()
 {
     printf("Direction: (1 = North, 2 = East, 3 = South, 4 = West): ");
+    if (headless)
+    {
+        short choice = inputPolicy(inputContext, INPUT_DIRECTION, 1, 4);
+        if (choice < 1 || choice > 4) choice = 1;
+        return static_cast<Direction>(choice - 1);
+    }
     unsigned short choice = UI_GetMenuInput(1, 4);
     return static_cast<Direction>(choice - 1);
 }
 
 bool UI::UI_ConfirmAction(const char* message)
 {
+    if (headless)
+    {
+        printf("%s (Y/N): ", message);
+        return inputPolicy(inputContext, INPUT_CONFIRM, 0, 1) != 0;
+    }
+    
     while (true)
     {
         printf("%s (Y/N): ", message);
@@ -155,27 +485,12 @@ void UI::UI_DisplayHealthBar(unsigned short int current, unsigned short int max)
     float percent = static_cast<float>(current) / static_cast<float>(max);
     unsigned short barLength = 20;
     unsigned short fillLength = static_cast<unsigned short>(barLength * percent);
-    printf("Health:[");
+    if (fillLength > barLength) fillLength = barLength;
+    const char* color = percent > 0.5f ? GREEN : percent > 0.25f ? YELLOW : RED;
     
-    for (unsigned short i = 0; i < fillLength; i++)
-    {
-        if (percent > 0.5f)
-        {
-            printf("%s%s%s", GREEN, "=", RESET);
-        }else if (percent > 0.25f)
-        {
-            printf("%s%s%s", YELLOW, "=", RESET);
-        }else
-        {
-            printf("%s%s%s", RED, "=", RESET);
-        }
-    }
-    
-    for (unsigned short i = fillLength; i < barLength; i++)
-    {
-        printf("-");
-    }
-    printf("]%hu/%hu (%.0f%%)\n", current, max, percent*100);
+    // One color run for the filled part rather than a color and reset around every cell
+    UI_Printf("Health:[%s%.*s%s%.*s]%hu/%hu (%.0f%%)\n", color, fillLength, barFill, RESET, barLength - fillLength, barEmpty,
+           current, max, percent*100);
 }
 
 void UI::UI_DisplayExperienceBar(unsigned short int current, unsigned short int max)
@@ -183,26 +498,30 @@ void UI::UI_DisplayExperienceBar(unsigned short int current, unsigned short int
     float percent = static_cast<float>(current) / static_cast<float>(max);
     unsigned short barLength = 20;
     unsigned short fillLength = static_cast<unsigned short>(barLength * percent);
-    printf("Experience:[");
-    for (unsigned short i = 0; i < fillLength; i++)
-    {
-        printf("%s%s%s", BLUE, "=", RESET);
-    }
-    for (unsigned short i = fillLength; i < barLength; i++)
-    {
-        printf("-");
-    }
-    printf("] %.0f%%\n", percent*100);
+    if (fillLength > barLength) fillLength = barLength;
+    UI_Printf("Experience:[%s%.*s%s%.*s] %.0f%%\n", BLUE, fillLength, barFill, RESET, barLength - fillLength, barEmpty, percent*100);
+}
+
+static void UI_LoadingBarTick(void* context, unsigned int tick)
+{
+    (void)context;
+    (void)tick;
+    printf("=");
+    UI::UI_PresentFrame();
 }
 
+// One cell every 50 ms; a key press fills the rest at once
 void UI::UI_DisplayLoadingBar()
 {
     printf("[");
-    for (unsigned short i = 0; i < 20; i++)
+    if (headless)
     {
-        printf("=");
-        fflush(stdout);
-        UI_TimedPause(50);
+        printf("%s", barFill);
+    }
+    else
+    {
+        UI_PresentFrame();
+        SchedulerWait(SchedulerAdd(50, 20, UI_LoadingBarTick, nullptr, SCHEDULER_SKIPPABLE));
     }
     printf("]100%%\n");
 }
@@ -275,12 +594,18 @@ void UI::UI_DisplayGameoverScreen(Player* player, GameStats* stats)
 void UI::UI_PauseScreen()
 {
     printf("\nPress ENTER to continue...");
-    getchar();
+    if (headless) return;
+    // Anything typed before ENTER goes with the pause rather than into the next prompt
+    char line[INPUT_LINE_BYTES];
+    UI_ReadLine(line, sizeof(line));
 }
 
-void UI::UI_TimedPause(unsigned short milliseconds)
+// A scheduled wait rather than a sleep: input and idle work carry on, and the time scale applies
+void UI::UI_TimedPause(unsigned short milliseconds, bool isSkippable)
 {
-    Sleep(milliseconds);
+    if (headless) return;
+    UI_PresentFrame();
+    SchedulerWait(SchedulerAdd(milliseconds, 1, nullptr, nullptr, isSkippable ? SCHEDULER_SKIPPABLE : 0));
 }
 
 //--------------------
@@ -289,28 +614,187 @@ void UI::UI_TimedPause(unsigned short milliseconds)
 
 void UI::UI_DisplaySuccessMessage(const char* message)
 {
-    printf("%s[SUCCESS]%s %s\n", GREEN, RESET, message);
+    UI_Printf("%s[SUCCESS]%s %s\n", GREEN, RESET, message);
 }
 
 void UI::UI_DisplayErrorMessage(const char* message)
 {
-    printf("%s[ERROR]%s %s\n", RED, RESET, message);
+    UI_Printf("%s[ERROR]%s %s\n", RED, RESET, message);
 }
 
 void UI::UI_DisplayWarningMessage(const char* message)
 {
-    printf("%s[WARNING]%s %s\n", YELLOW, RESET, message);
+    UI_Printf("%s[WARNING]%s %s\n", YELLOW, RESET, message);
 }
 
 void UI::UI_DisplayInfoMessage(const char* message)
 {
-    printf("%s[INFO]%s %s\n", CYAN, RESET, message);
+    UI_Printf("%s[INFO]%s %s\n", CYAN, RESET, message);
 }
 
+//--------------------
+// FRAME FUNCTIONS
+//--------------------
 
+// Everything printed collects in frameBuffer until UI_PresentFrame. Call before printing anything.
+void UI::UI_EnableFrameBuffer()
+{
+    setvbuf(stdout, frameBuffer, _IOFBF, UI_FRAME_BYTES);
+}
 
+// Writes out the frame composed so far in one call; every wait on the player presents first
+void UI::UI_PresentFrame()
+{
+    if (headless) return;
+    fflush(stdout);
+}
 
+//--------------------
+// RETAINED SCREEN FUNCTIONS
+//--------------------
 
+//
+// A screen redrawn every turn (combat) is composed with UI_Printf between UI_ScreenBegin and
+// UI_ScreenPresent. The present compares it cell by cell with the screen already on the terminal
+// and writes only what changed, then parks the cursor below it. That part of the terminal is made
+// a scroll region, so prompts and turn text printed there can never scroll the screen out of place.
+//
+// The first present, any present after UI_ClearScreen or UI_ScreenEnd, a change in the number of
+// rows, or a terminal too short for UI_SCREEN_LOG_ROWS below the screen, redraws it in full.
+//
+void UI::UI_ScreenBegin()
+{
+    if (headless) return;
+    // Cells past a row's width are always blank, so only the written ones need clearing
+    UIScreen* screen = &uiScreen.screens[uiScreen.front ^ 1];
+    for (short row = 0; row < screen->rows; row++)
+    {
+        memset(screen->cells[row], 0, screen->widths[row] * sizeof(UICell));
+        screen->widths[row] = 0;
+    }
+    screen->rows = 0;
+    uiScreen.composing = true;
+    uiScreen.row = 0;
+    uiScreen.col = 0;
+    uiScreen.attr = 0;
+}
+
+void UI::UI_ScreenPresent()
+{
+    if (!uiScreen.composing) return;
+    uiScreen.composing = false;
+    
+    const UIScreen* shown = &uiScreen.screens[uiScreen.front];
+    const UIScreen* screen = &uiScreen.screens[uiScreen.front ^ 1];
+    short terminalRows = UI_ScreenTerminalRows();
+    bool fits = terminalRows >= screen->rows + UI_SCREEN_LOG_ROWS;
+    bool canDiff = fits && uiScreen.isShown && terminalRows == uiScreen.shownTerminalRows && shown->rows == screen->rows;
+    
+    uiScreen.outputUsed = 0;
+    if (canDiff)
+    {
+        UI_ScreenDiff(shown, screen);
+    }
+    else
+    {
+        UI_ScreenRedraw(screen);
+    }
+    UI_ScreenSetAttr(0);
+    
+    // Setting the scroll region homes the cursor, so the park comes after it
+    if (fits)
+    {
+        char sequence[48];
+        int length = 0;
+        if (!canDiff)
+        {
+            length = sprintf_s(sequence, sizeof(sequence), "\x1b[%d;%dr", screen->rows + 1, terminalRows);
+        }
+        length += sprintf_s(sequence + length, sizeof(sequence) - length, "\x1b[%d;1H\x1b[J", screen->rows + 1);
+        UI_ScreenOut(sequence, static_cast<size_t>(length));
+    }
+    fwrite(uiScreen.output, 1, uiScreen.outputUsed, stdout);
+    
+    uiScreen.front ^= 1;
+    uiScreen.isShown = fits;
+    uiScreen.shownTerminalRows = terminalRows;
+}
 
+// Gives the whole terminal back to ordinary output, keeping the cursor where it is
+void UI::UI_ScreenEnd()
+{
+    uiScreen.composing = false;
+    if (!uiScreen.isShown) return;
+    uiScreen.isShown = false;
+    fputs("\x1b" "7\x1b[r\x1b" "8", stdout);
+}
 
+// For output the console cannot be asked about; 0 goes back to asking
+void UI::UI_ScreenSetTerminalRows(short rows)
+{
+    uiScreen.terminalRows = rows;
+}
 
+//--------------------
+// HEADLESS MODE FUNCTIONS
+//--------------------
+
+// Headless state is per thread so simulation workers can each drive their own game.
+void UI::UI_EnableHeadless(UI_InputPolicy policy, void* context)
+{
+    if (policy == nullptr)
+    {
+        printf("ERROR - UI_EnableHeadless: policy is null\n");
+        return;
+    }
+    headless = true;
+    inputPolicy = policy;
+    inputContext = context;
+}
+
+void UI::UI_DisableHeadless()
+{
+    headless = false;
+    inputPolicy = nullptr;
+    inputContext = nullptr;
+}
+
+bool UI::UI_IsHeadless()
+{
+    return headless;
+}
+
+bool UI::UI_RedirectOutputToNull()
+{
+    if (savedStdout != -1) return true;
+    
+    fflush(stdout);
+    savedStdout = _dup(_fileno(stdout));
+    if (savedStdout == -1)
+    {
+        return false;
+    }
+    
+    FILE* sink;
+    if (freopen_s(&sink, "NUL", "w", stdout) != 0)
+    {
+        _dup2(savedStdout, _fileno(stdout));
+        _close(savedStdout);
+        savedStdout = -1;
+        return false;
+    }
+    setvbuf(stdout, nullptr, _IOFBF, 1 << 16);
+    return true;
+}
+
+void UI::UI_RestoreOutput()
+{
+    if (savedStdout == -1) return;
+    
+    fflush(stdout);
+    _dup2(savedStdout, _fileno(stdout));
+    _close(savedStdout);
+    savedStdout = -1;
+    clearerr(stdout);
+    setvbuf(stdout, nullptr, _IONBF, 0);
+}
@@ -12,7 +12,51 @@
 #define CYAN "\x1b[36m"
 #define RESET "\x1b[0m"
 #define BOLD "\x1b[1m"
-#define CLEAR_SCREEN() system("cls")
+#define CLEAR_SCREEN() UI::UI_ClearScreen()
+#define UI_FRAME_BYTES (1 << 16) // Larger than any screen, so a frame goes out in one write
+#define UI_PRINTF_BYTES 1024 // Longest single UI_Printf while composing a retained screen
+#define UI_SCREEN_ROWS 60 // NOLINT(modernize-macro-to-enum)
+#define UI_SCREEN_COLS 120 // NOLINT(modernize-macro-to-enum)
+#define UI_SCREEN_LOG_ROWS 8 // Terminal rows a retained screen leaves below it; with fewer every frame is redrawn
+#define UI_SCREEN_MAX_SKIP 4 // Unchanged cells rewritten rather than jumped over, as a cursor move costs more
+#define UI_CELL_BOLD 0x10 // NOLINT(modernize-macro-to-enum)
+
+//--------------------
+// RETAINED SCREEN
+//--------------------
+
+// One character cell; a blank cell is all zero
+typedef struct UICell
+{
+    char glyph[4]; // UTF-8 bytes, one character
+    unsigned char length;
+    unsigned char attr; // Foreground in the low bits (0 default, 1-8 for SGR 30-37) and UI_CELL_BOLD
+}UICell;
+
+// A screen as the terminal shows it. Text past UI_SCREEN_COLS or UI_SCREEN_ROWS is clipped.
+typedef struct UIScreen
+{
+    UICell cells[UI_SCREEN_ROWS][UI_SCREEN_COLS];
+    short widths[UI_SCREEN_ROWS]; // Cells written per row
+    short rows;
+}UIScreen;
+
+//--------------------
+// HEADLESS INPUT
+//--------------------
+
+typedef enum
+{
+    INPUT_MENU = 0,
+    INPUT_CHAR = 1,
+    INPUT_NUMBER = 2,
+    INPUT_DIRECTION = 3,
+    INPUT_CONFIRM = 4,
+    
+}InputKind;
+
+// Answers a prompt on behalf of the player when running headless.
+typedef short (*UI_InputPolicy)(void* context, InputKind kind, short minChoice, short maxChoice);
 
 class UI
 {
@@ -21,11 +65,13 @@ public:
     // PRINTING FUNCTIONS
     //--------------------
     
+    static void UI_Printf(const char* format, ...);
     static void UI_PrintHeader(const char* title);
     static void UI_PrintDivider();
     static void UI_PrintSection(const char* name);
     static void UI_PrintColored(const char* text, const char* color, bool newLine = false);
     static void UI_PrintCentered(const char* text);
+    static void UI_ClearScreen();
     
     //--------------------
     // INPUT HANDLING FUNCTIONS
@@ -34,6 +80,7 @@ public:
     static unsigned short UI_GetMenuInput(short int minChoice, short int maxChoice);
     static char UI_GetCharInput();
     static void UI_GetStringInput(const char* prompt, char* buffer, int maxLength);
+    static short UI_GetNumberInput();
     static Direction UI_GetDirectionInput();
     static bool UI_ConfirmAction(const char* message);
     
@@ -59,7 +106,7 @@ public:
     //--------------------
     
     static void UI_PauseScreen();
-    static void UI_TimedPause(unsigned short milliseconds);
+    static void UI_TimedPause(unsigned short milliseconds, bool isSkippable = true);
     
     //--------------------
     // MESSAGE DISPLAY FUNCTIONS
@@ -69,5 +116,38 @@ public:
     static void UI_DisplayErrorMessage(const char* message);
     static void UI_DisplayWarningMessage(const char* message);
     static void UI_DisplayInfoMessage(const char* message);
+    
+    //--------------------
+    // FRAME FUNCTIONS
+    //--------------------
+    
+    static void UI_EnableFrameBuffer();
+    static void UI_PresentFrame();
+    
+    //--------------------
+    // RETAINED SCREEN FUNCTIONS
+    //--------------------
+    
+    static void UI_ScreenBegin();
+    static void UI_ScreenPresent();
+    static void UI_ScreenEnd();
+    static void UI_ScreenSetTerminalRows(short rows);
+    
+    //--------------------
+    // HEADLESS MODE FUNCTIONS
+    //--------------------
+    
+    static void UI_EnableHeadless(UI_InputPolicy policy, void* context);
+    static void UI_DisableHeadless();
+    static bool UI_IsHeadless();
+    static bool UI_RedirectOutputToNull();
+    static void UI_RestoreOutput();
+
+private:
+    static thread_local bool headless;
+    static thread_local UI_InputPolicy inputPolicy;
+    static thread_local void* inputContext;
+    static int savedStdout;
+    static char frameBuffer[UI_FRAME_BYTES];
 
 };